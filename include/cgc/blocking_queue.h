@@ -0,0 +1,260 @@
+/**
+ * \file blocking_queue.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_BLOCKING_QUEUE_H_
+#define _CGC_BLOCKING_QUEUE_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <sysexits.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+#include "cgc/queue.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \class cgc_blocking_queue
+ * \ingroup queues_group
+ * \brief CGC Blocking queue.
+ *
+ * CGC Blocking queues are bounded #cgc_queue protected by a mutex, which
+ * threads can wait on: producers wait while the queue is full, and consumers
+ * wait while it is empty. Waiting threads sleep on condition variables
+ * instead of polling.
+ *
+ * ## Timeouts
+ * The functions which may wait take a timeout in milliseconds. A negative
+ * timeout waits forever, and a null timeout does not wait at all. When the
+ * timeout expires, they fail with \c errno set to \c ETIMEDOUT.
+ *
+ * ## Batches
+ * cgc_blocking_queue_pop_batch() waits for at least one element, then pops
+ * as many elements as possible, up to a maximum, while holding the lock only
+ * once.
+ *
+ * ## Closing
+ * cgc_blocking_queue_close() wakes all the waiting threads up. Pushing into a
+ * closed queue fails with \c errno set to \c EPIPE. The elements left can
+ * still be popped; popping from a closed and empty queue fails with \c errno
+ * set to \c EPIPE instead of waiting.
+ *
+ * \sa cgc_queue
+ */
+typedef struct cgc_blocking_queue
+{
+    pthread_mutex_t _mutex;         /**<- Mutex. */
+    pthread_cond_t _not_empty;      /**<- Signaled when an element is pushed. */
+    pthread_cond_t _not_full;       /**<- Signaled when an element is popped. */
+    cgc_queue _queue;               /**<- Elements. */
+    size_t _capacity;               /**<- Maximal number of elements. */
+    bool _closed;                   /**<- Whether the queue is closed. */
+} cgc_blocking_queue;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_blocking_queue.
+ * \param element_size Element size.
+ * \param copy_fun Copy function.
+ * \param clean_fun Cleaning function.
+ * \param capacity Maximal number of elements.
+ * \relatesalso cgc_blocking_queue
+ * \return The pointer to the new cgc_blocking_queue in case of success. \c NULL
+ * in case of failure.
+ * \retval NULL if the queue could not be allocated.
+ * \note Queues obtained this way must be freed using
+ * cgc_blocking_queue_destroy().
+ * \note In case of failure, \c errno may be set to \c ENOMEM.
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_blocking_queue * cgc_blocking_queue_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity);
+
+/**
+ * \brief Free a dynamically allocated cgc_blocking_queue.
+ * \param queue Queue.
+ * \relatesalso cgc_blocking_queue
+ * \note A call to this function may change the value of \c errno.
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only of queues obtained
+ * via cgc_blocking_queue_create().
+ */
+void cgc_blocking_queue_destroy (cgc_blocking_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_blocking_queue.
+ * \param[in,out] queue Queue.
+ * \param[in] element_size Element size
+ * \param[in] copy_fun Copy function.
+ * \param[in] clean_fun Cleaning function.
+ * \param[in] capacity Maximal number of elements.
+ * \relatesalso cgc_blocking_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL or if \c capacity is 0. \c errno
+ * shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of malloc, or if the mutex or the
+ * condition variables could not be initialized.
+ */
+int cgc_blocking_queue_init (cgc_blocking_queue * queue, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity);
+
+/**
+ * \brief Clean a cgc_blocking_queue.
+ * \param[in,out] queue Queue.
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \relatesalso cgc_blocking_queue
+ * \warning No thread may be waiting on the queue.
+ */
+int cgc_blocking_queue_clean (cgc_blocking_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a CGC blocking queue is empty.
+ * \param queue Queue.
+ * \retval true if the queue is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_blocking_queue
+ * \note The result may be outdated as soon as it is returned.
+ */
+bool cgc_blocking_queue_is_empty (cgc_blocking_queue * queue);
+
+/**
+ * \brief Get the size of the queue.
+ * \param queue Queue.
+ * \return size.
+ * \relatesalso cgc_blocking_queue
+ * \note The result may be outdated as soon as it is returned.
+ */
+size_t cgc_blocking_queue_size (cgc_blocking_queue * queue);
+
+/**
+ * \brief Check whether a CGC blocking queue is closed.
+ * \param queue Queue.
+ * \retval true if the queue is closed.
+ * \retval false otherwise.
+ * \relatesalso cgc_blocking_queue
+ */
+bool cgc_blocking_queue_is_closed (cgc_blocking_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Push to the back, waiting while the queue is full.
+ * \param[in,out] queue Queue
+ * \param[in] element Element.
+ * \param[in] timeout Timeout in milliseconds. Negative to wait forever.
+ * \relatesalso cgc_blocking_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL, if the timeout expired, or if
+ * the queue is closed. \c errno shall be set to \c EINVAL, \c ETIMEDOUT or
+ * \c EPIPE respectively.
+ * \retval <=-3 if the copy function failed.
+ * \note The supplied element will be copied into the queue. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_blocking_queue_push (cgc_blocking_queue * queue, const void * element, long timeout);
+
+/**
+ * \brief Pop the front into a buffer, waiting while the queue is empty.
+ * \param[in,out] queue Queue.
+ * \param[out] destination Buffer of at least the size of an element.
+ * \param[in] timeout Timeout in milliseconds. Negative to wait forever.
+ * \relatesalso cgc_blocking_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, if the timeout expired, or if
+ * the queue is closed and empty. \c errno shall be set to \c EINVAL,
+ * \c ETIMEDOUT or \c EPIPE respectively.
+ * \note The element is moved: it is up to the user to clean
+ * \c destination once unneeded.
+ */
+int cgc_blocking_queue_pop_into (cgc_blocking_queue * queue, void * destination, long timeout);
+
+/**
+ * \brief Pop several elements from the front.
+ * \param[in,out] queue Queue.
+ * \param[out] destination Buffer of at least \c max elements.
+ * \param[in] max Maximal number of elements.
+ * \param[in] timeout Timeout in milliseconds to wait for the first element.
+ * Negative to wait forever.
+ * \relatesalso cgc_blocking_queue
+ * \return The number of popped elements. 0 in case of failure, in which case
+ * \c errno shall be set to \c EINVAL if one of the arguments is \c NULL or
+ * \c max is 0, \c ETIMEDOUT if the timeout expired, and \c EPIPE if the queue
+ * is closed and empty.
+ * \note The elements are moved: it is up to the user to clean them once
+ * unneeded.
+ */
+size_t cgc_blocking_queue_pop_batch (cgc_blocking_queue * queue, void * destination, size_t max, long timeout);
+
+/**
+ * \brief Close a queue.
+ * \param[in,out] queue Queue.
+ * \relatesalso cgc_blocking_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ */
+int cgc_blocking_queue_close (cgc_blocking_queue * queue);
+
+/**
+ * \brief Clear a queue.
+ * \param[in,out] queue Queue.
+ * \relatesalso cgc_blocking_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ */
+int cgc_blocking_queue_clear (cgc_blocking_queue * queue);
+
+#endif /* _CGC_BLOCKING_QUEUE_H_ */
@@ -29,7 +29,20 @@
 #include "cgc/types.h"
 #include "cgc/list.h"
 #include "cgc/queue.h"
+#include "cgc/spsc_queue.h"
+#include "cgc/mpmc_queue.h"
+#include "cgc/blocking_queue.h"
+#include "cgc/priority_queue.h"
+#include "cgc/indexed_heap.h"
+#include "cgc/timer_wheel.h"
+#include "cgc/radix_tree.h"
 #include "cgc/stack.h"
+#include "cgc/concurrent_stack.h"
+#include "cgc/unrolled_list.h"
+#include "cgc/skip_list.h"
+#include "cgc/compact_list.h"
+#include "cgc/work_deque.h"
+#include "cgc/scheduler.h"
 #include "cgc/vector.h"
 #include "cgc/version.h"
 
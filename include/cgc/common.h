@@ -48,4 +48,24 @@ static inline int cgc_check_pointer (const void * const pointer)
     return error;
 }
 
+/**
+ * \brief Assumed size in bytes of a cache line.
+ * Data written concurrently by different threads is kept this far apart to
+ * avoid false sharing.
+ */
+#define CGC_CACHE_LINE_SIZE 64
+
+/**
+ * \brief Hint that the memory at \c address will soon be read.
+ * \param address Address.
+ * Used by linked containers to fetch the next node while the current one is
+ * being processed. This expands to nothing on compilers without
+ * \c __builtin_prefetch.
+ */
+#if defined (__GNUC__)
+#   define CGC_PREFETCH(address) __builtin_prefetch (address)
+#else
+#   define CGC_PREFETCH(address) ((void) (address))
+#endif
+
 #endif /* _CGC_COMMON_H_ */
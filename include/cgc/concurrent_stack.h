@@ -0,0 +1,301 @@
+/**
+ * \file concurrent_stack.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_CONCURRENT_STACK_H_
+#define _CGC_CONCURRENT_STACK_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <sysexits.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \class cgc_concurrent_stack
+ * \ingroup stacks_group
+ * \brief CGC Concurrent stack.
+ *
+ * CGC Concurrent stacks are bounded stacks which can be shared by any number
+ * of threads without locks (Treiber stacks).
+ *
+ * The elements are stored in a fixed pool of nodes, allocated at
+ * initialization. Nodes are linked by their index in the pool, and are never
+ * freed while the stack is in use: unused nodes are kept in a second
+ * Treiber stack, the free list. The head of each stack packs the index of the
+ * top node with a tag incremented on each change, so that a compare-and-swap
+ * fails if the head was popped and pushed back meanwhile (ABA problem).
+ *
+ * ## Magazines
+ * Even without locks, all threads contend on the same heads. A
+ * #cgc_concurrent_stack_magazine is a per-thread cache of nodes: pushes and
+ * pops go to the magazine, which only exchanges whole chains of nodes with
+ * the shared stacks, in a single compare-and-swap, when it is full or empty.
+ * Elements held by a magazine are not visible to the other threads until
+ * cgc_concurrent_stack_magazine_flush() is called. The stack is thus no
+ * longer strictly LIFO across threads, which suits free lists and pools.
+ *
+ * ## Threads
+ * Only the push and pop functions, cgc_concurrent_stack_is_empty() and the
+ * functions of magazines may be called concurrently. The other functions
+ * require exclusive access. A magazine must only be used by one thread.
+ */
+typedef struct cgc_concurrent_stack
+{
+    _Alignas (CGC_CACHE_LINE_SIZE) atomic_uint_least64_t _top;  /**<- Tagged index of the top node. */
+    _Alignas (CGC_CACHE_LINE_SIZE) atomic_uint_least64_t _free; /**<- Tagged index of the first free node. */
+    _Alignas (CGC_CACHE_LINE_SIZE) char * _nodes;               /**<- Node pool. */
+    uint32_t _capacity;                                         /**<- Number of nodes. */
+    size_t _node_size;                                          /**<- Size of a node. */
+    size_t _content_offset;                                     /**<- Offset of the content in a node. */
+    size_t _element_size;                                       /**<- Element size. */
+    cgc_copy_function _copy_fun;                                /**<- Copy function. */
+    cgc_clean_function _clean_fun;                              /**<- Clean function. */
+} cgc_concurrent_stack;
+
+/**
+ * \class cgc_concurrent_stack_magazine
+ * \ingroup stacks_group
+ * \brief Per-thread cache of a CGC Concurrent stack.
+ *
+ * A magazine holds two private chains of nodes: loaded nodes, which hold
+ * elements, and empty nodes. When a chain exceeds the capacity of the
+ * magazine, half of it is given back to the shared stack; when a chain is
+ * needed but empty, up to half the capacity is taken from the shared stack.
+ *
+ * \sa cgc_concurrent_stack
+ */
+typedef struct cgc_concurrent_stack_magazine
+{
+    cgc_concurrent_stack * _stack;  /**<- Shared stack. */
+    uint32_t _loaded;               /**<- First loaded node. */
+    uint32_t _loaded_count;         /**<- Number of loaded nodes. */
+    uint32_t _empty;                /**<- First empty node. */
+    uint32_t _empty_count;          /**<- Number of empty nodes. */
+    uint32_t _capacity;             /**<- Maximal number of nodes of a chain. */
+} cgc_concurrent_stack_magazine;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_concurrent_stack.
+ * \param element_size Element size.
+ * \param copy_fun Copy function.
+ * \param clean_fun Cleaning function.
+ * \param capacity Maximal number of elements.
+ * \relatesalso cgc_concurrent_stack
+ * \return The pointer to the new cgc_concurrent_stack in case of success.
+ * \c NULL in case of failure.
+ * \retval NULL if the stack could not be allocated.
+ * \note Stacks obtained this way must be freed using
+ * cgc_concurrent_stack_destroy().
+ * \note In case of failure, \c errno may be set to \c ENOMEM.
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_concurrent_stack * cgc_concurrent_stack_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity);
+
+/**
+ * \brief Free a dynamically allocated cgc_concurrent_stack.
+ * \param stack Stack.
+ * \relatesalso cgc_concurrent_stack
+ * \note A call to this function may change the value of \c errno.
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only of stacks obtained
+ * via cgc_concurrent_stack_create().
+ */
+void cgc_concurrent_stack_destroy (cgc_concurrent_stack * stack);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_concurrent_stack.
+ * \param[in,out] stack Stack.
+ * \param[in] element_size Element size
+ * \param[in] copy_fun Copy function.
+ * \param[in] clean_fun Cleaning function.
+ * \param[in] capacity Maximal number of elements.
+ * \relatesalso cgc_concurrent_stack
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, or if \c capacity is 0 or does
+ * not fit in 32 bits. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of malloc. \c errno may be set to
+ * \c ENOMEM.
+ */
+int cgc_concurrent_stack_init (cgc_concurrent_stack * stack, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity);
+
+/**
+ * \brief Clean a cgc_concurrent_stack.
+ * \param[in,out] stack Stack.
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \relatesalso cgc_concurrent_stack
+ * \warning All magazines must have been flushed beforehand.
+ */
+int cgc_concurrent_stack_clean (cgc_concurrent_stack * stack);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a CGC concurrent stack is empty.
+ * \param stack Stack.
+ * \retval true if the stack is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_concurrent_stack
+ * \note The result may be outdated as soon as it is returned.
+ * \note Elements held by magazines are not taken into account.
+ */
+bool cgc_concurrent_stack_is_empty (const cgc_concurrent_stack * stack);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Push to the top.
+ * \param[in,out] stack Stack
+ * \param[in] element Element.
+ * \relatesalso cgc_concurrent_stack
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL, or if the stack is full. \c
+ * errno shall be set to \c EINVAL or \c EAGAIN respectively.
+ * \retval <=-3 if the copy function failed.
+ * \note The supplied element will be copied into the stack. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_concurrent_stack_push (cgc_concurrent_stack * stack, const void * element);
+
+/**
+ * \brief Pop the top into a buffer.
+ * \param[in,out] stack Stack.
+ * \param[out] destination Buffer of at least the size of an element.
+ * \relatesalso cgc_concurrent_stack
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, or if the stack is empty.
+ * \c errno shall be set to \c EINVAL or \c EAGAIN respectively.
+ * \note The element is moved: it is up to the user to clean
+ * \c destination once unneeded.
+ */
+int cgc_concurrent_stack_pop_into (cgc_concurrent_stack * stack, void * destination);
+
+/**
+ * \brief Clear a stack.
+ * \param[in,out] stack Stack.
+ * \relatesalso cgc_concurrent_stack
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \warning No other thread may use the stack meanwhile.
+ */
+int cgc_concurrent_stack_clear (cgc_concurrent_stack * stack);
+
+////////////////////////////////////////////////////////////////////////////////
+// Magazines.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a magazine.
+ * \param[in,out] magazine Magazine.
+ * \param[in] stack Shared stack.
+ * \param[in] capacity Maximal number of nodes of each chain of the magazine.
+ * \relatesalso cgc_concurrent_stack_magazine
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, or if \c capacity is less
+ * than 2 or does not fit in 32 bits. \c errno shall be set to \c EINVAL.
+ */
+int cgc_concurrent_stack_magazine_init (cgc_concurrent_stack_magazine * magazine, cgc_concurrent_stack * stack, size_t capacity);
+
+/**
+ * \brief Give all the nodes of a magazine back to the shared stack.
+ * \param[in,out] magazine Magazine.
+ * \relatesalso cgc_concurrent_stack_magazine
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \note The loaded nodes are pushed on the shared stack, so their elements
+ * become visible to the other threads.
+ */
+int cgc_concurrent_stack_magazine_flush (cgc_concurrent_stack_magazine * magazine);
+
+/**
+ * \brief Push through a magazine.
+ * \param[in,out] magazine Magazine.
+ * \param[in] element Element.
+ * \relatesalso cgc_concurrent_stack_magazine
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL, or if no node is left. \c
+ * errno shall be set to \c EINVAL or \c EAGAIN respectively.
+ * \retval <=-3 if the copy function failed.
+ * \note The supplied element will be copied into the magazine. It is safe to
+ * free \c element afterwards.
+ */
+int cgc_concurrent_stack_magazine_push (cgc_concurrent_stack_magazine * magazine, const void * element);
+
+/**
+ * \brief Pop through a magazine.
+ * \param[in,out] magazine Magazine.
+ * \param[out] destination Buffer of at least the size of an element.
+ * \relatesalso cgc_concurrent_stack_magazine
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, or if neither the magazine nor
+ * the shared stack hold any element. \c errno shall be set to \c EINVAL or
+ * \c EAGAIN respectively.
+ * \note The element is moved: it is up to the user to clean
+ * \c destination once unneeded.
+ */
+int cgc_concurrent_stack_magazine_pop_into (cgc_concurrent_stack_magazine * magazine, void * destination);
+
+#endif /* _CGC_CONCURRENT_STACK_H_ */
@@ -0,0 +1,287 @@
+/**
+ * \file indexed_heap.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_INDEXED_HEAP_H_
+#define _CGC_INDEXED_HEAP_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \class cgc_indexed_heap
+ * \ingroup priority_queues_group
+ * \brief CGC Indexed heap.
+ *
+ * CGC Indexed heaps are d-ary min-heaps of keys, each key being attached to an
+ * external integer id (typically a vertex of a graph). The heap knows where
+ * every id lies, so that the key of an id can be changed in place instead of
+ * pushing a duplicate: this is the decrease-key operation needed by Dijkstra's
+ * or Prim's algorithms.
+ *
+ * Operation                           | Complexity
+ * ------------------------------------|---------------
+ * cgc_indexed_heap_push()             | O(log n / log d)
+ * cgc_indexed_heap_pop()              | O(d log n / log d)
+ * cgc_indexed_heap_decrease_key()     | O(log n / log d)
+ * cgc_indexed_heap_increase_key()     | O(d log n / log d)
+ * cgc_indexed_heap_contains()         | O(1)
+ *
+ * ## Ids
+ * Ids are indices: the heap keeps an array mapping each id to its position,
+ * and grows it to cover the largest id ever pushed. Ids should therefore be
+ * dense, e.g. vertex numbers. cgc_indexed_heap_reserve() allocates the map
+ * and the heap storage at once when the number of ids is known beforehand.
+ *
+ * ## Memory layout
+ * Each heap slot holds a key followed by its id, so that the children of a
+ * node lie side by side and comparing them touches contiguous memory. The
+ * arity defaults to 4: a wider node means a shallower heap and fewer cache
+ * misses when sifting down, at the cost of more comparisons per level.
+ *
+ * ## Keys
+ * Keys are compared with a #cgc_compare_function and moved with \c memcpy.
+ * They shall therefore not own any dynamically allocated memory.
+ */
+typedef struct cgc_indexed_heap
+{
+    char * _slots;                      /**<- Heap slots. */
+    size_t * _positions;                /**<- Position of each id. */
+    void * _hole;                       /**<- Room for one slot. */
+    size_t _size;                       /**<- Number of ids in the heap. */
+    size_t _capacity;                   /**<- Number of allocated slots. */
+    size_t _id_count;                   /**<- Number of mapped ids. */
+    size_t _arity;                      /**<- Number of children per node. */
+    size_t _key_size;                   /**<- Key size. */
+    size_t _id_offset;                  /**<- Offset of the id in a slot. */
+    size_t _slot_size;                  /**<- Slot size. */
+    cgc_compare_function _compare_fun;  /**<- Comparison function. */
+} cgc_indexed_heap;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_indexed_heap.
+ * \param key_size Key size.
+ * \param compare_fun Comparison function.
+ * \param arity Number of children per node, 0 for the default of 4.
+ * \relatesalso cgc_indexed_heap
+ * \return The pointer to the new cgc_indexed_heap in case of success.
+ * \retval NULL if the heap could not be allocated or if the arguments are
+ * invalid.
+ * \note Heaps obtained this way must be freed using cgc_indexed_heap_destroy().
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_indexed_heap * cgc_indexed_heap_create (size_t key_size, cgc_compare_function compare_fun, size_t arity);
+
+/**
+ * \brief Free a dynamically allocated cgc_indexed_heap.
+ * \param heap Heap.
+ * \relatesalso cgc_indexed_heap
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only on heaps obtained
+ * via cgc_indexed_heap_create().
+ */
+void cgc_indexed_heap_destroy (cgc_indexed_heap * heap);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_indexed_heap.
+ * \param[in,out] heap Heap.
+ * \param[in] key_size Key size.
+ * \param[in] compare_fun Comparison function.
+ * \param[in] arity Number of children per node, 0 for the default of 4.
+ * \relatesalso cgc_indexed_heap
+ * \retval 0 in case of success.
+ * \retval -1 if \c heap or \c compare_fun is \c NULL, if \c key_size is 0 or if
+ * \c arity is 1. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
+ */
+int cgc_indexed_heap_init (cgc_indexed_heap * heap, size_t key_size, cgc_compare_function compare_fun, size_t arity);
+
+/**
+ * \brief Clean a cgc_indexed_heap.
+ * \param[in,out] heap Heap.
+ * \relatesalso cgc_indexed_heap
+ * \retval 0 in case of success.
+ * \retval -1 if \c heap is \c NULL. \c errno shall be set to \c EINVAL.
+ */
+int cgc_indexed_heap_clean (cgc_indexed_heap * heap);
+
+/**
+ * \brief Make room for the ids from 0 to \c id_count - 1.
+ * \param[in,out] heap Heap.
+ * \param[in] id_count Number of ids.
+ * \relatesalso cgc_indexed_heap
+ * \retval 0 in case of success.
+ * \retval -1 if \c heap is \c NULL. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of \c realloc.
+ * \note Both the id map and the heap storage are grown, so that no allocation
+ * occurs afterwards as long as the ids stay below \c id_count.
+ */
+int cgc_indexed_heap_reserve (cgc_indexed_heap * heap, size_t id_count);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a cgc_indexed_heap is empty.
+ * \param heap Heap.
+ * \retval true if the heap is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_indexed_heap
+ * \pre \c heap != \c NULL.
+ */
+bool cgc_indexed_heap_is_empty (const cgc_indexed_heap * heap);
+
+/**
+ * \brief Get the size of a cgc_indexed_heap.
+ * \param heap Heap.
+ * \return Number of ids in the heap.
+ * \relatesalso cgc_indexed_heap
+ * \pre \c heap != \c NULL.
+ */
+size_t cgc_indexed_heap_size (const cgc_indexed_heap * heap);
+
+/**
+ * \brief Check whether an id is in a cgc_indexed_heap.
+ * \param heap Heap.
+ * \param id Id.
+ * \retval true if \c id is in the heap.
+ * \retval false otherwise.
+ * \relatesalso cgc_indexed_heap
+ * \pre \c heap != \c NULL.
+ */
+bool cgc_indexed_heap_contains (const cgc_indexed_heap * heap, size_t id);
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the id with the lowest key.
+ * \param heap Heap.
+ * \return Id at the top of the heap.
+ * \relatesalso cgc_indexed_heap
+ * \pre \c heap != \c NULL.
+ * \pre cgc_indexed_heap_is_empty (heap) == false.
+ */
+size_t cgc_indexed_heap_top (const cgc_indexed_heap * heap);
+
+/**
+ * \brief Get the key of an id.
+ * \param heap Heap.
+ * \param id Id.
+ * \return A pointer to the key of \c id.
+ * \relatesalso cgc_indexed_heap
+ * \pre \c heap != \c NULL.
+ * \pre cgc_indexed_heap_contains (heap, id) == true.
+ * \warning The key shall not be modified directly: use
+ * cgc_indexed_heap_decrease_key() or cgc_indexed_heap_increase_key().
+ */
+const void * cgc_indexed_heap_key (const cgc_indexed_heap * heap, size_t id);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Push an id with its key.
+ * \param[in,out] heap Heap.
+ * \param[in] id Id.
+ * \param[in] key Key.
+ * \relatesalso cgc_indexed_heap
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, or if \c id already is in the
+ * heap. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of \c realloc.
+ */
+int cgc_indexed_heap_push (cgc_indexed_heap * heap, size_t id, const void * key);
+
+/**
+ * \brief Pop the id with the lowest key.
+ * \param[in,out] heap Heap.
+ * \param[out] id Id, may be \c NULL.
+ * \param[out] key Room for the key, may be \c NULL.
+ * \relatesalso cgc_indexed_heap
+ * \retval 0 in case of success.
+ * \retval -1 if \c heap is \c NULL or empty. \c errno shall be set to
+ * \c EINVAL.
+ */
+int cgc_indexed_heap_pop (cgc_indexed_heap * heap, size_t * id, void * key);
+
+/**
+ * \brief Lower the key of an id.
+ * \param[in,out] heap Heap.
+ * \param[in] id Id.
+ * \param[in] key New key.
+ * \relatesalso cgc_indexed_heap
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, if \c id is not in the heap,
+ * or if \c key is greater than the current key. \c errno shall be set to
+ * \c EINVAL.
+ */
+int cgc_indexed_heap_decrease_key (cgc_indexed_heap * heap, size_t id, const void * key);
+
+/**
+ * \brief Raise the key of an id.
+ * \param[in,out] heap Heap.
+ * \param[in] id Id.
+ * \param[in] key New key.
+ * \relatesalso cgc_indexed_heap
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, if \c id is not in the heap,
+ * or if \c key is lower than the current key. \c errno shall be set to
+ * \c EINVAL.
+ */
+int cgc_indexed_heap_increase_key (cgc_indexed_heap * heap, size_t id, const void * key);
+
+/**
+ * \brief Remove every id from a cgc_indexed_heap.
+ * \param[in,out] heap Heap.
+ * \relatesalso cgc_indexed_heap
+ * \retval 0 in case of success.
+ * \retval -1 if \c heap is \c NULL. \c errno shall be set to \c EINVAL.
+ * \note This takes O(size) time, not O(number of ids): the heap may be reused
+ * for the next query without touching the whole id map.
+ */
+int cgc_indexed_heap_clear (cgc_indexed_heap * heap);
+
+#endif /* _CGC_INDEXED_HEAP_H_ */
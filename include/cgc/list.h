@@ -27,6 +27,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <errno.h>
 #include <sysexits.h>
 #include <string.h>
@@ -57,9 +59,10 @@
  */
 typedef struct cgc_list_element
 {
-    void * _content;    /**< Content. */
-    void * _next;       /**< Next element. */
-    void * _previous;   /**< Previous element. */
+    void * _content;                /**< Content. */
+    void * _next;                   /**< Next element. */
+    void * _previous;               /**< Previous element. */
+    struct cgc_list_block * _block; /**< Block holding the element and its content, \c NULL if allocated on their own. */
 } cgc_list_element;
 
 /**
@@ -297,6 +300,35 @@ typedef struct cgc_list_element
  * On the other hand, cgc_list_erase() and cgc_list_clear() do free the
  * deleted elements.
  *
+ * ## Cursors
+ * Insertions and deletions at a given index require walking the list up to
+ * the index. When editing a list while scanning it, use a #cgc_list_cursor
+ * along with cgc_list_insert_before(), cgc_list_insert_after() and
+ * cgc_list_erase_at(), which operate in constant time.
+ *
+ * ## Moving elements between lists
+ * The following functions relink the elements of a list into another one,
+ * without copying or reallocating them.
+ *
+ * Function               | Moved elements
+ * -----------------------|-------------------------------------------
+ * cgc_list_concat()      | All elements, at the end of another list
+ * cgc_list_splice()      | All elements, before the Nth element
+ * cgc_list_splice_at()   | All elements, before a cursor
+ * cgc_list_split_at()    | Elements from the Nth one, into a new list
+ *
+ * ## Sorting
+ * cgc_list_sort() sorts a list in place with a stable merge sort, and
+ * cgc_list_merge() merges two sorted lists. Both expect a
+ * #cgc_compare_function, and only relink the elements.
+ *
+ * ## Memory layout
+ * After many insertions and deletions, consecutive elements may lie far
+ * apart in memory, which makes traversals slow. cgc_list_compact() moves all
+ * the elements of a list, in list order, into a single block. Such elements
+ * may still be erased or moved to other lists: the block is freed along with
+ * the last of them.
+ *
  * # Operations on lists
  * Those familiar with functionnal programming will probably be happy to know
  * that the \c map and \c fold functions are available. However, do not expect
@@ -340,6 +372,40 @@ typedef struct cgc_list
     size_t _element_size;               /**< Element size. */
 } cgc_list;
 
+/**
+ * \brief CGC List cursor.
+ * \ingroup cgc_list_group
+ *
+ * Cursors designate a position inside a cgc_list: either an element of the
+ * list, or the position past the last element (in which case the cursor is
+ * not valid, see cgc_list_cursor_is_valid()).
+ *
+ * Contrary to the index based functions, which walk the list from its first
+ * element, the cursor functions operate in constant time. Editing a list
+ * while scanning it can thus be done in a single pass:
+ *
+ *     cgc_list_cursor cursor = cgc_list_cursor_first (list);
+ *     while (cgc_list_cursor_is_valid (& cursor))
+ *     {
+ *         if (must_be_removed (cgc_list_cursor_get (& cursor)))
+ *             // Moves the cursor to the next element.
+ *             cgc_list_erase_at (& cursor);
+ *         else
+ *             cgc_list_cursor_next (& cursor);
+ *     }
+ *
+ * Moving forward from the past-the-end position leads to the first element,
+ * and moving backward from it leads to the last element.
+ *
+ * \warning A cursor pointing to an element which is removed from the list
+ * (other than through the cursor itself) must not be used anymore.
+ */
+typedef struct cgc_list_cursor
+{
+    cgc_list * _list;               /**< List. */
+    cgc_list_element * _element;    /**< Current element, \c NULL past the end. */
+} cgc_list_cursor;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Dynamic creation and destruction.
 ////////////////////////////////////////////////////////////////////////////////
@@ -550,6 +616,8 @@ int cgc_list_push_back (cgc_list * list, const void * element);
  * \brief Pop the front.
  * \param[in,out] list List.
  * \return First element.
+ * \retval NULL if the element was moved by cgc_list_compact() and could not
+ * be copied out of its block. The list is left untouched.
  * \relatesalso cgc_list
  * \warning It is up to the user to free the returned element once unneeded.
  * \pre list != NULL
@@ -561,6 +629,8 @@ void * cgc_list_pop_front (cgc_list * list);
  * \brief Pop the back.
  * \param[in,out] list List.
  * \return Last element.
+ * \retval NULL if the element was moved by cgc_list_compact() and could not
+ * be copied out of its block. The list is left untouched.
  * \relatesalso cgc_list
  * \warning It is up to the user to free the returned element once unneeded.
  * \pre list != NULL
@@ -654,4 +724,253 @@ void cgc_list_fold_left (const cgc_list * list, cgc_binary_op_left_function op_f
  */
 void cgc_list_fold_right (const cgc_list * list, cgc_binary_op_right_function op_fun, void * base_result);
 
+////////////////////////////////////////////////////////////////////////////////
+// Splicing.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Move all the elements of a list at the end of another list.
+ * \param[in,out] list Destination list.
+ * \param[in,out] other Source list.
+ * \relatesalso cgc_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, if both arguments are the
+ * same list, or if the lists do not hold elements of the same size. \c errno
+ * shall be set to \c EINVAL.
+ * \note The elements are relinked, not copied: this function operates in
+ * constant time. \c other is empty afterwards.
+ */
+int cgc_list_concat (cgc_list * list, cgc_list * other);
+
+/**
+ * \brief Move all the elements of a list before the Ith element of another
+ * list.
+ * \param[in,out] list Destination list.
+ * \param[in] i Target index.
+ * \param[in,out] other Source list.
+ * \relatesalso cgc_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, if both arguments are the
+ * same list, or if the lists do not hold elements of the same size. \c errno
+ * shall be set to \c EINVAL.
+ * \note If \c i is greater than the size of \c list, the elements will be
+ * moved at the end of \c list.
+ * \note The elements are relinked, not copied. Only reaching the Ith element
+ * depends on the size of the lists. \c other is empty afterwards.
+ */
+int cgc_list_splice (cgc_list * list, size_t i, cgc_list * other);
+
+/**
+ * \brief Move the elements of a list from index \c i onwards into another
+ * list.
+ * \param[in,out] list List.
+ * \param[in] i Index of the first element to move.
+ * \param[out] tail Destination list.
+ * \relatesalso cgc_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL or if both arguments are the
+ * same list. \c errno shall be set to \c EINVAL.
+ * \note \c tail is initialized with the element size, copy and cleaning
+ * functions of \c list. If \c i is greater than or equal to the size of
+ * \c list, \c tail is empty.
+ * \note The elements are relinked, not copied.
+ * \warning This function will overwrite \c tail! It is up to the user to
+ * first clean \c tail if needed.
+ */
+int cgc_list_split_at (cgc_list * list, size_t i, cgc_list * tail);
+
+////////////////////////////////////////////////////////////////////////////////
+// Sorting.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Sort a list.
+ * \param[in,out] list List.
+ * \param[in] compare_fun Comparison function.
+ * \relatesalso cgc_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \note The sort is stable and runs in O(n log n).
+ * \note The elements are relinked, not copied: no memory is allocated.
+ */
+int cgc_list_sort (cgc_list * list, cgc_compare_function compare_fun);
+
+/**
+ * \brief Merge a sorted list into another sorted list.
+ * \param[in,out] list Destination list.
+ * \param[in,out] other Source list.
+ * \param[in] compare_fun Comparison function.
+ * \relatesalso cgc_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, if both arguments are the
+ * same list, or if the lists do not hold elements of the same size. \c errno
+ * shall be set to \c EINVAL.
+ * \pre Both lists are sorted according to \c compare_fun.
+ * \note On equal elements, those of \c list come first.
+ * \note The elements are relinked, not copied. \c other is empty afterwards.
+ */
+int cgc_list_merge (cgc_list * list, cgc_list * other, cgc_compare_function compare_fun);
+
+////////////////////////////////////////////////////////////////////////////////
+// Memory layout.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Move the elements of a list into a single block, in list order.
+ * \param[in,out] list List.
+ * \relatesalso cgc_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if \c list is \c NULL. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of malloc. \c errno may be set to
+ * \c ENOMEM. The list is left untouched.
+ * \note The contents are moved, not copied: neither the copy nor the cleaning
+ * function is called.
+ * \warning Pointers to the elements and cursors on the list are invalidated.
+ */
+int cgc_list_compact (cgc_list * list);
+
+////////////////////////////////////////////////////////////////////////////////
+// Cursors.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get a cursor on the first element of a list.
+ * \param list List.
+ * \return A cursor. If the list is empty, the cursor is past the end.
+ * \relatesalso cgc_list_cursor
+ * \pre list != NULL
+ */
+cgc_list_cursor cgc_list_cursor_first (cgc_list * list);
+
+/**
+ * \brief Get a cursor on the last element of a list.
+ * \param list List.
+ * \return A cursor. If the list is empty, the cursor is past the end.
+ * \relatesalso cgc_list_cursor
+ * \pre list != NULL
+ */
+cgc_list_cursor cgc_list_cursor_last (cgc_list * list);
+
+/**
+ * \brief Check whether a cursor points to an element.
+ * \param cursor Cursor.
+ * \retval true if the cursor points to an element.
+ * \retval false if the cursor is past the end.
+ * \relatesalso cgc_list_cursor
+ */
+bool cgc_list_cursor_is_valid (const cgc_list_cursor * cursor);
+
+/**
+ * \brief Move a cursor to the next element.
+ * \param[in,out] cursor Cursor.
+ * \relatesalso cgc_list_cursor
+ * \note Moving forward from the last element leads past the end. Moving
+ * forward from past the end leads to the first element.
+ */
+void cgc_list_cursor_next (cgc_list_cursor * cursor);
+
+/**
+ * \brief Move a cursor to the previous element.
+ * \param[in,out] cursor Cursor.
+ * \relatesalso cgc_list_cursor
+ * \note Moving backward from the first element leads past the end. Moving
+ * backward from past the end leads to the last element.
+ */
+void cgc_list_cursor_previous (cgc_list_cursor * cursor);
+
+/**
+ * \brief Get the element a cursor points to.
+ * \param cursor Cursor.
+ * \return Element.
+ * \relatesalso cgc_list_cursor
+ * \pre cgc_list_cursor_is_valid(cursor) == \c true
+ * \warning This function does not check whether the supplied cursor is valid!
+ */
+void * cgc_list_cursor_get (const cgc_list_cursor * cursor);
+
+/**
+ * \brief Insert an element before the element a cursor points to.
+ * \param[in,out] cursor Cursor.
+ * \param[in] element Element.
+ * \relatesalso cgc_list_cursor
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the function failed because memory allocation failed. \c errno
+ * may be set to \c ENOMEM.
+ * \note If the cursor is past the end, the element is inserted at the end of
+ * the list.
+ * \note The cursor still points to the same element afterwards.
+ * \note The supplied element will be copied into the list. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_list_insert_before (cgc_list_cursor * cursor, const void * element);
+
+/**
+ * \brief Insert an element after the element a cursor points to.
+ * \param[in,out] cursor Cursor.
+ * \param[in] element Element.
+ * \relatesalso cgc_list_cursor
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the function failed because memory allocation failed. \c errno
+ * may be set to \c ENOMEM.
+ * \note If the cursor is past the end, the element is inserted at the
+ * beginning of the list.
+ * \note The cursor still points to the same element afterwards.
+ * \note The supplied element will be copied into the list. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_list_insert_after (cgc_list_cursor * cursor, const void * element);
+
+/**
+ * \brief Move all the elements of a list before the element a cursor points
+ * to.
+ * \param[in,out] cursor Cursor.
+ * \param[in,out] other Source list.
+ * \relatesalso cgc_list_cursor
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, if \c other is the list of
+ * the cursor, or if the lists do not hold elements of the same size. \c errno
+ * shall be set to \c EINVAL.
+ * \note If the cursor is past the end, the elements are moved at the end of
+ * the list.
+ * \note This function operates in constant time. \c other is empty
+ * afterwards.
+ */
+int cgc_list_splice_at (cgc_list_cursor * cursor, cgc_list * other);
+
+/**
+ * \brief Erase the element a cursor points to.
+ * \param[in,out] cursor Cursor.
+ * \relatesalso cgc_list_cursor
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if \c cursor is \c NULL or past the end. \c errno shall be set
+ * to \c EINVAL.
+ * \note The cursor is moved to the successor of the erased element.
+ */
+int cgc_list_erase_at (cgc_list_cursor * cursor);
+
 #endif /* _CGC_LIST_H_ */
@@ -0,0 +1,261 @@
+/**
+ * \file mpmc_queue.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_MPMC_QUEUE_H_
+#define _CGC_MPMC_QUEUE_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <sysexits.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \class cgc_mpmc_queue
+ * \ingroup queues_group
+ * \brief CGC Multi-producer multi-consumer queue.
+ *
+ * CGC MPMC Queues are bounded circular buffers which can be shared by any
+ * number of threads without locks.
+ *
+ * Each slot of the buffer carries a sequence number, which tells whether the
+ * slot is ready to be written or read for a given position. Producers and
+ * consumers claim a position by incrementing the tail or the head with a
+ * compare-and-swap, then fill or empty the slot, and finally publish its new
+ * sequence number with a release store. Threads only contend on the two
+ * indices, which are kept on separate cache lines.
+ *
+ * ## Capacity
+ * The capacity is fixed at initialization, and rounded up to the next power
+ * of two (at least 2).
+ *
+ * ## Blocking
+ * cgc_mpmc_queue_try_push() and cgc_mpmc_queue_try_pop_into() fail with
+ * \c errno set to \c EAGAIN when the queue is full or empty.
+ * cgc_mpmc_queue_push() and cgc_mpmc_queue_pop_into() retry instead, and
+ * yield the processor between attempts.
+ *
+ * ## Threads
+ * Only the push and pop functions, cgc_mpmc_queue_size() and
+ * cgc_mpmc_queue_is_empty() may be called concurrently. The other functions
+ * require exclusive access.
+ */
+typedef struct cgc_mpmc_queue
+{
+    _Alignas (CGC_CACHE_LINE_SIZE) atomic_size_t _tail; /**<- Next position to push. */
+    _Alignas (CGC_CACHE_LINE_SIZE) atomic_size_t _head; /**<- Next position to pop. */
+    _Alignas (CGC_CACHE_LINE_SIZE) char * _slots;       /**<- Slots. */
+    size_t _capacity;                                   /**<- Number of slots. */
+    size_t _slot_size;                                  /**<- Size of a slot. */
+    size_t _element_size;                               /**<- Element size. */
+    cgc_copy_function _copy_fun;                        /**<- Copy function. */
+    cgc_clean_function _clean_fun;                      /**<- Clean function. */
+} cgc_mpmc_queue;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_mpmc_queue.
+ * \param element_size Element size.
+ * \param copy_fun Copy function.
+ * \param clean_fun Cleaning function.
+ * \param capacity Minimal number of elements.
+ * \relatesalso cgc_mpmc_queue
+ * \return The pointer to the new cgc_mpmc_queue in case of success. \c NULL in
+ * case of failure.
+ * \retval NULL if the queue could not be allocated.
+ * \note Queues obtained this way must be freed using cgc_mpmc_queue_destroy().
+ * \note In case of failure, \c errno may be set to \c ENOMEM.
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_mpmc_queue * cgc_mpmc_queue_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity);
+
+/**
+ * \brief Free a dynamically allocated cgc_mpmc_queue.
+ * \param queue Queue.
+ * \relatesalso cgc_mpmc_queue
+ * \note A call to this function may change the value of \c errno.
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only of queues obtained
+ * via cgc_mpmc_queue_create().
+ */
+void cgc_mpmc_queue_destroy (cgc_mpmc_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_mpmc_queue.
+ * \param[in,out] queue Queue.
+ * \param[in] element_size Element size
+ * \param[in] copy_fun Copy function.
+ * \param[in] clean_fun Cleaning function.
+ * \param[in] capacity Minimal number of elements.
+ * \relatesalso cgc_mpmc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL or if \c capacity is 0. \c errno
+ * shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of malloc. \c errno may be set to
+ * \c ENOMEM.
+ */
+int cgc_mpmc_queue_init (cgc_mpmc_queue * queue, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity);
+
+/**
+ * \brief Clean a cgc_mpmc_queue.
+ * \param[in,out] queue Queue.
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \relatesalso cgc_mpmc_queue
+ */
+int cgc_mpmc_queue_clean (cgc_mpmc_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a CGC MPMC queue is empty.
+ * \param queue Queue.
+ * \retval true if the queue is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_mpmc_queue
+ * \note The result may be outdated as soon as it is returned.
+ */
+bool cgc_mpmc_queue_is_empty (const cgc_mpmc_queue * queue);
+
+/**
+ * \brief Get the size of the queue.
+ * \param queue Queue.
+ * \return size.
+ * \relatesalso cgc_mpmc_queue
+ * \note The result may be outdated as soon as it is returned. It also counts
+ * the elements which are being pushed or popped.
+ */
+size_t cgc_mpmc_queue_size (const cgc_mpmc_queue * queue);
+
+/**
+ * \brief Get the capacity of the queue.
+ * \param queue Queue.
+ * \return capacity.
+ * \relatesalso cgc_mpmc_queue
+ */
+size_t cgc_mpmc_queue_capacity (const cgc_mpmc_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Try to push to the back.
+ * \param[in,out] queue Queue
+ * \param[in] element Element.
+ * \relatesalso cgc_mpmc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL, or if the queue is full. \c
+ * errno shall be set to \c EINVAL or \c EAGAIN respectively.
+ * \retval <=-3 if the copy function failed.
+ * \note The supplied element will be copied into the queue. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_mpmc_queue_try_push (cgc_mpmc_queue * queue, const void * element);
+
+/**
+ * \brief Push to the back, waiting for a free slot if needed.
+ * \param[in,out] queue Queue
+ * \param[in] element Element.
+ * \relatesalso cgc_mpmc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval <=-3 if the copy function failed.
+ * \note The supplied element will be copied into the queue. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_mpmc_queue_push (cgc_mpmc_queue * queue, const void * element);
+
+/**
+ * \brief Try to pop the front into a buffer.
+ * \param[in,out] queue Queue.
+ * \param[out] destination Buffer of at least the size of an element.
+ * \relatesalso cgc_mpmc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, or if the queue is empty.
+ * \c errno shall be set to \c EINVAL or \c EAGAIN respectively.
+ * \note The element is moved: it is up to the user to clean
+ * \c destination once unneeded.
+ */
+int cgc_mpmc_queue_try_pop_into (cgc_mpmc_queue * queue, void * destination);
+
+/**
+ * \brief Pop the front into a buffer, waiting for an element if needed.
+ * \param[in,out] queue Queue.
+ * \param[out] destination Buffer of at least the size of an element.
+ * \relatesalso cgc_mpmc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \note The element is moved: it is up to the user to clean
+ * \c destination once unneeded.
+ */
+int cgc_mpmc_queue_pop_into (cgc_mpmc_queue * queue, void * destination);
+
+/**
+ * \brief Clear a queue.
+ * \param[in,out] queue Queue.
+ * \relatesalso cgc_mpmc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \warning No other thread may use the queue meanwhile.
+ */
+int cgc_mpmc_queue_clear (cgc_mpmc_queue * queue);
+
+#endif /* _CGC_MPMC_QUEUE_H_ */
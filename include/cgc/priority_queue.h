@@ -0,0 +1,272 @@
+/**
+ * \file priority_queue.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_PRIORITY_QUEUE_H_
+#define _CGC_PRIORITY_QUEUE_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+#include "cgc/vector.h"
+
+/**
+ * \defgroup priority_queues_group Priority queues
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \class cgc_priority_queue
+ * \ingroup priority_queues_group
+ * \brief CGC Priority queue.
+ *
+ * CGC Priority queues are binary heaps stored in a cgc_vector. The element at
+ * the top of the queue is the lowest one according to the comparison function
+ * supplied at the creation (see #cgc_compare_function): a max-heap is obtained
+ * by inverting the comparison.
+ *
+ * Pushing and popping take O(log n) comparisons. Elements are moved with
+ * \c memcpy, through a hole rather than by successive swaps: each level of the
+ * heap costs a single element copy.
+ *
+ * ## Bulk construction
+ * cgc_priority_queue_heapify() takes the storage of an existing cgc_vector
+ * over and rearranges it in O(n), without copying any element.
+ * cgc_priority_queue_push_n() appends several elements at once and rebuilds
+ * the heap in O(n) whenever this is cheaper than sifting each of them up.
+ *
+ * ## Popping
+ * cgc_priority_queue_pop() returns the top element in a newly allocated memory
+ * area, which has to be freed by the user. cgc_priority_queue_pop_into() moves
+ * it into a buffer supplied by the caller instead.
+ *
+ * \warning Pushing an element may move the storage: pointers obtained via
+ * cgc_priority_queue_top() are invalidated.
+ */
+typedef struct cgc_priority_queue
+{
+    cgc_vector _heap;                   /**<- Heap storage. */
+    cgc_compare_function _compare_fun;  /**<- Comparison function. */
+    void * _hole;                       /**<- Room for one element. */
+} cgc_priority_queue;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_priority_queue.
+ * \param element_size Element size.
+ * \param copy_fun Copy function.
+ * \param clean_fun Cleaning function.
+ * \param compare_fun Comparison function.
+ * \relatesalso cgc_priority_queue
+ * \return The pointer to the new cgc_priority_queue in case of success.
+ * \retval NULL if the queue could not be allocated, or if \c compare_fun is
+ * \c NULL.
+ * \note Priority queues obtained this way must be freed using
+ * cgc_priority_queue_destroy().
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_priority_queue * cgc_priority_queue_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, cgc_compare_function compare_fun);
+
+/**
+ * \brief Free a dynamically allocated cgc_priority_queue.
+ * \param queue Priority queue.
+ * \relatesalso cgc_priority_queue
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only on priority queues
+ * obtained via cgc_priority_queue_create().
+ */
+void cgc_priority_queue_destroy (cgc_priority_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_priority_queue.
+ * \param[in,out] queue Priority queue.
+ * \param[in] element_size Element size.
+ * \param[in] copy_fun Copy function.
+ * \param[in] clean_fun Cleaning function.
+ * \param[in] compare_fun Comparison function.
+ * \relatesalso cgc_priority_queue
+ * \retval 0 in case of success.
+ * \retval -1 if \c queue or \c compare_fun is \c NULL, or if \c element_size
+ * is 0. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
+ */
+int cgc_priority_queue_init (cgc_priority_queue * queue, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, cgc_compare_function compare_fun);
+
+/**
+ * \brief Clean a cgc_priority_queue.
+ * \param[in,out] queue Priority queue.
+ * \relatesalso cgc_priority_queue
+ * \retval 0 in case of success.
+ * \retval -1 if \c queue is \c NULL. \c errno shall be set to \c EINVAL.
+ */
+int cgc_priority_queue_clean (cgc_priority_queue * queue);
+
+/**
+ * \brief Make room for at least \c capacity elements.
+ * \param[in,out] queue Priority queue.
+ * \param[in] capacity Number of elements.
+ * \relatesalso cgc_priority_queue
+ * \retval 0 in case of success.
+ * \retval -1 if \c queue is \c NULL. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of \c realloc.
+ */
+int cgc_priority_queue_reserve (cgc_priority_queue * queue, size_t capacity);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a cgc_priority_queue is empty.
+ * \param queue Priority queue.
+ * \retval true if the queue is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_priority_queue
+ * \pre \c queue != \c NULL.
+ */
+bool cgc_priority_queue_is_empty (const cgc_priority_queue * queue);
+
+/**
+ * \brief Get the size of a cgc_priority_queue.
+ * \param queue Priority queue.
+ * \return Number of elements in the queue.
+ * \relatesalso cgc_priority_queue
+ * \pre \c queue != \c NULL.
+ */
+size_t cgc_priority_queue_size (const cgc_priority_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the top element of a cgc_priority_queue.
+ * \param queue Priority queue.
+ * \return A pointer to the lowest element of the queue.
+ * \relatesalso cgc_priority_queue
+ * \pre \c queue != \c NULL.
+ * \pre cgc_priority_queue_is_empty (queue) == false.
+ * \warning The element shall not be modified in a way which changes its
+ * order.
+ */
+void * cgc_priority_queue_top (const cgc_priority_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Push an element.
+ * \param[in,out] queue Priority queue.
+ * \param[in] element Element.
+ * \relatesalso cgc_priority_queue
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of \c realloc.
+ * \retval <=-3 in case of failure because of the copy function. The queue is
+ * left untouched.
+ */
+int cgc_priority_queue_push (cgc_priority_queue * queue, const void * element);
+
+/**
+ * \brief Push several elements.
+ * \param[in,out] queue Priority queue.
+ * \param[in] elements Contiguous array of \c count elements.
+ * \param[in] count Number of elements.
+ * \relatesalso cgc_priority_queue
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of \c realloc. No element is pushed.
+ * \retval <=-3 in case of failure because of the copy function. The elements
+ * preceding the failing one are pushed.
+ * \note When \c count is large compared to the size of the queue, the elements
+ * are appended and the whole heap is rebuilt in O(size + count). Otherwise,
+ * each element is sifted up in turn.
+ */
+int cgc_priority_queue_push_n (cgc_priority_queue * queue, const void * elements, size_t count);
+
+/**
+ * \brief Pop the top element.
+ * \param queue Priority queue.
+ * \return A pointer to the former top element, or \c NULL in case of failure.
+ * \relatesalso cgc_priority_queue
+ * \note The element shall be freed by the user.
+ */
+void * cgc_priority_queue_pop (cgc_priority_queue * queue);
+
+/**
+ * \brief Pop the top element into a buffer.
+ * \param[in,out] queue Priority queue.
+ * \param[out] destination Room for one element.
+ * \relatesalso cgc_priority_queue
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL or if the queue is empty.
+ * \c errno shall be set to \c EINVAL.
+ * \note The element is moved, not copied: ownership of any memory it points
+ * to is handed to the caller.
+ */
+int cgc_priority_queue_pop_into (cgc_priority_queue * queue, void * destination);
+
+/**
+ * \brief Take the elements of a vector over and arrange them as a heap.
+ * \param[in,out] queue Priority queue.
+ * \param[in,out] vector Vector.
+ * \relatesalso cgc_priority_queue
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, or if the vector and the
+ * queue differ in element size, copy function or cleaning function. \c errno
+ * shall be set to \c EINVAL.
+ * \note The former elements of the queue are cleaned. The storage of the
+ * vector is moved into the queue without copying any element, and \c vector
+ * is left empty.
+ * \note The heap is built bottom-up, in O(n).
+ */
+int cgc_priority_queue_heapify (cgc_priority_queue * queue, cgc_vector * vector);
+
+/**
+ * \brief Clear a cgc_priority_queue.
+ * \param[in,out] queue Priority queue.
+ * \relatesalso cgc_priority_queue
+ * \retval 0 in case of success.
+ * \retval -1 if \c queue is \c NULL. \c errno shall be set to \c EINVAL.
+ */
+int cgc_priority_queue_clear (cgc_priority_queue * queue);
+
+#endif /* _CGC_PRIORITY_QUEUE_H_ */
@@ -27,13 +27,13 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <errno.h>
 #include <sysexits.h>
 #include <string.h>
 
 #include "cgc/common.h"
 #include "cgc/types.h"
-#include "cgc/list.h"
 
 /**
  * \defgroup queues_group Queues
@@ -48,32 +48,41 @@
  * \ingroup queues_group
  * \brief CGC Queue.
  *
- * CGC Queues are akin to CGC Lists, but allow less operations.
+ * CGC Queues store their elements in a circular buffer: a contiguous array
+ * whose capacity is a power of two, in which the elements wrap around the
+ * end. Pushing or popping an element thus seldom involves the allocator.
+ * When the buffer is full, its capacity is doubled and the elements which
+ * wrapped around are moved after the others, so that the queue is
+ * contiguous again.
  *
- * CGC Queue function        | CGC List equivalent
- * --------------------------|-----------------------
- * cgc_queue_create()        | cgc_list_create()
- * cgc_queue_destroy()       | cgc_list_destroy()
- * cgc_queue_init()          | cgc_list_init()
- * cgc_queue_clean()         | cgc_list_clean()
- * cgc_queue_copy()          | cgc_list_copy()
- * cgc_queue_copy_into()     | cgc_list_copy_into()
- * cgc_queue_swap()          | cgc_list_swap()
- * cgc_queue_front()         | cgc_list_front()
- * cgc_queue_back()          | cgc_list_back()
- * cgc_queue_is_empty()      | cgc_list_is_empty()
- * cgc_queue_size()          | cgc_list_size()
- * cgc_queue_push()          | cgc_list_push_back()
- * cgc_queue_pop()           | cgc_list_pop_front()
- * cgc_queue_clear()         | cgc_list_clear()
+ * ## Capacity
+ * cgc_queue_reserve() makes room for a given number of elements at once.
+ * The capacity is rounded up to the next power of two.
  *
- * \sa cgc_list
- */
-
-/**
- * \brief cgc_queue
+ * ## Popping
+ * cgc_queue_pop() returns the front element in a newly allocated memory area,
+ * which has to be freed by the user. cgc_queue_pop_into() moves it into a
+ * buffer supplied by the caller instead, and does not allocate anything.
+ *
+ * ## Batches
+ * cgc_queue_push_n() and cgc_queue_pop_n() move several elements at once:
+ * the buffer grows at most once, and when no copy function is used the
+ * elements are moved with at most two \c memcpy calls, one on each side of
+ * the wrap-around.
+ *
+ * \warning Pushing an element may move the buffer: pointers obtained via
+ * cgc_queue_front() or cgc_queue_back() are invalidated.
  */
-typedef cgc_list cgc_queue;
+typedef struct cgc_queue
+{
+    char * _content;                /**<- Content. */
+    size_t _first;                  /**<- Index of the front element. */
+    size_t _size;                   /**<- Size. */
+    size_t _capacity;               /**<- Number of allocated elements. */
+    size_t _element_size;           /**<- Element size. */
+    cgc_copy_function _copy_fun;    /**<- Copy function. */
+    cgc_clean_function _clean_fun;  /**<- Clean function. */
+} cgc_queue;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Dynamic creation and destruction.
@@ -136,6 +145,22 @@ int cgc_queue_init (cgc_queue * queue, size_t element_size, cgc_copy_function co
  */
 int cgc_queue_clean (cgc_queue * queue);
 
+/**
+ * \brief Make room for at least \c capacity elements.
+ * \param[in,out] queue Queue.
+ * \param[in] capacity Number of elements.
+ * \relatesalso cgc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of realloc. \c errno may be set to
+ * \c ENOMEM.
+ * \note The capacity of a queue never shrinks, except with cgc_queue_clean().
+ */
+int cgc_queue_reserve (cgc_queue * queue, size_t capacity);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Copy.
 ////////////////////////////////////////////////////////////////////////////////
@@ -255,13 +280,59 @@ int cgc_queue_push (cgc_queue * queue, const void * element);
  * \brief Pop the front.
  * \param[in,out] queue Queue.
  * \return First element.
+ * \retval NULL if \c queue is \c NULL or empty, or if the element could not
+ * be allocated.
  * \relatesalso cgc_queue
  * \warning It is up to the user to free the returned element once unneeded.
- * \pre queue != NULL
- * \pre cgc_queue_is_empty(queue) == \c false
  */
 void * cgc_queue_pop (cgc_queue * queue);
 
+/**
+ * \brief Pop the front into a buffer.
+ * \param[in,out] queue Queue.
+ * \param[out] destination Buffer of at least the size of an element.
+ * \relatesalso cgc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL or if the queue is empty.
+ * \c errno shall be set to \c EINVAL.
+ * \note The element is moved: it is up to the user to clean
+ * \c destination once unneeded.
+ */
+int cgc_queue_pop_into (cgc_queue * queue, void * destination);
+
+/**
+ * \brief Push several elements to the back.
+ * \param[in,out] queue Queue.
+ * \param[in] elements Contiguous array of \c count elements.
+ * \param[in] count Number of elements.
+ * \relatesalso cgc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of realloc, or if the size would
+ * overflow. \c errno shall be set to \c ENOMEM. No element is pushed.
+ * \retval <=-3 in case of failure because of the copy function. The elements
+ * preceding the failing one are pushed.
+ * \note The elements are pushed in the order of the array.
+ */
+int cgc_queue_push_n (cgc_queue * queue, const void * elements, size_t count);
+
+/**
+ * \brief Pop several elements from the front into a buffer.
+ * \param[in,out] queue Queue.
+ * \param[out] destination Buffer of at least \c max elements.
+ * \param[in] max Maximum number of elements to pop.
+ * \relatesalso cgc_queue
+ * \return Number of popped elements, 0 if one of the arguments is \c NULL.
+ * \note The elements are moved, front first: it is up to the user to clean
+ * them once unneeded.
+ */
+size_t cgc_queue_pop_n (cgc_queue * queue, void * destination, size_t max);
+
 /**
  * \brief Clear a queue.
  * \param[in,out] queue Queue.
@@ -0,0 +1,287 @@
+/**
+ * \file radix_tree.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_RADIX_TREE_H_
+#define _CGC_RADIX_TREE_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+
+/**
+ * \defgroup maps_group Maps
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Node of a radix tree.
+ * \ingroup maps_group
+ *
+ * Nodes are private to radix_tree.c.
+ */
+typedef struct cgc_radix_tree_node cgc_radix_tree_node;
+
+/**
+ * \brief Function called on the entries of a radix tree.
+ * \ingroup maps_group
+ *
+ * The function receives the key of the entry, its length, a pointer to the
+ * value of the entry, and the pointer given to the iteration function. It
+ * shall return 0 to continue the iteration, and any other value to stop it.
+ */
+typedef int (* cgc_radix_tree_visit_function) (const void * key, size_t length, void * value, void * data);
+
+/**
+ * \class cgc_radix_tree
+ * \ingroup maps_group
+ * \brief CGC Radix tree.
+ *
+ * CGC Radix trees map byte string keys to values. They are adaptive radix
+ * trees: each inner node consumes one byte of the key, and comes in one of
+ * four sizes depending on its number of children.
+ *
+ * Node     | Children  | Lookup of a byte
+ * ---------|-----------|-------------------------------------------------
+ * Node4    | 1 to 4    | Linear search among sorted keys
+ * Node16   | 5 to 16   | SSE2 comparison of the 16 keys when available
+ * Node48   | 17 to 48  | 256 bytes index, then child
+ * Node256  | 49 to 256 | Direct
+ *
+ * Chains of nodes with a single child are collapsed: nodes hold the bytes
+ * all the keys below them share (path compression). Lookups therefore cost
+ * O(k) for keys of length k, independently of the number of entries, and
+ * touch one small node per distinct byte position.
+ *
+ * Keys are arbitrary sequences of bytes, and may be prefixes of one another.
+ * Entries are visited in lexicographic order of their keys, comparing bytes as
+ * \c unsigned \c char, like memcmp().
+ *
+ * ## Values
+ * Values are copied into the tree using the copy function, and cleaned when
+ * their entry is erased or replaced (see #cgc_copy_function and
+ * #cgc_clean_function). Each entry is a single allocation holding the value
+ * and a copy of the key.
+ */
+typedef struct cgc_radix_tree
+{
+    cgc_radix_tree_node * _root;        /**<- Root. */
+    size_t _size;                       /**<- Number of entries. */
+    size_t _element_size;               /**<- Value size. */
+    size_t _value_offset;               /**<- Offset of the value in a leaf. */
+    cgc_copy_function _copy_fun;        /**<- Copy function. */
+    cgc_clean_function _clean_fun;      /**<- Clean function. */
+} cgc_radix_tree;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_radix_tree.
+ * \param element_size Value size.
+ * \param copy_fun Copy function.
+ * \param clean_fun Cleaning function.
+ * \relatesalso cgc_radix_tree
+ * \return The pointer to the new cgc_radix_tree in case of success.
+ * \retval NULL if the tree could not be allocated.
+ * \note Trees obtained this way must be freed using cgc_radix_tree_destroy().
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_radix_tree * cgc_radix_tree_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun);
+
+/**
+ * \brief Free a dynamically allocated cgc_radix_tree.
+ * \param tree Radix tree.
+ * \relatesalso cgc_radix_tree
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only on trees obtained
+ * via cgc_radix_tree_create().
+ */
+void cgc_radix_tree_destroy (cgc_radix_tree * tree);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_radix_tree.
+ * \param[in,out] tree Radix tree.
+ * \param[in] element_size Value size.
+ * \param[in] copy_fun Copy function.
+ * \param[in] clean_fun Cleaning function.
+ * \relatesalso cgc_radix_tree
+ * \retval 0 in case of success.
+ * \retval -1 if \c tree is \c NULL. \c errno shall be set to \c EINVAL.
+ */
+int cgc_radix_tree_init (cgc_radix_tree * tree, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun);
+
+/**
+ * \brief Clean a cgc_radix_tree.
+ * \param[in,out] tree Radix tree.
+ * \relatesalso cgc_radix_tree
+ * \retval 0 in case of success.
+ * \retval -1 if \c tree is \c NULL. \c errno shall be set to \c EINVAL.
+ */
+int cgc_radix_tree_clean (cgc_radix_tree * tree);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a cgc_radix_tree is empty.
+ * \param tree Radix tree.
+ * \retval true if the tree is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_radix_tree
+ * \pre \c tree != \c NULL.
+ */
+bool cgc_radix_tree_is_empty (const cgc_radix_tree * tree);
+
+/**
+ * \brief Get the number of entries of a cgc_radix_tree.
+ * \param tree Radix tree.
+ * \return Number of entries.
+ * \relatesalso cgc_radix_tree
+ * \pre \c tree != \c NULL.
+ */
+size_t cgc_radix_tree_size (const cgc_radix_tree * tree);
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Find the value of a key.
+ * \param tree Radix tree.
+ * \param key Key.
+ * \param length Length of the key.
+ * \return A pointer to the value of the key.
+ * \retval NULL if the key is not in the tree.
+ * \relatesalso cgc_radix_tree
+ * \pre \c tree != \c NULL.
+ * \note The pointer remains valid until the entry is erased or replaced.
+ */
+void * cgc_radix_tree_find (const cgc_radix_tree * tree, const void * key, size_t length);
+
+/**
+ * \brief Find the value of the longest key which is a prefix of a key.
+ * \param[in] tree Radix tree.
+ * \param[in] key Key.
+ * \param[in] length Length of the key.
+ * \param[out] matched Length of the longest prefix found, may be \c NULL.
+ * \return A pointer to the value of the longest prefix.
+ * \retval NULL if no key of the tree is a prefix of \c key.
+ * \relatesalso cgc_radix_tree
+ * \pre \c tree != \c NULL.
+ * \note A key is a prefix of itself.
+ */
+void * cgc_radix_tree_longest_prefix (const cgc_radix_tree * tree, const void * key, size_t length, size_t * matched);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Insert an entry, or replace the value of an existing one.
+ * \param[in,out] tree Radix tree.
+ * \param[in] key Key.
+ * \param[in] length Length of the key.
+ * \param[in] value Value.
+ * \relatesalso cgc_radix_tree
+ * \retval 0 in case of success.
+ * \retval -1 if one of \c tree and \c value is \c NULL, or if \c key is
+ * \c NULL while \c length is not 0. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
+ * \retval -3 or lower if the copy function failed.
+ * \note The key and the value are copied into the tree. In case of failure,
+ * the tree is left unchanged.
+ */
+int cgc_radix_tree_insert (cgc_radix_tree * tree, const void * key, size_t length, const void * value);
+
+/**
+ * \brief Erase an entry.
+ * \param tree Radix tree.
+ * \param key Key.
+ * \param length Length of the key.
+ * \retval true if the entry was erased.
+ * \retval false if the key is not in the tree.
+ * \relatesalso cgc_radix_tree
+ * \pre \c tree != \c NULL.
+ */
+bool cgc_radix_tree_erase (cgc_radix_tree * tree, const void * key, size_t length);
+
+/**
+ * \brief Erase every entry.
+ * \param[in,out] tree Radix tree.
+ * \relatesalso cgc_radix_tree
+ * \retval 0 in case of success.
+ * \retval -1 if \c tree is \c NULL. \c errno shall be set to \c EINVAL.
+ */
+int cgc_radix_tree_clear (cgc_radix_tree * tree);
+
+////////////////////////////////////////////////////////////////////////////////
+// Iteration.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Visit every entry, in order.
+ * \param tree Radix tree.
+ * \param visit_fun Function called on each entry.
+ * \param data Pointer passed to \c visit_fun.
+ * \return 0 if every entry was visited, or the first non-zero value returned
+ * by \c visit_fun.
+ * \relatesalso cgc_radix_tree
+ * \pre \c tree != \c NULL.
+ * \warning \c visit_fun shall not modify the tree.
+ */
+int cgc_radix_tree_for_each (const cgc_radix_tree * tree, cgc_radix_tree_visit_function visit_fun, void * data);
+
+/**
+ * \brief Visit every entry whose key starts with a prefix, in order.
+ * \param tree Radix tree.
+ * \param prefix Prefix.
+ * \param length Length of the prefix.
+ * \param visit_fun Function called on each entry.
+ * \param data Pointer passed to \c visit_fun.
+ * \return 0 if every matching entry was visited, or the first non-zero value
+ * returned by \c visit_fun.
+ * \relatesalso cgc_radix_tree
+ * \pre \c tree != \c NULL.
+ * \note The subtree holding the matching entries is found in O(length) steps,
+ * and the other entries are never visited.
+ * \warning \c visit_fun shall not modify the tree.
+ */
+int cgc_radix_tree_for_each_prefix (const cgc_radix_tree * tree, const void * prefix, size_t length, cgc_radix_tree_visit_function visit_fun, void * data);
+
+#endif /* _CGC_RADIX_TREE_H_ */
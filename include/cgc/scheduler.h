@@ -0,0 +1,181 @@
+/**
+ * \file scheduler.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_SCHEDULER_H_
+#define _CGC_SCHEDULER_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <sysexits.h>
+#include <pthread.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+#include "cgc/queue.h"
+#include "cgc/work_deque.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Worker of a cgc_scheduler.
+ */
+typedef struct cgc_scheduler_worker cgc_scheduler_worker;
+
+/**
+ * \class cgc_scheduler
+ * \ingroup schedulers_group
+ * \brief CGC Work-stealing scheduler.
+ *
+ * CGC Schedulers run tasks on a fixed set of worker threads. A task is an
+ * operation function and its argument:
+ *
+ *      int operation (void * argument)
+ *
+ * Each worker owns a #cgc_work_deque. Tasks spawned by a running task go to
+ * the deque of its worker, which runs them in LIFO order, as a recursive
+ * call would. Idle workers steal the oldest tasks of the others, which tend
+ * to be the largest ones. Tasks spawned from other threads go to a shared
+ * injection queue.
+ *
+ * Workers with nothing to do sleep until a task is spawned.
+ *
+ * ## Waiting
+ * cgc_scheduler_wait() blocks until all the spawned tasks, including the
+ * tasks they spawned, are done. It must not be called from a task.
+ *
+ * \note The values returned by the operation functions are ignored.
+ * \sa cgc_work_deque
+ */
+typedef struct cgc_scheduler
+{
+    cgc_scheduler_worker * _workers;    /**<- Workers. */
+    pthread_t * _threads;               /**<- Worker threads. */
+    size_t _worker_count;               /**<- Number of workers. */
+    cgc_queue _injected;                /**<- Tasks spawned outside the workers. */
+    pthread_mutex_t _mutex;             /**<- Protects the injection queue and sleeping. */
+    pthread_cond_t _wake;               /**<- Signaled when a task is spawned. */
+    pthread_cond_t _done;               /**<- Signaled when no task is left. */
+    atomic_size_t _pending;             /**<- Number of spawned tasks not done. */
+    atomic_size_t _sleeping;            /**<- Number of sleeping workers. */
+    atomic_bool _stop;                  /**<- Whether the workers must exit. */
+} cgc_scheduler;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_scheduler.
+ * \param worker_count Number of worker threads.
+ * \relatesalso cgc_scheduler
+ * \return The pointer to the new cgc_scheduler in case of success. \c NULL in
+ * case of failure.
+ * \retval NULL if the scheduler could not be allocated or started.
+ * \note Schedulers obtained this way must be freed using
+ * cgc_scheduler_destroy().
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_scheduler * cgc_scheduler_create (size_t worker_count);
+
+/**
+ * \brief Free a dynamically allocated cgc_scheduler.
+ * \param scheduler Scheduler.
+ * \relatesalso cgc_scheduler
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only of schedulers
+ * obtained via cgc_scheduler_create().
+ */
+void cgc_scheduler_destroy (cgc_scheduler * scheduler);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_scheduler, and start its workers.
+ * \param[in,out] scheduler Scheduler.
+ * \param[in] worker_count Number of worker threads.
+ * \relatesalso cgc_scheduler
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL or if \c worker_count is 0.
+ * \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of malloc, or if the threads or their
+ * synchronization primitives could not be created.
+ */
+int cgc_scheduler_init (cgc_scheduler * scheduler, size_t worker_count);
+
+/**
+ * \brief Stop the workers of a cgc_scheduler, and clean it.
+ * \param[in,out] scheduler Scheduler.
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \relatesalso cgc_scheduler
+ * \note Running tasks are completed, tasks not started yet are discarded.
+ */
+int cgc_scheduler_clean (cgc_scheduler * scheduler);
+
+////////////////////////////////////////////////////////////////////////////////
+// Tasks.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Spawn a task.
+ * \param[in,out] scheduler Scheduler.
+ * \param[in] op_fun Operation function.
+ * \param[in] argument Argument of the operation function.
+ * \relatesalso cgc_scheduler
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if \c scheduler or \c op_fun is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of malloc. \c errno may be set to
+ * \c ENOMEM.
+ * \note This function may be called from any thread, including from tasks.
+ */
+int cgc_scheduler_spawn (cgc_scheduler * scheduler, cgc_unary_op_function op_fun, void * argument);
+
+/**
+ * \brief Wait until all the spawned tasks are done.
+ * \param[in,out] scheduler Scheduler.
+ * \relatesalso cgc_scheduler
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \warning This function must not be called from a task.
+ */
+int cgc_scheduler_wait (cgc_scheduler * scheduler);
+
+#endif /* _CGC_SCHEDULER_H_ */
@@ -0,0 +1,434 @@
+/**
+ * \file skip_list.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_SKIP_LIST_H_
+#define _CGC_SKIP_LIST_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sysexits.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+
+/**
+ * \defgroup cgc_skip_list_group CGC Skip Lists
+ * \ingroup lists_group
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Maximal number of levels of a skip list.
+ * \ingroup cgc_skip_list_group
+ */
+#define CGC_SKIP_LIST_MAX_LEVEL 32
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+struct cgc_skip_list_node;
+
+/**
+ * \brief CGC Skip list link.
+ * \ingroup cgc_skip_list_group
+ *
+ * A link leads to the next node of the same level, and records how many
+ * positions it skips.
+ */
+typedef struct cgc_skip_list_link
+{
+    struct cgc_skip_list_node * _next;  /**< Next node at this level. */
+    size_t _width;                      /**< Number of positions skipped. */
+} cgc_skip_list_link;
+
+/**
+ * \brief CGC Skip list node.
+ * \ingroup cgc_skip_list_group
+ *
+ * Skip list nodes are used internally to store the elements of skip lists.
+ */
+typedef struct cgc_skip_list_node
+{
+    void * _content;                /**< Content. */
+    size_t _level_count;            /**< Number of levels. */
+    cgc_skip_list_link _links[];    /**< Links, one per level. */
+} cgc_skip_list_node;
+
+/**
+ * \brief CGC Skip list.
+ * \ingroup cgc_skip_list_group
+ *
+ * CGC Skip lists are generic sequences offering logarithmic time access,
+ * insertion and deletion at any index.
+ *
+ * # Basics
+ * Like CGC Lists, CGC Skip lists rely on the size in bytes of the elements,
+ * a copy function and a cleaning function. See cgc_list for details.
+ *
+ * # Indexing
+ * Each node is linked to its successors on a random number of levels. Every
+ * link records its width, i.e. the number of positions it skips. Reaching the
+ * Nth element only requires following the links whose cumulated width does not
+ * exceed N, from the top level down to the bottom level.
+ *
+ * Access function          | Complexity
+ * -------------------------|----------------
+ * cgc_skip_list_at()       | O(log n)
+ * cgc_skip_list_front()    | O(1)
+ * cgc_skip_list_back()     | O(log n)
+ * cgc_skip_list_insert()   | O(log n)
+ * cgc_skip_list_erase()    | O(k log n)
+ *
+ * \b Important: Elements obtained through cgc_skip_list_pop_front() and
+ * cgc_skip_list_pop_back() shall be freed by the user.
+ *
+ * \sa cgc_list
+ */
+typedef struct cgc_skip_list
+{
+    cgc_skip_list_node * _head;         /**< Head (not an element). */
+    size_t _level_count;                /**< Number of levels in use. */
+    cgc_clean_function _clean_fun;      /**< Clean function. */
+    cgc_copy_function _copy_fun;        /**< Copy function. */
+    size_t _size;                       /**< Size. */
+    size_t _element_size;               /**< Element size. */
+    uint64_t _random_state;             /**< Level generator state. */
+} cgc_skip_list;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_skip_list.
+ * \param element_size Element size.
+ * \param copy_fun Copy function.
+ * \param clean_fun Cleaning function.
+ * \relatesalso cgc_skip_list
+ * \return The pointer to the new cgc_skip_list in case of success. \c NULL in
+ * case of failure.
+ * \retval NULL if the list could not be allocated.
+ * \note Lists obtained this way must be freed using cgc_skip_list_destroy().
+ * \note In case of failure, \c errno may be set to \c ENOMEM.
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_skip_list * cgc_skip_list_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun);
+
+/**
+ * \brief Free a dynamically allocated cgc_skip_list.
+ * \param list List.
+ * \relatesalso cgc_skip_list
+ * \note A call to this function may change the value of \c errno.
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only of lists obtained
+ * via cgc_skip_list_create().
+ */
+void cgc_skip_list_destroy (cgc_skip_list * list);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_skip_list.
+ * \param[in,out] list List.
+ * \param[in] element_size Element size
+ * \param[in] copy_fun Copy function.
+ * \param[in] clean_fun Cleaning function.
+ * \relatesalso cgc_skip_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the function failed because memory allocation failed. \c errno
+ * may be set to \c ENOMEM.
+ */
+int cgc_skip_list_init (cgc_skip_list * list, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun);
+
+/**
+ * \brief Clean a cgc_skip_list.
+ * \param[in,out] list List.
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \relatesalso cgc_skip_list
+ */
+int cgc_skip_list_clean (cgc_skip_list * list);
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Copy a list.
+ * \param list List.
+ * \return A pointer to the copy in case of success. \c NULL in case of failure.
+ * \relatesalso cgc_skip_list
+ * \note It is safe to pass a \c NULL to this function.
+ * \retval NULL if the list could not be copied or \c list was \c NULL.
+ * \note Lists obtained this way must be freed using cgc_skip_list_destroy().
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_skip_list * cgc_skip_list_copy (const cgc_skip_list * list);
+
+/**
+ * \brief Copy a cgc_skip_list into \c destination.
+ * \param[in] original The original.
+ * \param[in,out] destination The destination of the copy.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno may be set to \c EINVAL.
+ * \retval -2 if the function failed because memory allocation failed. \c errno
+ * may be set to \c ENOMEM.
+ * \retval -3 or lower if the copy function failed.
+ * \relatesalso cgc_skip_list
+ * \note In case of failure, the elements already copied are cleaned and
+ * \c destination is left uninitialized.
+ * \warning This function will overwrite the destination! It is up to the user to
+ * first clean \c destination if needed.
+ */
+int cgc_skip_list_copy_into (const cgc_skip_list * original, cgc_skip_list * destination);
+
+////////////////////////////////////////////////////////////////////////////////
+// Swap.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Swap the contents of two lists.
+ * \param[in,out] a First list.
+ * \param[in,out] b Second list.
+ * \relatesalso cgc_skip_list
+ * \pre a != NULL && b != NULL
+ * \return 0 in case of success.
+ * \return -1 if at least of the argumes is \c NULL. \c errno may be set to
+ * \c EINVAL.
+ * \note A cal to this function may change the value of \c errno.
+ */
+int cgc_skip_list_swap (cgc_skip_list * a, cgc_skip_list * b);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a CGC skip list is empty.
+ * \param list List.
+ * \retval true if the list is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_skip_list
+ */
+bool cgc_skip_list_is_empty (const cgc_skip_list * list);
+
+/**
+ * \brief Get the size of the list.
+ * \param list List.
+ * \return size.
+ * \relatesalso cgc_skip_list
+ */
+size_t cgc_skip_list_size (const cgc_skip_list * list);
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the element at index \c i.
+ * \param list List.
+ * \param i Index.
+ * \return element. \c NULL if \c i is out of bounds.
+ * \relatesalso cgc_skip_list
+ * \pre list != NULL
+ * \warning This function does not check whether the supplied list is valid!
+ */
+void * cgc_skip_list_at (const cgc_skip_list * list, size_t i);
+
+/**
+ * \brief Get the front of the list.
+ * \param list List.
+ * \return Front.
+ * \relatesalso cgc_skip_list
+ * \pre cgc_skip_list_is_empty(list) == \c false
+ * \pre list != NULL
+ * \warning This function does not check whether the supplied list is valid!
+ * \warning This function does not check whether the supplied list is long enough!
+ */
+void * cgc_skip_list_front (const cgc_skip_list * list);
+
+/**
+ * \brief Get the back of the list.
+ * \param list List.
+ * \return Back.
+ * \relatesalso cgc_skip_list
+ * \pre cgc_skip_list_is_empty(list) == \c false
+ * \pre list != NULL
+ * \warning This function does not check whether the supplied list is valid!
+ * \warning This function does not check whether the supplied list is long enough!
+ */
+void * cgc_skip_list_back (const cgc_skip_list * list);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Push to the front.
+ * \param[in,out] list List
+ * \param[in] element Element.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the the function failed because memory allocation failed. \c
+ * errno may be set to \c ENOMEM.
+ * \relatesalso cgc_skip_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \note The supplied element will be copied into the list. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_skip_list_push_front (cgc_skip_list * list, const void * element);
+
+/**
+ * \brief Push to the back.
+ * \param[in,out] list List
+ * \param[in] element Element.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the the function failed because memory allocation failed. \c
+ * errno may be set to \c ENOMEM.
+ * \relatesalso cgc_skip_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \note The supplied element will be copied into the list. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_skip_list_push_back (cgc_skip_list * list, const void * element);
+
+/**
+ * \brief Pop the front.
+ * \param[in,out] list List.
+ * \return First element.
+ * \relatesalso cgc_skip_list
+ * \warning It is up to the user to free the returned element once unneeded.
+ * \pre list != NULL
+ * \pre cgc_skip_list_is_empty(list) == \c false
+ */
+void * cgc_skip_list_pop_front (cgc_skip_list * list);
+
+/**
+ * \brief Pop the back.
+ * \param[in,out] list List.
+ * \return Last element.
+ * \relatesalso cgc_skip_list
+ * \warning It is up to the user to free the returned element once unneeded.
+ * \pre list != NULL
+ * \pre cgc_skip_list_is_empty(list) == \c false
+ */
+void * cgc_skip_list_pop_back (cgc_skip_list * list);
+
+/**
+ * \brief Insert an element a the Ith place in a list.
+ * \param[in,out] list List.
+ * \param[in] i Target index.
+ * \param[in] element Element.
+ * \relatesalso cgc_skip_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the function failed because memory allocation failed. \c errno
+ * may be set to \c ENOMEM.
+ * \note If \c i is greater than the size of the list, the \c element will be
+ * inserted at the end of the list.
+ * \note The supplied element will be copied into the list. It is safe to free
+ * \c element afterwards, if it was malloc'd.
+ */
+int cgc_skip_list_insert (cgc_skip_list * list, size_t i, const void * element);
+
+/**
+ * \brief Clear a list.
+ * \param[in,out] list List.
+ * \relatesalso cgc_skip_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ */
+int cgc_skip_list_clear (cgc_skip_list * list);
+
+/**
+ * \brief Erase elements from start to end excluded from a list.
+ * \param[in,out] list List.
+ * \param[in] start First element to remove.
+ * \param[in] end Element after the last element to remove.
+ * \relatesalso cgc_skip_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is invalid: either if list is \c NULL, if
+ * \c start > cgc_skip_list_size(list) or if \c end < \c start. \c errno shall
+ * be set to \c EINVAL.
+ * \pre cgc_skip_list_size(\c list) > \c start
+ * \pre \c start < \c end
+ * \pre \c list != \c NULL
+ */
+int cgc_skip_list_erase (cgc_skip_list * list, size_t start, size_t end);
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions on lists.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Map.
+ * \param[in,out] list List
+ * \param[in] op_fun Operation.
+ * \relatesalso cgc_skip_list
+ * \note The list will be modified. First copy the list if the original must
+ * be kept.
+ */
+void cgc_skip_list_map (cgc_skip_list * list, cgc_unary_op_function op_fun);
+
+/**
+ * \brief Fold left.
+ * \param[in] list List.
+ * \param[in] op_fun Binary operation.
+ * \param[in,out] base_result Initial value and result.
+ * \relatesalso cgc_skip_list
+ * \note \c base_result must hold the initial value before the call to this
+ * function but will be modified to hold the result.
+ */
+void cgc_skip_list_fold_left (const cgc_skip_list * list, cgc_binary_op_left_function op_fun, void * base_result);
+
+#endif /* _CGC_SKIP_LIST_H_ */
@@ -0,0 +1,262 @@
+/**
+ * \file spsc_queue.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_SPSC_QUEUE_H_
+#define _CGC_SPSC_QUEUE_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <sysexits.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \class cgc_spsc_queue
+ * \ingroup queues_group
+ * \brief CGC Single-producer single-consumer queue.
+ *
+ * CGC SPSC Queues are bounded circular buffers which can be shared by exactly
+ * two threads without locks: one thread pushes, the other one pops.
+ *
+ * The producer only writes the tail index and the consumer only writes the
+ * head index. Each of them publishes its index with a release store and
+ * reads the other one with an acquire load, which makes the elements written
+ * by the producer visible to the consumer. Both indices are kept on
+ * separate cache lines, along with a private copy of the index of the other
+ * thread, so that the shared indices are only read when the queue looks
+ * full or empty.
+ *
+ * ## Capacity
+ * The capacity is fixed at initialization, and rounded up to the next power
+ * of two. Pushing into a full queue or popping from an empty one fails with
+ * \c errno set to \c EAGAIN; the caller decides whether to retry.
+ *
+ * ## Batches
+ * cgc_spsc_queue_push_n() and cgc_spsc_queue_pop_n() transfer several
+ * contiguous elements at once, and publish the index only once.
+ *
+ * ## Threads
+ * Only cgc_spsc_queue_push() and cgc_spsc_queue_push_n() may be called by the
+ * producer, and only cgc_spsc_queue_pop_into() and cgc_spsc_queue_pop_n() by
+ * the consumer. cgc_spsc_queue_is_empty() and cgc_spsc_queue_size() may be
+ * called by either thread. The other functions require exclusive access.
+ */
+typedef struct cgc_spsc_queue
+{
+    _Alignas (CGC_CACHE_LINE_SIZE) atomic_size_t _head; /**<- Index of the next element to pop. */
+    size_t _cached_tail;                                /**<- Consumer's copy of the tail. */
+    _Alignas (CGC_CACHE_LINE_SIZE) atomic_size_t _tail; /**<- Index of the next element to push. */
+    size_t _cached_head;                                /**<- Producer's copy of the head. */
+    _Alignas (CGC_CACHE_LINE_SIZE) char * _content;     /**<- Content. */
+    size_t _capacity;                                   /**<- Number of elements. */
+    size_t _element_size;                               /**<- Element size. */
+    cgc_copy_function _copy_fun;                        /**<- Copy function. */
+    cgc_clean_function _clean_fun;                      /**<- Clean function. */
+} cgc_spsc_queue;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_spsc_queue.
+ * \param element_size Element size.
+ * \param copy_fun Copy function.
+ * \param clean_fun Cleaning function.
+ * \param capacity Minimal number of elements.
+ * \relatesalso cgc_spsc_queue
+ * \return The pointer to the new cgc_spsc_queue in case of success. \c NULL in
+ * case of failure.
+ * \retval NULL if the queue could not be allocated.
+ * \note Queues obtained this way must be freed using cgc_spsc_queue_destroy().
+ * \note In case of failure, \c errno may be set to \c ENOMEM.
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_spsc_queue * cgc_spsc_queue_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity);
+
+/**
+ * \brief Free a dynamically allocated cgc_spsc_queue.
+ * \param queue Queue.
+ * \relatesalso cgc_spsc_queue
+ * \note A call to this function may change the value of \c errno.
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only of queues obtained
+ * via cgc_spsc_queue_create().
+ */
+void cgc_spsc_queue_destroy (cgc_spsc_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_spsc_queue.
+ * \param[in,out] queue Queue.
+ * \param[in] element_size Element size
+ * \param[in] copy_fun Copy function.
+ * \param[in] clean_fun Cleaning function.
+ * \param[in] capacity Minimal number of elements.
+ * \relatesalso cgc_spsc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL or if \c capacity is 0. \c errno
+ * shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of malloc. \c errno may be set to
+ * \c ENOMEM.
+ */
+int cgc_spsc_queue_init (cgc_spsc_queue * queue, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity);
+
+/**
+ * \brief Clean a cgc_spsc_queue.
+ * \param[in,out] queue Queue.
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \relatesalso cgc_spsc_queue
+ */
+int cgc_spsc_queue_clean (cgc_spsc_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a CGC SPSC queue is empty.
+ * \param queue Queue.
+ * \retval true if the queue is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_spsc_queue
+ * \note The result may be outdated as soon as it is returned.
+ */
+bool cgc_spsc_queue_is_empty (const cgc_spsc_queue * queue);
+
+/**
+ * \brief Get the size of the queue.
+ * \param queue Queue.
+ * \return size.
+ * \relatesalso cgc_spsc_queue
+ * \note The result may be outdated as soon as it is returned.
+ */
+size_t cgc_spsc_queue_size (const cgc_spsc_queue * queue);
+
+/**
+ * \brief Get the capacity of the queue.
+ * \param queue Queue.
+ * \return capacity.
+ * \relatesalso cgc_spsc_queue
+ */
+size_t cgc_spsc_queue_capacity (const cgc_spsc_queue * queue);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Push to the back.
+ * \param[in,out] queue Queue
+ * \param[in] element Element.
+ * \relatesalso cgc_spsc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL, or if the queue is full. \c
+ * errno shall be set to \c EINVAL or \c EAGAIN respectively.
+ * \retval <=-3 if the copy function failed.
+ * \note The supplied element will be copied into the queue. It is safe to free
+ * \c element afterwards.
+ * \warning Only the producer thread may call this function.
+ */
+int cgc_spsc_queue_push (cgc_spsc_queue * queue, const void * element);
+
+/**
+ * \brief Push several elements to the back.
+ * \param[in,out] queue Queue
+ * \param[in] elements Array of \c n elements.
+ * \param[in] n Number of elements.
+ * \relatesalso cgc_spsc_queue
+ * \return The number of pushed elements, which is less than \c n if the queue
+ * is full or if the copy function failed.
+ * \note If \c queue or \c elements is \c NULL, \c errno shall be set to
+ * \c EINVAL.
+ * \warning Only the producer thread may call this function.
+ */
+size_t cgc_spsc_queue_push_n (cgc_spsc_queue * queue, const void * elements, size_t n);
+
+/**
+ * \brief Pop the front into a buffer.
+ * \param[in,out] queue Queue.
+ * \param[out] destination Buffer of at least the size of an element.
+ * \relatesalso cgc_spsc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL, or if the queue is empty.
+ * \c errno shall be set to \c EINVAL or \c EAGAIN respectively.
+ * \note The element is moved: it is up to the user to clean
+ * \c destination once unneeded.
+ * \warning Only the consumer thread may call this function.
+ */
+int cgc_spsc_queue_pop_into (cgc_spsc_queue * queue, void * destination);
+
+/**
+ * \brief Pop several elements from the front.
+ * \param[in,out] queue Queue.
+ * \param[out] destination Buffer of at least \c n elements.
+ * \param[in] n Maximal number of elements.
+ * \relatesalso cgc_spsc_queue
+ * \return The number of popped elements.
+ * \note If \c queue or \c destination is \c NULL, \c errno shall be set to
+ * \c EINVAL.
+ * \note The elements are moved: it is up to the user to clean them once
+ * unneeded.
+ * \warning Only the consumer thread may call this function.
+ */
+size_t cgc_spsc_queue_pop_n (cgc_spsc_queue * queue, void * destination, size_t n);
+
+/**
+ * \brief Clear a queue.
+ * \param[in,out] queue Queue.
+ * \relatesalso cgc_spsc_queue
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \warning Neither the producer nor the consumer may use the queue meanwhile.
+ */
+int cgc_spsc_queue_clear (cgc_spsc_queue * queue);
+
+#endif /* _CGC_SPSC_QUEUE_H_ */
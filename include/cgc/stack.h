@@ -27,13 +27,13 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <errno.h>
 #include <sysexits.h>
 #include <string.h>
 
 #include "cgc/common.h"
 #include "cgc/types.h"
-#include "cgc/list.h"
 
 /**
  * \defgroup stacks_group Stacks
@@ -48,32 +48,39 @@
  * \ingroup stacks_group
  * \brief CGC Stack.
  *
- * CGC Stacks are akin to CGC Lists, but allow less operations.
+ * CGC Stacks store their elements in a single contiguous array, which grows
+ * geometrically. Pushing or popping an element thus seldom involves the
+ * allocator: the memory is only reallocated when the array is full.
  *
- * CGC Stack function        | CGC List equivalent
- * --------------------------|-----------------------
- * cgc_stack_create()        | cgc_list_create()
- * cgc_stack_destroy()       | cgc_list_destroy()
- * cgc_stack_init()          | cgc_list_init()
- * cgc_stack_clean()         | cgc_list_clean()
- * cgc_stack_copy()          | cgc_list_copy()
- * cgc_stack_copy_into()     | cgc_list_copy_into()
- * cgc_stack_swap()          | cgc_list_swap()
- * cgc_stack_front()         | cgc_list_front()
- * cgc_stack_back()          | cgc_list_back()
- * cgc_stack_is_empty()      | cgc_list_is_empty()
- * cgc_stack_size()          | cgc_list_size()
- * cgc_stack_push()          | cgc_list_push_back()
- * cgc_stack_pop()           | cgc_list_pop_front()
- * cgc_stack_clear()         | cgc_list_clear()
+ * ## Capacity
+ * cgc_stack_reserve() makes room for a given number of elements at once.
+ * This is useful when an upper bound on the depth of the stack is known
+ * beforehand.
  *
- * \sa cgc_list
- */
-
-/**
- * \brief cgc_stack
+ * ## Popping
+ * cgc_stack_pop() returns the top element in a newly allocated memory area,
+ * which has to be freed by the user. cgc_stack_pop_into() moves it into a
+ * buffer supplied by the caller instead, and does not allocate anything.
+ *
+ * ## Batches
+ * cgc_stack_push_n() and cgc_stack_pop_n() move several elements at once:
+ * the array grows at most once, and when no copy function is used the
+ * elements are moved with a single \c memcpy. Both keep the elements in the
+ * order of the array, so that popping a batch gives back the batch which was
+ * pushed.
+ *
+ * \warning Pushing an element may move the array: pointers obtained via
+ * cgc_stack_top() are invalidated.
  */
-typedef cgc_list cgc_stack;
+typedef struct cgc_stack
+{
+    char * _content;                /**<- Content. */
+    size_t _size;                   /**<- Size. */
+    size_t _capacity;               /**<- Number of allocated elements. */
+    size_t _element_size;           /**<- Element size. */
+    cgc_copy_function _copy_fun;    /**<- Copy function. */
+    cgc_clean_function _clean_fun;  /**<- Clean function. */
+} cgc_stack;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Dynamic creation and destruction.
@@ -136,6 +143,22 @@ int cgc_stack_init (cgc_stack * stack, size_t element_size, cgc_copy_function co
  */
 int cgc_stack_clean (cgc_stack * stack);
 
+/**
+ * \brief Make room for at least \c capacity elements.
+ * \param[in,out] stack Stack.
+ * \param[in] capacity Number of elements.
+ * \relatesalso cgc_stack
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of realloc. \c errno may be set to
+ * \c ENOMEM.
+ * \note The capacity of a stack never shrinks, except with cgc_stack_clean().
+ */
+int cgc_stack_reserve (cgc_stack * stack, size_t capacity);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Copy.
 ////////////////////////////////////////////////////////////////////////////////
@@ -242,14 +265,63 @@ int cgc_stack_push (cgc_stack * stack, const void * element);
 /**
  * \brief Pop the top.
  * \param[in,out] stack Stack.
- * \return First element.
+ * \return Top element.
+ * \retval NULL if \c stack is \c NULL or empty, or if the element could not
+ * be allocated.
  * \relatesalso cgc_stack
  * \warning It is up to the user to free the returned element once unneeded.
- * \pre stack != NULL
- * \pre cgc_stack_is_empty(stack) == \c false
  */
 void * cgc_stack_pop (cgc_stack * stack);
 
+/**
+ * \brief Pop the top into a buffer.
+ * \param[in,out] stack Stack.
+ * \param[out] destination Buffer of at least the size of an element.
+ * \relatesalso cgc_stack
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL or if the stack is empty.
+ * \c errno shall be set to \c EINVAL.
+ * \note The element is moved: it is up to the user to clean
+ * \c destination once unneeded.
+ */
+int cgc_stack_pop_into (cgc_stack * stack, void * destination);
+
+/**
+ * \brief Push several elements.
+ * \param[in,out] stack Stack.
+ * \param[in] elements Contiguous array of \c count elements.
+ * \param[in] count Number of elements.
+ * \relatesalso cgc_stack
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of realloc, or if the size would
+ * overflow. \c errno shall be set to \c ENOMEM. No element is pushed.
+ * \retval <=-3 in case of failure because of the copy function. The elements
+ * preceding the failing one are pushed.
+ * \note The elements are pushed in the order of the array: the last one ends
+ * up on top.
+ */
+int cgc_stack_push_n (cgc_stack * stack, const void * elements, size_t count);
+
+/**
+ * \brief Pop several elements into a buffer.
+ * \param[in,out] stack Stack.
+ * \param[out] destination Buffer of at least \c max elements.
+ * \param[in] max Maximum number of elements to pop.
+ * \relatesalso cgc_stack
+ * \return Number of popped elements, 0 if one of the arguments is \c NULL.
+ * \note The popped elements keep their order in the stack: the former top
+ * element is the last one of \c destination.
+ * \note The elements are moved: it is up to the user to clean them once
+ * unneeded.
+ */
+size_t cgc_stack_pop_n (cgc_stack * stack, void * destination, size_t max);
+
 /**
  * \brief Clear a stack.
  * \param[in,out] stack Stack.
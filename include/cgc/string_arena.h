@@ -0,0 +1,180 @@
+/**
+ * \file string_arena.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_STRING_ARENA_H_
+#define _CGC_STRING_ARENA_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+
+#include "cgc/common.h"
+
+/**
+ * \defgroup strings_group Strings
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Block of a string arena.
+ * \ingroup strings_group
+ */
+typedef struct cgc_string_arena_block
+{
+    struct cgc_string_arena_block * _previous;  /**<- Previously filled block. */
+    size_t _size;                               /**<- Used bytes. */
+    size_t _capacity;                           /**<- Allocated bytes. */
+    char _content[];                            /**<- Bytes. */
+} cgc_string_arena_block;
+
+/**
+ * \class cgc_string_arena
+ * \ingroup strings_group
+ * \brief CGC String arena.
+ *
+ * CGC String arenas store strings back to back in large blocks, instead of
+ * allocating each of them separately. Storing a string is thus a mere copy
+ * most of the time, strings pushed one after the other lie next to each other
+ * in memory, and the whole arena is freed at once.
+ *
+ * ## Blocks
+ * A new block is allocated when the current one is full. Blocks never move:
+ * pointers returned by cgc_string_arena_store() remain valid until the arena
+ * is cleared or cleaned. Strings larger than a quarter of the block size get
+ * a block of their own, so that they do not waste the end of the current one.
+ *
+ * ## Lifetime
+ * Strings can not be freed one by one. cgc_string_arena_clear() forgets all
+ * of them and keeps a single block for reuse.
+ */
+typedef struct cgc_string_arena
+{
+    cgc_string_arena_block * _current;  /**<- Block being filled. */
+    size_t _block_size;                 /**<- Capacity of the regular blocks. */
+    size_t _size;                       /**<- Stored bytes. */
+} cgc_string_arena;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_string_arena.
+ * \param block_size Capacity of the blocks, 0 for a default of 64 KiB.
+ * \relatesalso cgc_string_arena
+ * \return The pointer to the new cgc_string_arena in case of success.
+ * \retval NULL if the arena could not be allocated.
+ * \note Arenas obtained this way must be freed using
+ * cgc_string_arena_destroy().
+ */
+cgc_string_arena * cgc_string_arena_create (size_t block_size);
+
+/**
+ * \brief Free a dynamically allocated cgc_string_arena.
+ * \param arena String arena.
+ * \relatesalso cgc_string_arena
+ * \note It is safe to pass a \c NULL to this function.
+ */
+void cgc_string_arena_destroy (cgc_string_arena * arena);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_string_arena.
+ * \param[in,out] arena String arena.
+ * \param[in] block_size Capacity of the blocks, 0 for a default of 64 KiB.
+ * \relatesalso cgc_string_arena
+ * \retval 0 in case of success.
+ * \retval -1 if \c arena is \c NULL. \c errno shall be set to \c EINVAL.
+ * \note No memory is allocated before the first string is stored.
+ */
+int cgc_string_arena_init (cgc_string_arena * arena, size_t block_size);
+
+/**
+ * \brief Clean a cgc_string_arena.
+ * \param[in,out] arena String arena.
+ * \relatesalso cgc_string_arena
+ * \retval 0 in case of success.
+ * \retval -1 if \c arena is \c NULL. \c errno shall be set to \c EINVAL.
+ * \note Every block is freed.
+ */
+int cgc_string_arena_clean (cgc_string_arena * arena);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the number of bytes stored in a cgc_string_arena.
+ * \param arena String arena.
+ * \return Number of bytes, terminating null characters included.
+ * \relatesalso cgc_string_arena
+ * \pre \c arena != \c NULL.
+ */
+size_t cgc_string_arena_size (const cgc_string_arena * arena);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Allocate room in a cgc_string_arena.
+ * \param[in,out] arena String arena.
+ * \param[in] size Number of bytes.
+ * \relatesalso cgc_string_arena
+ * \return A pointer to \c size bytes, or \c NULL in case of failure.
+ * \note The memory is not aligned: it is meant for characters.
+ */
+char * cgc_string_arena_allocate (cgc_string_arena * arena, size_t size);
+
+/**
+ * \brief Copy a string into a cgc_string_arena.
+ * \param[in,out] arena String arena.
+ * \param[in] data Characters.
+ * \param[in] length Number of characters.
+ * \relatesalso cgc_string_arena
+ * \return A pointer to the copy, or \c NULL in case of failure.
+ * \note A null character is appended to the copy. \c data may contain null
+ * characters: exactly \c length characters are copied.
+ */
+char * cgc_string_arena_store (cgc_string_arena * arena, const char * data, size_t length);
+
+/**
+ * \brief Forget every string of a cgc_string_arena.
+ * \param[in,out] arena String arena.
+ * \relatesalso cgc_string_arena
+ * \retval 0 in case of success.
+ * \retval -1 if \c arena is \c NULL. \c errno shall be set to \c EINVAL.
+ * \note The most recent regular block is kept for reuse, the others are freed.
+ */
+int cgc_string_arena_clear (cgc_string_arena * arena);
+
+#endif /* _CGC_STRING_ARENA_H_ */
@@ -0,0 +1,218 @@
+/**
+ * \file string_pool.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_STRING_POOL_H_
+#define _CGC_STRING_POOL_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/vector.h"
+#include "cgc/string_arena.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Slot of the hash table of a string pool.
+ * \ingroup strings_group
+ */
+typedef struct cgc_string_pool_slot
+{
+    uint32_t _id;       /**<- Id of the string plus one, 0 if the slot is free. */
+    uint32_t _hash;     /**<- Hash of the string. */
+} cgc_string_pool_slot;
+
+/**
+ * \class cgc_string_pool
+ * \ingroup strings_group
+ * \brief CGC String pool.
+ *
+ * CGC String pools intern strings: each distinct string is stored once, and
+ * interning it again yields the same canonical copy. Every string also gets
+ * a 32 bits id, counting from 0 in interning order, so that two interned
+ * strings are equal if and only if their ids are.
+ *
+ * ## Storage
+ * The canonical copies are stored back to back in a cgc_string_arena, and
+ * are followed by a null character. They never move: pointers obtained via
+ * cgc_string_pool_string() remain valid until the pool is cleared or
+ * destroyed.
+ *
+ * ## Lookup
+ * Strings are found through an open addressing hash table with linear
+ * probing. The hash function reads the strings eight bytes at a time, and
+ * each slot keeps the hash of its string next to the id: a probe only reads
+ * the string itself when the hashes match.
+ *
+ * Strings are sequences of bytes of a given length: they may contain null
+ * characters when interned via cgc_string_pool_intern_n().
+ */
+typedef struct cgc_string_pool
+{
+    cgc_string_pool_slot * _slots;  /**<- Hash table. */
+    size_t _capacity;               /**<- Number of slots, a power of two. */
+    cgc_vector _strings;            /**<- (pointer, length) of each id. */
+    cgc_string_arena _arena;        /**<- Characters. */
+} cgc_string_pool;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_string_pool.
+ * \relatesalso cgc_string_pool
+ * \return The pointer to the new cgc_string_pool in case of success.
+ * \retval NULL if the pool could not be allocated.
+ * \note Pools obtained this way must be freed using cgc_string_pool_destroy().
+ */
+cgc_string_pool * cgc_string_pool_create (void);
+
+/**
+ * \brief Free a dynamically allocated cgc_string_pool.
+ * \param pool String pool.
+ * \relatesalso cgc_string_pool
+ * \note It is safe to pass a \c NULL to this function.
+ */
+void cgc_string_pool_destroy (cgc_string_pool * pool);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_string_pool.
+ * \param[in,out] pool String pool.
+ * \relatesalso cgc_string_pool
+ * \retval 0 in case of success.
+ * \retval -1 if \c pool is \c NULL. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
+ */
+int cgc_string_pool_init (cgc_string_pool * pool);
+
+/**
+ * \brief Clean a cgc_string_pool.
+ * \param[in,out] pool String pool.
+ * \relatesalso cgc_string_pool
+ * \retval 0 in case of success.
+ * \retval -1 if \c pool is \c NULL. \c errno shall be set to \c EINVAL.
+ */
+int cgc_string_pool_clean (cgc_string_pool * pool);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the number of strings of a cgc_string_pool.
+ * \param pool String pool.
+ * \return Number of distinct strings, which is also the next id.
+ * \relatesalso cgc_string_pool
+ * \pre \c pool != \c NULL.
+ */
+size_t cgc_string_pool_size (const cgc_string_pool * pool);
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the canonical copy of a string.
+ * \param pool String pool.
+ * \param id Id of the string.
+ * \return A pointer to the null terminated canonical copy.
+ * \relatesalso cgc_string_pool
+ * \pre \c id < cgc_string_pool_size (pool).
+ */
+const char * cgc_string_pool_string (const cgc_string_pool * pool, uint32_t id);
+
+/**
+ * \brief Get the length of a string.
+ * \param pool String pool.
+ * \param id Id of the string.
+ * \return Number of characters of the string.
+ * \relatesalso cgc_string_pool
+ * \pre \c id < cgc_string_pool_size (pool).
+ */
+size_t cgc_string_pool_length (const cgc_string_pool * pool, uint32_t id);
+
+/**
+ * \brief Look a string up without interning it.
+ * \param[in] pool String pool.
+ * \param[in] data Characters.
+ * \param[in] length Number of characters.
+ * \param[out] id Id of the string if it is found, may be \c NULL.
+ * \relatesalso cgc_string_pool
+ * \retval true if the string is in the pool.
+ * \retval false otherwise, or if one of \c pool and \c data is \c NULL.
+ */
+bool cgc_string_pool_find (const cgc_string_pool * pool, const char * data, size_t length, uint32_t * id);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Intern a string given its length.
+ * \param[in,out] pool String pool.
+ * \param[in] data Characters.
+ * \param[in] length Number of characters.
+ * \param[out] id Id of the string, may be \c NULL.
+ * \relatesalso cgc_string_pool
+ * \retval 0 in case of success.
+ * \retval -1 if \c pool or \c data is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc, or if the pool already
+ * holds \c UINT32_MAX strings.
+ * \note The string is only copied if it was not in the pool yet.
+ */
+int cgc_string_pool_intern_n (cgc_string_pool * pool, const char * data, size_t length, uint32_t * id);
+
+/**
+ * \brief Intern a null terminated string.
+ * \param[in,out] pool String pool.
+ * \param[in] string String.
+ * \param[out] id Id of the string, may be \c NULL.
+ * \relatesalso cgc_string_pool
+ * \return See cgc_string_pool_intern_n().
+ */
+int cgc_string_pool_intern (cgc_string_pool * pool, const char * string, uint32_t * id);
+
+/**
+ * \brief Forget every string of a cgc_string_pool.
+ * \param[in,out] pool String pool.
+ * \relatesalso cgc_string_pool
+ * \retval 0 in case of success.
+ * \retval -1 if \c pool is \c NULL. \c errno shall be set to \c EINVAL.
+ * \note Ids are given out from 0 again.
+ */
+int cgc_string_pool_clear (cgc_string_pool * pool);
+
+#endif /* _CGC_STRING_POOL_H_ */
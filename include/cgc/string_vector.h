@@ -27,25 +27,128 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
 #include <string.h>
 
+#include "cgc/common.h"
 #include "cgc/vector.h"
+#include "cgc/string_arena.h"
+#include "cgc/string_pool.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Typedef.
 ////////////////////////////////////////////////////////////////////////////////
 
 /**
- * \class cgc_string_vector
- * \sa cgc_vector
- * cgc_string_vector is a specialized cgc_vector which stores strings. The
- * behaviour of cgc_string_vector is akin to the behaviour of cgc_vector.
+ * \brief Number of characters a string vector entry holds inline.
+ * \ingroup strings_group
+ *
+ * An entry is three words long, and its last two bytes hold the null
+ * character and the tag: 22 characters on LP64 targets, 10 on ILP32 ones.
  */
+#define CGC_STRING_VECTOR_INLINE_LENGTH (3 * sizeof (size_t) - 2)
+
 /**
- * \brief String vector.
+ * \brief Flag of cgc_string_vector_load_file(): null terminate the strings.
+ * \ingroup strings_group
+ */
+#define CGC_STRING_VECTOR_LOAD_TERMINATE 0x1
+
+/**
+ * \brief Flag of cgc_string_vector_load_file(): skip empty strings.
+ * \ingroup strings_group
+ */
+#define CGC_STRING_VECTOR_LOAD_SKIP_EMPTY 0x2
+
+/**
+ * \brief Entry of a string vector.
+ * \ingroup strings_group
+ *
+ * Entries are three words long. Short strings are stored inline, followed by a
+ * null character, and the last byte holds their length. Longer strings are
+ * referred to by a pointer and a length, and the last byte is set to
+ * \c UCHAR_MAX. Interned strings are referred to by a pointer to their
+ * canonical copy and their id in the pool, and the last byte is set to
+ * \c UCHAR_MAX - 1.
+ */
+typedef union cgc_string_vector_entry
+{
+    struct
+    {
+        const char * _data;     /**<- Characters. */
+        union
+        {
+            size_t _length;     /**<- Number of characters. */
+            uint32_t _id;       /**<- Id of an interned string. */
+        };
+        char _padding[sizeof (size_t) - 1];     /**<- Unused. */
+        unsigned char _tag;     /**<- \c UCHAR_MAX or \c UCHAR_MAX - 1. */
+    } _long;                    /**<- Long and interned strings. */
+    char _inline[CGC_STRING_VECTOR_INLINE_LENGTH + 2];  /**<- Short strings. */
+} cgc_string_vector_entry;
+
+/**
+ * \class cgc_string_vector
+ * \ingroup strings_group
  * \sa cgc_vector
+ * \brief String vector.
+ *
+ * cgc_string_vector is a vector of strings. The behaviour of
+ * cgc_string_vector is akin to the behaviour of cgc_vector.
+ *
+ * ## Memory layout
+ * The vector is a cgc_vector of three words entries. Strings of up to
+ * #CGC_STRING_VECTOR_INLINE_LENGTH characters are stored directly in their
+ * entry: they cost no allocation and no indirection, and scanning the vector
+ * reads them sequentially.
+ *
+ * Longer strings are copied into a cgc_string_arena owned by the vector:
+ * they are stored back to back in large blocks, rather than allocated one by
+ * one, and their entry holds a pointer and a length. Destroying the vector
+ * frees all of them at once.
+ *
+ * ## Lengths
+ * Every entry stores the length of its string, computed once when the string
+ * is pushed, and cgc_string_vector_length_at() returns it without scanning
+ * the string. Strings pushed via cgc_string_vector_push_back_n() and its
+ * siblings are taken as a pointer and a length: they need not be null
+ * terminated, and may contain null characters. Their length is then the only
+ * reliable way to know where they end.
+ *
+ * ## Lifetime of the strings
+ * Like pointers obtained via cgc_vector_at(), pointers obtained via
+ * cgc_string_vector_at() are invalidated by any modification of the vector:
+ * short strings move along with their entry. Popped and erased long strings
+ * leave their characters in the arena, which only gives its memory back when
+ * the vector is cleared or destroyed.
+ *
+ * ## Interned mode
+ * Vectors obtained via cgc_string_vector_create_interned() do not copy any
+ * string: every string is interned in a cgc_string_pool, and its entry only
+ * refers to the canonical copy and its id. Repeated strings are then stored
+ * once, pointers obtained via cgc_string_vector_at() remain valid as long as
+ * the pool does, and strings can be compared through their ids, obtained via
+ * cgc_string_vector_id_at().
+ *
+ * ## Loaded files
+ * Vectors obtained via cgc_string_vector_load_file() map the file into
+ * memory, and their entries refer to the strings where they lie in the
+ * mapping: loading a file copies no character. Unless the file was loaded
+ * with #CGC_STRING_VECTOR_LOAD_TERMINATE, these strings are \b not null
+ * terminated, and their length must be obtained via
+ * cgc_string_vector_length_at(). The mapping is released when the vector is
+ * cleared or destroyed.
  */
-typedef cgc_vector cgc_string_vector;
+typedef struct cgc_string_vector
+{
+    cgc_vector _entries;            /**<- Entries. */
+    cgc_string_arena _arena;        /**<- Characters. */
+    cgc_string_pool * _pool;        /**<- Pool of the interned mode, or \c NULL. */
+    void * _mapping;                /**<- Loaded file, or \c NULL. */
+    size_t _mapping_size;           /**<- Size of the loaded file. */
+} cgc_string_vector;
 
 ////////////////////////////////////////////////////////////////////////////////
 // New, free.
@@ -56,6 +159,8 @@ typedef cgc_vector cgc_string_vector;
  * \param size Vector size.
  * \relatesalso cgc_string_vector
  * \return pointer to a cgc_string_vector.
+ * \note \c size is used as the initial number of entries. Entries then grow
+ * geometrically.
  * \retval NULL if the vector could not be allocated.
  * \note Vectors obtained this way must be destroyed using
  * cgc_string_vector_destroy().
@@ -64,6 +169,39 @@ typedef cgc_vector cgc_string_vector;
  */
 cgc_string_vector * cgc_string_vector_create (size_t size);
 
+/**
+ * \brief Create a new cgc_string_vector that interns its strings.
+ * \param size Vector size.
+ * \param pool String pool.
+ * \relatesalso cgc_string_vector
+ * \return pointer to a cgc_string_vector.
+ * \retval NULL if the vector could not be allocated, or if \c pool is
+ * \c NULL.
+ * \note The vector does not own the pool, which must outlive it. Several
+ * vectors may share the same pool.
+ * \note Vectors obtained this way must be destroyed using
+ * cgc_string_vector_destroy().
+ */
+cgc_string_vector * cgc_string_vector_create_interned (size_t size, cgc_string_pool * pool);
+
+/**
+ * \brief Load a file of delimited strings into a new cgc_string_vector.
+ * \param path Path of the file.
+ * \param delimiter Character separating the strings, e.g. \c '\\n'.
+ * \param flags Bitwise or of \c CGC_STRING_VECTOR_LOAD_ flags, or 0.
+ * \relatesalso cgc_string_vector
+ * \return pointer to a cgc_string_vector.
+ * \retval NULL if the file could not be opened or mapped, or if the vector
+ * could not be allocated. \c errno is set accordingly.
+ * \note A delimiter at the end of the file does not start an empty string.
+ * \note With #CGC_STRING_VECTOR_LOAD_TERMINATE, the delimiters are replaced
+ * by null characters in a private copy of the pages holding them; the file
+ * itself is never modified.
+ * \note Vectors obtained this way must be destroyed using
+ * cgc_string_vector_destroy().
+ */
+cgc_string_vector * cgc_string_vector_load_file (const char * path, char delimiter, int flags);
+
 /**
  * \brief Free a cgc_string_vector.
  * \param vector Vector.
@@ -120,8 +258,23 @@ size_t cgc_string_vector_max_size (const cgc_string_vector * vector);
  * \warning This funciton does not check whether the supplied vector is valid!
  * \warning This function does not check whether the supplied vector is long
  * enough!
+ * \warning The element is not null terminated if the vector was loaded via
+ * cgc_string_vector_load_file() without #CGC_STRING_VECTOR_LOAD_TERMINATE.
+ */
+const char * cgc_string_vector_at (const cgc_string_vector * vector, size_t i);
+
+/**
+ * \brief Get the length of the element at index \c i.
+ * \param vector Vector.
+ * \param i Index.
+ * \return Number of characters of the element.
+ * \pre cgc_string_vector_size(\c vector) > \c i
+ * \relatesalso cgc_string_vector
+ * \pre \c vector != \c NULL
+ * \note Lengths are stored in the vector: this function does not scan the
+ * string.
  */
-char * cgc_string_vector_at (const cgc_string_vector * vector, size_t i);
+size_t cgc_string_vector_length_at (const cgc_string_vector * vector, size_t i);
 
 /**
  * \brief Get the first element.
@@ -134,7 +287,7 @@ char * cgc_string_vector_at (const cgc_string_vector * vector, size_t i);
  * \warning This function does not check whether the supplied vector is long
  * enough!
  */
-char * cgc_string_vector_front (const cgc_string_vector * vector);
+const char * cgc_string_vector_front (const cgc_string_vector * vector);
 
 /**
  * \brief Get the last element.
@@ -147,7 +300,18 @@ char * cgc_string_vector_front (const cgc_string_vector * vector);
  * \warning This function does not check whether the supplied vector is long
  * enough!
  */
-char * cgc_string_vector_back (const cgc_string_vector * vector);
+const char * cgc_string_vector_back (const cgc_string_vector * vector);
+
+/**
+ * \brief Get the id of the element at index \c i.
+ * \param vector Vector.
+ * \param i Index.
+ * \return Id of the element in the pool of the vector.
+ * \pre cgc_string_vector_size(\c vector) > \c i
+ * \pre The vector was obtained via cgc_string_vector_create_interned().
+ * \relatesalso cgc_string_vector
+ */
+uint32_t cgc_string_vector_id_at (const cgc_string_vector * vector, size_t i);
 
 ////////////////////////////////////////////////////////////////////////////////
 // Modifiers.
@@ -161,6 +325,7 @@ char * cgc_string_vector_back (const cgc_string_vector * vector);
  * \retval 0 in case of success
  * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
  * \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
  * \note The supplied string will be copied into the list. It iis safe to modify
  * the string afterwards.
  */
@@ -174,6 +339,7 @@ int cgc_string_vector_push_front (cgc_string_vector * vector, const char * strin
  * \retval 0 in case of success
  * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
  * \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
  * \note The supplied string will be copied into the list. It iis safe to modify
  * the string afterwards.
  */
@@ -188,16 +354,66 @@ int cgc_string_vector_push_back (cgc_string_vector * vector, const char * string
  * \retval 0 in case of success
  * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
  * \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
  * \note The supplied string will be copied into the list. It iis safe to modify
  * the string afterwards.
  */
 int cgc_string_vector_insert (cgc_string_vector * vector, size_t i, const char * string);
 
+/**
+ * \brief Push front a string given its length.
+ * \param vector Vector.
+ * \param data Characters.
+ * \param length Number of characters.
+ * \relatesalso cgc_string_vector
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
+ * \note \c data needs not be null terminated, and may contain null
+ * characters. The vector stores a null terminated copy.
+ */
+int cgc_string_vector_push_front_n (cgc_string_vector * vector, const char * data, size_t length);
+
+/**
+ * \brief Push back a string given its length.
+ * \param vector Vector.
+ * \param data Characters.
+ * \param length Number of characters.
+ * \relatesalso cgc_string_vector
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
+ * \note \c data needs not be null terminated, and may contain null
+ * characters. The vector stores a null terminated copy.
+ */
+int cgc_string_vector_push_back_n (cgc_string_vector * vector, const char * data, size_t length);
+
+/**
+ * \brief Insert a string given its length at index \c i.
+ * \param vector Vector.
+ * \param i Index.
+ * \param data Characters.
+ * \param length Number of characters.
+ * \relatesalso cgc_string_vector
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
+ * \note \c data needs not be null terminated, and may contain null
+ * characters. The vector stores a null terminated copy.
+ */
+int cgc_string_vector_insert_n (cgc_string_vector * vector, size_t i, const char * data, size_t length);
+
 /**
  * \brief Pop front an element.
  * \param vector Vector.
  * \return element
  * \relatesalso cgc_vector
+ * \note The returned string is a copy, which shall be freed by the user.
+ * \note The copy is null terminated. The length of strings holding null
+ * characters shall be obtained via cgc_string_vector_length_at() beforehand.
  */
 char * cgc_string_vector_pop_front (cgc_string_vector * vector);
 
@@ -206,6 +422,9 @@ char * cgc_string_vector_pop_front (cgc_string_vector * vector);
  * \param vector Vector.
  * \return element
  * \relatesalso cgc_string_vector
+ * \note The returned string is a copy, which shall be freed by the user.
+ * \note The copy is null terminated. The length of strings holding null
+ * characters shall be obtained via cgc_string_vector_length_at() beforehand.
  */
 char * cgc_string_vector_pop_back (cgc_string_vector * vector);
 
@@ -215,6 +434,7 @@ char * cgc_string_vector_pop_back (cgc_string_vector * vector);
  * \relatesalso cgc_string_vector
  * \return 0 in case of success.
  * \return -1 if \c vector is \c NULL. \c errno shall be set to \c EINVAL.
+ * \note The memory of every string is released at once.
  */
 int cgc_string_vector_clear (cgc_string_vector * vector);
 
@@ -229,4 +449,39 @@ int cgc_string_vector_clear (cgc_string_vector * vector);
  */
 int cgc_string_vector_erase (cgc_string_vector * vector, size_t start, size_t end);
 
+////////////////////////////////////////////////////////////////////////////////
+// Sorting.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Sort a vector in lexicographic order.
+ * \param vector Vector.
+ * \relatesalso cgc_string_vector
+ * \retval 0 in case of success.
+ * \retval -1 if \c vector is \c NULL. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
+ * \note Strings are compared byte by byte as \c unsigned \c char, like
+ * memcmp(), and a string is lower than the strings it is a prefix of.
+ * \note The sort is a multikey quicksort: it compares eight characters at a
+ * time, and never compares the common prefix of two strings twice. It is not
+ * stable.
+ * \note The strings are sorted through an array of (pointer, length, prefix,
+ * index) items, so that comparisons neither decode entries nor chase pointers
+ * until eight equal characters were found: this costs 32 bytes of additional
+ * memory per string on LP64 targets. The entries are then permuted in place.
+ */
+int cgc_string_vector_sort (cgc_string_vector * vector);
+
+/**
+ * \brief Remove consecutive duplicates.
+ * \param vector Vector.
+ * \relatesalso cgc_string_vector
+ * \retval 0 in case of success.
+ * \retval -1 if \c vector is \c NULL. \c errno shall be set to \c EINVAL.
+ * \note Only the first of each run of equal strings is kept: on a sorted
+ * vector, every string is then unique.
+ * \note Interned strings are compared through their ids.
+ */
+int cgc_string_vector_unique (cgc_string_vector * vector);
+
 #endif /* _CGC_STRING_VECTOR_H_ */
@@ -0,0 +1,327 @@
+/**
+ * \file timer_wheel.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_TIMER_WHEEL_H_
+#define _CGC_TIMER_WHEEL_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+
+/**
+ * \defgroup timers_group Timers
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of levels of a timer wheel.
+ * \ingroup timers_group
+ *
+ * The levels cover the whole range of 64 bits ticks.
+ */
+#define CGC_TIMER_WHEEL_LEVELS 8
+
+/**
+ * \brief Number of slots per level, as a power of two.
+ * \ingroup timers_group
+ */
+#define CGC_TIMER_WHEEL_SLOT_BITS 8
+
+/**
+ * \brief Number of slots per level.
+ * \ingroup timers_group
+ */
+#define CGC_TIMER_WHEEL_SLOTS (1 << CGC_TIMER_WHEEL_SLOT_BITS)
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Links of a timer wheel bucket.
+ * \ingroup timers_group
+ *
+ * Buckets are circular doubly linked lists, like the elements of a cgc_list,
+ * whose sentinel is a bare pair of links.
+ */
+typedef struct cgc_timer_wheel_link
+{
+    struct cgc_timer_wheel_link * _next;        /**<- Next link. */
+    struct cgc_timer_wheel_link * _previous;    /**<- Previous link. */
+} cgc_timer_wheel_link;
+
+/**
+ * \brief Timer of a timer wheel.
+ * \ingroup timers_group
+ *
+ * Timers are handed out by cgc_timer_wheel_schedule(), and may be passed to
+ * cgc_timer_wheel_cancel() or cgc_timer_wheel_reschedule() as long as they
+ * have not expired. The element of the timer is stored right after this
+ * header, in the same allocation.
+ *
+ * \warning Timers are recycled: a timer which expired or was cancelled shall
+ * not be used anymore.
+ */
+typedef struct cgc_timer_wheel_timer
+{
+    cgc_timer_wheel_link _link;     /**<- Bucket links. */
+    uint64_t _deadline;             /**<- Expiry tick. */
+    size_t _bucket;                 /**<- Index of the bucket. */
+} cgc_timer_wheel_timer;
+
+/**
+ * \class cgc_timer_wheel
+ * \ingroup timers_group
+ * \brief CGC Timer wheel.
+ *
+ * CGC Timer wheels hold elements which expire at a given tick. They are
+ * hierarchical timing wheels: #CGC_TIMER_WHEEL_LEVELS levels of
+ * #CGC_TIMER_WHEEL_SLOTS buckets each, every level covering a range of ticks
+ * #CGC_TIMER_WHEEL_SLOTS times larger than the previous one.
+ *
+ * Operation                       | Complexity
+ * --------------------------------|---------------------------------------
+ * cgc_timer_wheel_schedule()      | O(1)
+ * cgc_timer_wheel_cancel()        | O(1)
+ * cgc_timer_wheel_reschedule()    | O(1)
+ * cgc_timer_wheel_advance()       | O(1) amortized per tick and per timer
+ *
+ * ## Time
+ * Ticks are unsigned 64 bits integers, whose unit is up to the user.
+ * cgc_timer_wheel_advance() moves the wheel forward and calls a function on
+ * the element of every timer whose deadline has been reached, in deadline
+ * order. A timer sits in the level matching the distance to its deadline, and
+ * is moved down one or more levels whenever the wheel reaches the range its
+ * bucket covers: it is moved at most #CGC_TIMER_WHEEL_LEVELS - 1 times.
+ *
+ * Ticks in which no bucket is due are skipped using per-level occupancy
+ * bitmaps, so that advancing an idle wheel by a long period is cheap.
+ *
+ * ## Elements
+ * Elements are copied into the timer using the copy function, and cleaned
+ * after they expired or when they are cancelled (see #cgc_copy_function and
+ * #cgc_clean_function). Expired and cancelled timers are kept for reuse
+ * instead of being freed, so that a steady flow of timeouts does not involve
+ * the allocator.
+ */
+typedef struct cgc_timer_wheel
+{
+    cgc_timer_wheel_link _buckets[CGC_TIMER_WHEEL_LEVELS * CGC_TIMER_WHEEL_SLOTS];  /**<- Buckets. */
+    uint64_t _occupied[CGC_TIMER_WHEEL_LEVELS][CGC_TIMER_WHEEL_SLOTS / 64];         /**<- Non-empty buckets. */
+    cgc_timer_wheel_timer * _free;      /**<- Timers kept for reuse. */
+    uint64_t _now;                      /**<- Current tick. */
+    size_t _size;                       /**<- Number of pending timers. */
+    size_t _element_size;               /**<- Element size. */
+    size_t _content_offset;             /**<- Offset of the element in a timer. */
+    cgc_copy_function _copy_fun;        /**<- Copy function. */
+    cgc_clean_function _clean_fun;      /**<- Clean function. */
+} cgc_timer_wheel;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_timer_wheel.
+ * \param element_size Element size.
+ * \param copy_fun Copy function.
+ * \param clean_fun Cleaning function.
+ * \param now Initial tick.
+ * \relatesalso cgc_timer_wheel
+ * \return The pointer to the new cgc_timer_wheel in case of success.
+ * \retval NULL if the wheel could not be allocated.
+ * \note Wheels obtained this way must be freed using cgc_timer_wheel_destroy().
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_timer_wheel * cgc_timer_wheel_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, uint64_t now);
+
+/**
+ * \brief Free a dynamically allocated cgc_timer_wheel.
+ * \param wheel Timer wheel.
+ * \relatesalso cgc_timer_wheel
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only on wheels obtained
+ * via cgc_timer_wheel_create().
+ */
+void cgc_timer_wheel_destroy (cgc_timer_wheel * wheel);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_timer_wheel.
+ * \param[in,out] wheel Timer wheel.
+ * \param[in] element_size Element size.
+ * \param[in] copy_fun Copy function.
+ * \param[in] clean_fun Cleaning function.
+ * \param[in] now Initial tick.
+ * \relatesalso cgc_timer_wheel
+ * \retval 0 in case of success.
+ * \retval -1 if \c wheel is \c NULL. \c errno shall be set to \c EINVAL.
+ */
+int cgc_timer_wheel_init (cgc_timer_wheel * wheel, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, uint64_t now);
+
+/**
+ * \brief Clean a cgc_timer_wheel.
+ * \param[in,out] wheel Timer wheel.
+ * \relatesalso cgc_timer_wheel
+ * \retval 0 in case of success.
+ * \retval -1 if \c wheel is \c NULL. \c errno shall be set to \c EINVAL.
+ * \note Pending timers are cancelled, and the timers kept for reuse are freed.
+ */
+int cgc_timer_wheel_clean (cgc_timer_wheel * wheel);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a cgc_timer_wheel has no pending timer.
+ * \param wheel Timer wheel.
+ * \retval true if the wheel is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_timer_wheel
+ * \pre \c wheel != \c NULL.
+ */
+bool cgc_timer_wheel_is_empty (const cgc_timer_wheel * wheel);
+
+/**
+ * \brief Get the number of pending timers of a cgc_timer_wheel.
+ * \param wheel Timer wheel.
+ * \return Number of pending timers.
+ * \relatesalso cgc_timer_wheel
+ * \pre \c wheel != \c NULL.
+ */
+size_t cgc_timer_wheel_size (const cgc_timer_wheel * wheel);
+
+/**
+ * \brief Get the current tick of a cgc_timer_wheel.
+ * \param wheel Timer wheel.
+ * \return The tick the wheel was last advanced to.
+ * \relatesalso cgc_timer_wheel
+ * \pre \c wheel != \c NULL.
+ */
+uint64_t cgc_timer_wheel_now (const cgc_timer_wheel * wheel);
+
+////////////////////////////////////////////////////////////////////////////////
+// Timers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the element of a timer.
+ * \param wheel Timer wheel.
+ * \param timer Pending timer.
+ * \return A pointer to the element of the timer.
+ * \relatesalso cgc_timer_wheel
+ */
+void * cgc_timer_wheel_content (const cgc_timer_wheel * wheel, cgc_timer_wheel_timer * timer);
+
+/**
+ * \brief Get the deadline of a timer.
+ * \param timer Pending timer.
+ * \return The tick at which the timer expires.
+ * \relatesalso cgc_timer_wheel
+ */
+uint64_t cgc_timer_wheel_deadline (const cgc_timer_wheel_timer * timer);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Schedule an element.
+ * \param[in,out] wheel Timer wheel.
+ * \param[in] deadline Tick at which the element expires.
+ * \param[in] element Element.
+ * \param[out] timer Handle on the new timer, may be \c NULL.
+ * \relatesalso cgc_timer_wheel
+ * \retval 0 in case of success.
+ * \retval -1 if \c wheel or \c element is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of \c malloc.
+ * \retval <=-3 in case of failure because of the copy function.
+ * \note A deadline which is already reached expires at the next tick.
+ */
+int cgc_timer_wheel_schedule (cgc_timer_wheel * wheel, uint64_t deadline, const void * element, cgc_timer_wheel_timer ** timer);
+
+/**
+ * \brief Change the deadline of a pending timer.
+ * \param[in,out] wheel Timer wheel.
+ * \param[in,out] timer Pending timer.
+ * \param[in] deadline New deadline.
+ * \relatesalso cgc_timer_wheel
+ * \retval 0 in case of success.
+ * \retval -1 if \c wheel or \c timer is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ */
+int cgc_timer_wheel_reschedule (cgc_timer_wheel * wheel, cgc_timer_wheel_timer * timer, uint64_t deadline);
+
+/**
+ * \brief Cancel a pending timer.
+ * \param[in,out] wheel Timer wheel.
+ * \param[in,out] timer Pending timer.
+ * \relatesalso cgc_timer_wheel
+ * \retval 0 in case of success.
+ * \retval -1 if \c wheel or \c timer is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \note The element of the timer is cleaned.
+ */
+int cgc_timer_wheel_cancel (cgc_timer_wheel * wheel, cgc_timer_wheel_timer * timer);
+
+/**
+ * \brief Move a cgc_timer_wheel forward and expire the due timers.
+ * \param[in,out] wheel Timer wheel.
+ * \param[in] now New current tick.
+ * \param[in] op_fun Function called on the element of every expired timer,
+ * may be \c NULL.
+ * \relatesalso cgc_timer_wheel
+ * \return Number of expired timers.
+ * \note The return value of \c op_fun is ignored. The element is cleaned once
+ * \c op_fun returns.
+ * \note \c op_fun may schedule or cancel other timers. The timer being expired
+ * is no longer pending while \c op_fun runs.
+ * \note Nothing happens if \c now is not after the current tick.
+ */
+size_t cgc_timer_wheel_advance (cgc_timer_wheel * wheel, uint64_t now, cgc_unary_op_function op_fun);
+
+/**
+ * \brief Cancel every pending timer of a cgc_timer_wheel.
+ * \param[in,out] wheel Timer wheel.
+ * \relatesalso cgc_timer_wheel
+ * \retval 0 in case of success.
+ * \retval -1 if \c wheel is \c NULL. \c errno shall be set to \c EINVAL.
+ */
+int cgc_timer_wheel_clear (cgc_timer_wheel * wheel);
+
+#endif /* _CGC_TIMER_WHEEL_H_ */
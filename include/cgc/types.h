@@ -158,5 +158,28 @@ typedef int (* cgc_binary_op_right_function) (const void *, void *);
  */
 typedef int (* cgc_binary_op_left_function) (void *, const void *);
 
+/**
+ * \brief Comparison functions.
+ * \ingroup cgc_types_group
+ *
+ * # Prototype and behaviour
+ * A comparison function must have the following prototype:
+ *
+ *     int compare_function (const void *, const void *);
+ *
+ * Like the comparison functions expected by the standard library's \c qsort,
+ * it shall return a negative integer if the first element is lower than the
+ * second one, 0 if they are equal, and a positive integer otherwise.
+ *
+ * # Simple example
+ *
+ *     int int_compare (const void * a, const void * b)
+ *     {
+ *         const int * const x = a;
+ *         const int * const y = b;
+ *         return (* x > * y) - (* x < * y);
+ *     }
+ */
+typedef int (* cgc_compare_function) (const void *, const void *);
 
 #endif /* _CGC_TYPES_H_ */
@@ -0,0 +1,422 @@
+/**
+ * \file unrolled_list.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_UNROLLED_LIST_H_
+#define _CGC_UNROLLED_LIST_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <sysexits.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+
+/**
+ * \defgroup cgc_unrolled_list_group CGC Unrolled Lists
+ * \ingroup lists_group
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief CGC Unrolled list node.
+ * \ingroup cgc_unrolled_list_group
+ *
+ * Unrolled list nodes are used internally to store the elements of unrolled
+ * lists. A node stores up to \c _node_capacity contiguous elements (see
+ * cgc_unrolled_list) and is linked to its predecessor and its successor.
+ */
+typedef struct cgc_unrolled_list_node
+{
+    struct cgc_unrolled_list_node * _next;      /**< Next node. */
+    struct cgc_unrolled_list_node * _previous;  /**< Previous node. */
+    size_t _count;                              /**< Number of elements. */
+    char _content[];                            /**< Elements. */
+} cgc_unrolled_list_node;
+
+/**
+ * \brief CGC Unrolled list.
+ * \ingroup cgc_unrolled_list_group
+ *
+ * CGC Unrolled lists are generic doubly linked lists whose nodes hold several
+ * contiguous elements instead of a single one. They offer the same operations
+ * as cgc_list, with the same semantics.
+ *
+ * # Basics
+ * Like CGC Lists, CGC Unrolled lists rely on the size in bytes of the elements,
+ * a copy function and a cleaning function. See cgc_list for details.
+ *
+ * # Layout
+ * The capacity of the nodes is computed at the initialization of the list so
+ * that the elements of a node span a few cache lines. Scanning the list
+ * (cgc_unrolled_list_map(), the folds, cgc_unrolled_list_at()) thus mostly
+ * touches contiguous memory, while insertions and deletions only shift the
+ * elements of a single node.
+ *
+ * When an insertion targets a full node, the node is split in two halves.
+ * When a deletion leaves a node less than half full, it is merged with its
+ * successor whenever both fit in a single node.
+ *
+ * # Element access
+ * cgc_unrolled_list_at(), cgc_unrolled_list_front() and
+ * cgc_unrolled_list_back() return pointers to elements stored inside the list.
+ * Since elements are moved around by insertions and deletions, such pointers
+ * must not be kept across modifications of the list.
+ *
+ * cgc_unrolled_list_pop_front() and cgc_unrolled_list_pop_back() return a
+ * copy of the removed element. \b Important: such copies shall be freed by
+ * the user.
+ *
+ * \sa cgc_list
+ */
+typedef struct cgc_unrolled_list
+{
+    cgc_unrolled_list_node * _first;    /**< First node. */
+    cgc_unrolled_list_node * _last;     /**< Last node. */
+    cgc_clean_function _clean_fun;      /**< Clean function. */
+    cgc_copy_function _copy_fun;        /**< Copy function. */
+    size_t _size;                       /**< Size. */
+    size_t _element_size;               /**< Element size. */
+    size_t _node_capacity;              /**< Elements per node. */
+} cgc_unrolled_list;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_unrolled_list.
+ * \param element_size Element size.
+ * \param copy_fun Copy function.
+ * \param clean_fun Cleaning function.
+ * \relatesalso cgc_unrolled_list
+ * \return The pointer to the new cgc_unrolled_list in case of success. \c NULL
+ * in case of failure.
+ * \retval NULL if the list could not be allocated.
+ * \note Lists obtained this way must be freed using cgc_unrolled_list_destroy().
+ * \note In case of failure, \c errno may be set to \c ENOMEM.
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_unrolled_list * cgc_unrolled_list_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun);
+
+/**
+ * \brief Free a dynamically allocated cgc_unrolled_list.
+ * \param list List.
+ * \relatesalso cgc_unrolled_list
+ * \note A call to this function may change the value of \c errno.
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only of lists obtained
+ * via cgc_unrolled_list_create().
+ */
+void cgc_unrolled_list_destroy (cgc_unrolled_list * list);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_unrolled_list.
+ * \param[in,out] list List.
+ * \param[in] element_size Element size
+ * \param[in] copy_fun Copy function.
+ * \param[in] clean_fun Cleaning function.
+ * \relatesalso cgc_unrolled_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ */
+int cgc_unrolled_list_init (cgc_unrolled_list * list, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun);
+
+/**
+ * \brief Clean a cgc_unrolled_list.
+ * \param[in,out] list List.
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \relatesalso cgc_unrolled_list
+ */
+int cgc_unrolled_list_clean (cgc_unrolled_list * list);
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Copy a list.
+ * \param list List.
+ * \return A pointer to the copy in case of success. \c NULL in case of failure.
+ * \relatesalso cgc_unrolled_list
+ * \note It is safe to pass a \c NULL to this function.
+ * \retval NULL if the list could not be copied or \c list was \c NULL.
+ * \note Lists obtained this way must be freed using cgc_unrolled_list_destroy().
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_unrolled_list * cgc_unrolled_list_copy (const cgc_unrolled_list * list);
+
+/**
+ * \brief Copy a cgc_unrolled_list into \c destination.
+ * \param[in] original The original.
+ * \param[in,out] destination The destination of the copy.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno may be set to \c EINVAL.
+ * \relatesalso cgc_unrolled_list
+ * \warning This function will overwrite the destination! It is up to the user to
+ * first clean \c destination if needed.
+ */
+int cgc_unrolled_list_copy_into (const cgc_unrolled_list * original, cgc_unrolled_list * destination);
+
+////////////////////////////////////////////////////////////////////////////////
+// Swap.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Swap the contents of two lists.
+ * \param[in,out] a First list.
+ * \param[in,out] b Second list.
+ * \relatesalso cgc_unrolled_list
+ * \pre a != NULL && b != NULL
+ * \return 0 in case of success.
+ * \return -1 if at least of the argumes is \c NULL. \c errno may be set to
+ * \c EINVAL.
+ * \note A cal to this function may change the value of \c errno.
+ */
+int cgc_unrolled_list_swap (cgc_unrolled_list * a, cgc_unrolled_list * b);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Check whether a CGC unrolled list is empty.
+ * \param list List.
+ * \retval true if the list is empty.
+ * \retval false otherwise.
+ * \relatesalso cgc_unrolled_list
+ */
+bool cgc_unrolled_list_is_empty (const cgc_unrolled_list * list);
+
+/**
+ * \brief Get the size of the list.
+ * \param list List.
+ * \return size.
+ * \relatesalso cgc_unrolled_list
+ */
+size_t cgc_unrolled_list_size (const cgc_unrolled_list * list);
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the element at index \c i.
+ * \param list List.
+ * \param i Index.
+ * \return element.
+ * \relatesalso cgc_unrolled_list
+ * \pre cgc_unrolled_list_size(list) > \c i
+ * \pre list != NULL
+ * \warning This function does not check whether the supplied list is valid!
+ * \warning This function does not check whether the supplied list is long enough!
+ */
+void * cgc_unrolled_list_at (const cgc_unrolled_list * list, size_t i);
+
+/**
+ * \brief Get the front of the list.
+ * \param list List.
+ * \return Front.
+ * \relatesalso cgc_unrolled_list
+ * \pre cgc_unrolled_list_is_empty(list) == \c false
+ * \pre list != NULL
+ * \warning This function does not check whether the supplied list is valid!
+ * \warning This function does not check whether the supplied list is long enough!
+ */
+void * cgc_unrolled_list_front (const cgc_unrolled_list * list);
+
+/**
+ * \brief Get the back of the list.
+ * \param list List.
+ * \return Back.
+ * \relatesalso cgc_unrolled_list
+ * \pre cgc_unrolled_list_is_empty(list) == \c false
+ * \pre list != NULL
+ * \warning This function does not check whether the supplied list is valid!
+ * \warning This function does not check whether the supplied list is long enough!
+ */
+void * cgc_unrolled_list_back (const cgc_unrolled_list * list);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Push to the front.
+ * \param[in,out] list List
+ * \param[in] element Element.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the the function failed because memory allocation failed. \c
+ * errno may be set to \c ENOMEM.
+ * \relatesalso cgc_unrolled_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \note The supplied element will be copied into the list. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_unrolled_list_push_front (cgc_unrolled_list * list, const void * element);
+
+/**
+ * \brief Push to the back.
+ * \param[in,out] list List
+ * \param[in] element Element.
+ * \retval 0 in case of success
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the the function failed because memory allocation failed. \c
+ * errno may be set to \c ENOMEM.
+ * \relatesalso cgc_unrolled_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \note The supplied element will be copied into the list. It is safe to free
+ * \c element afterwards.
+ */
+int cgc_unrolled_list_push_back (cgc_unrolled_list * list, const void * element);
+
+/**
+ * \brief Pop the front.
+ * \param[in,out] list List.
+ * \return A copy of the first element. \c NULL in case of failure.
+ * \relatesalso cgc_unrolled_list
+ * \warning It is up to the user to free the returned element once unneeded.
+ * \pre list != NULL
+ * \pre cgc_unrolled_list_is_empty(list) == \c false
+ */
+void * cgc_unrolled_list_pop_front (cgc_unrolled_list * list);
+
+/**
+ * \brief Pop the back.
+ * \param[in,out] list List.
+ * \return A copy of the last element. \c NULL in case of failure.
+ * \relatesalso cgc_unrolled_list
+ * \warning It is up to the user to free the returned element once unneeded.
+ * \pre list != NULL
+ * \pre cgc_unrolled_list_is_empty(list) == \c false
+ */
+void * cgc_unrolled_list_pop_back (cgc_unrolled_list * list);
+
+/**
+ * \brief Insert an element a the Ith place in a list.
+ * \param[in,out] list List.
+ * \param[in] i Target index.
+ * \param[in] element Element.
+ * \relatesalso cgc_unrolled_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the function failed because memory allocation failed. \c errno
+ * may be set to \c ENOMEM.
+ * \note If \c i is greater than the size of the list, the \c element will be
+ * inserted at the end of the list.
+ * \note The supplied element will be copied into the list. It is safe to free
+ * \c element afterwards, if it was malloc'd.
+ */
+int cgc_unrolled_list_insert (cgc_unrolled_list * list, size_t i, const void * element);
+
+/**
+ * \brief Clear a list.
+ * \param[in,out] list List.
+ * \relatesalso cgc_unrolled_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ */
+int cgc_unrolled_list_clear (cgc_unrolled_list * list);
+
+/**
+ * \brief Erase elements from start to end excluded from a list.
+ * \param[in,out] list List.
+ * \param[in] start First element to remove.
+ * \param[in] end Element after the last element to remove.
+ * \relatesalso cgc_unrolled_list
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is invalid: either if list is \c NULL, if
+ * \c start > cgc_unrolled_list_size(list) or if \c end < \c start. \c errno
+ * shall be set to \c EINVAL.
+ * \pre cgc_unrolled_list_size(\c list) > \c start
+ * \pre \c start < \c end
+ * \pre \c list != \c NULL
+ */
+int cgc_unrolled_list_erase (cgc_unrolled_list * list, size_t start, size_t end);
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions on lists.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Map.
+ * \param[in,out] list List
+ * \param[in] op_fun Operation.
+ * \relatesalso cgc_unrolled_list
+ * \note The list will be modified. First copy the list if the original must
+ * be kept.
+ */
+void cgc_unrolled_list_map (cgc_unrolled_list * list, cgc_unary_op_function op_fun);
+
+/**
+ * \brief Fold left.
+ * \param[in] list List.
+ * \param[in] op_fun Binary operation.
+ * \param[in,out] base_result Initial value and result.
+ * \relatesalso cgc_unrolled_list
+ * \note \c base_result must hold the initial value before the call to this
+ * function but will be modified to hold the result.
+ */
+void cgc_unrolled_list_fold_left (const cgc_unrolled_list * list, cgc_binary_op_left_function op_fun, void * base_result);
+
+/**
+ * \brief Fold right.
+ * \param[in] list List.
+ * \param[in] op_fun Binary operation.
+ * \param[in,out] base_result Initial value and result.
+ * \relatesalso cgc_unrolled_list
+ * \note \c base_result must hold the initial value before the call to this
+ * function but will be modified to hold the result.
+ */
+void cgc_unrolled_list_fold_right (const cgc_unrolled_list * list, cgc_binary_op_right_function op_fun, void * base_result);
+
+#endif /* _CGC_UNROLLED_LIST_H_ */
@@ -27,6 +27,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <errno.h>
 
@@ -134,6 +135,9 @@
  * cgc_vector_push_back()     | As the last element
  * cgc_vector_insert()        | Before the Nth element
  *
+ * cgc_vector_reserve() may be used beforehand to allocate room for many
+ * insertions at once.
+ *
  * Note that insertions anywhere else than the back imply shifting the remainder
  * of the vector. If such insertions are to be used numerous times, consider
  * using cgc_list instead of cgc_vector.
@@ -290,6 +294,18 @@ size_t cgc_vector_size (const cgc_vector * vector);
  */
 size_t cgc_vector_max_size (const cgc_vector * vector);
 
+/**
+ * \brief Check whether two vectors hold the same kind of elements.
+ * \param a First vector.
+ * \param b Second vector.
+ * \retval true if both vectors have the same element size, copy function and
+ * cleaning function.
+ * \retval false otherwise.
+ * \relatesalso cgc_vector
+ * \pre \c a != \c NULL && \c b != \c NULL
+ */
+bool cgc_vector_is_compatible (const cgc_vector * a, const cgc_vector * b);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Access.
 ////////////////////////////////////////////////////////////////////////////////
@@ -426,4 +442,19 @@ int cgc_vector_clear (cgc_vector * vector);
  */
 int cgc_vector_erase (cgc_vector * vector, size_t start, size_t end);
 
+/**
+ * \brief Make room for at least \c max_size elements.
+ * \param[in,out] vector Vector.
+ * \param[in] max_size Requested maximum size.
+ * \relatesalso cgc_vector
+ * \retval 0 in case of success.
+ * \retval -1 if \c vector is \c NULL. \c errno shall be set to \c EINVAL.
+ * \retval -2 in case of failure because of \c realloc. The vector is left
+ * untouched.
+ * \note The vector never shrinks: requesting less than cgc_vector_max_size()
+ * does nothing. Callers which push many elements may use this function to
+ * grow geometrically instead of by the size step.
+ */
+int cgc_vector_reserve (cgc_vector * vector, size_t max_size);
+
 #endif /* _CGC_VECTOR_H_ */
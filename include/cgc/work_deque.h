@@ -0,0 +1,198 @@
+/**
+ * \file work_deque.h
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#ifndef _CGC_WORK_DEQUE_H_
+#define _CGC_WORK_DEQUE_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <sysexits.h>
+#include <string.h>
+
+#include "cgc/common.h"
+#include "cgc/types.h"
+
+/**
+ * \defgroup schedulers_group Schedulers
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Typedefs.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Circular buffer of a cgc_work_deque.
+ */
+typedef struct cgc_work_deque_buffer
+{
+    struct cgc_work_deque_buffer * _previous;   /**<- Buffer replaced by this one. */
+    size_t _capacity;                           /**<- Number of slots. */
+    _Atomic (void *) _slots[];                  /**<- Slots. */
+} cgc_work_deque_buffer;
+
+/**
+ * \class cgc_work_deque
+ * \ingroup schedulers_group
+ * \brief CGC Work-stealing deque.
+ *
+ * CGC Work deques are the dynamic circular work-stealing deques of Chase and
+ * Lev. They hold pointers, and are owned by a single thread, which pushes
+ * and pops at the bottom like a stack. Any other thread may steal from the
+ * top. All operations are lock-free; the owner only synchronizes with
+ * thieves when the deque holds at most one element.
+ *
+ * ## Growth
+ * When full, the owner copies the elements into a buffer twice larger.
+ * A thief may still be reading the old buffer, so it is only freed by
+ * cgc_work_deque_clean().
+ *
+ * ## Threads
+ * cgc_work_deque_push() and cgc_work_deque_pop() may only be called by the
+ * owner. cgc_work_deque_steal() and cgc_work_deque_size() may be called by
+ * any thread. The other functions require exclusive access.
+ *
+ * \sa cgc_scheduler
+ */
+typedef struct cgc_work_deque
+{
+    _Alignas (CGC_CACHE_LINE_SIZE) atomic_int_least64_t _top;       /**<- Index of the oldest element. */
+    _Alignas (CGC_CACHE_LINE_SIZE) atomic_int_least64_t _bottom;    /**<- Index after the newest element. */
+    _Atomic (cgc_work_deque_buffer *) _buffer;                      /**<- Current buffer. */
+} cgc_work_deque;
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Create a new cgc_work_deque.
+ * \param capacity Initial capacity.
+ * \relatesalso cgc_work_deque
+ * \return The pointer to the new cgc_work_deque in case of success. \c NULL in
+ * case of failure.
+ * \retval NULL if the deque could not be allocated.
+ * \note Deques obtained this way must be freed using cgc_work_deque_destroy().
+ * \note In case of failure, \c errno may be set to \c ENOMEM.
+ * \note A call to this function may change the value of \c errno.
+ */
+cgc_work_deque * cgc_work_deque_create (size_t capacity);
+
+/**
+ * \brief Free a dynamically allocated cgc_work_deque.
+ * \param deque Deque.
+ * \relatesalso cgc_work_deque
+ * \note It is safe to pass a \c NULL to this function.
+ * \warning It is strongly advised to use this function only of deques obtained
+ * via cgc_work_deque_create().
+ */
+void cgc_work_deque_destroy (cgc_work_deque * deque);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initialize a cgc_work_deque.
+ * \param[in,out] deque Deque.
+ * \param[in] capacity Initial capacity, rounded up to a power of two.
+ * \relatesalso cgc_work_deque
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 in case of failure because of malloc. \c errno may be set to
+ * \c ENOMEM.
+ */
+int cgc_work_deque_init (cgc_work_deque * deque, size_t capacity);
+
+/**
+ * \brief Clean a cgc_work_deque.
+ * \param[in,out] deque Deque.
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \relatesalso cgc_work_deque
+ * \note The pointed elements are not freed.
+ */
+int cgc_work_deque_clean (cgc_work_deque * deque);
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the size of the deque.
+ * \param deque Deque.
+ * \return size.
+ * \relatesalso cgc_work_deque
+ * \note The result may be outdated as soon as it is returned.
+ */
+size_t cgc_work_deque_size (const cgc_work_deque * deque);
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Push to the bottom.
+ * \param[in,out] deque Deque.
+ * \param[in] element Pointer to store.
+ * \relatesalso cgc_work_deque
+ * \return This function shall return 0 in case of success, a negative integer
+ * in case of failure.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL. \c errno shall be set to
+ * \c EINVAL.
+ * \retval -2 if the deque could not grow. \c errno may be set to \c ENOMEM.
+ * \warning Only the owner thread may call this function.
+ */
+int cgc_work_deque_push (cgc_work_deque * deque, void * element);
+
+/**
+ * \brief Pop from the bottom.
+ * \param[in,out] deque Deque.
+ * \relatesalso cgc_work_deque
+ * \return The newest element.
+ * \retval NULL if the deque is empty.
+ * \warning Only the owner thread may call this function.
+ */
+void * cgc_work_deque_pop (cgc_work_deque * deque);
+
+/**
+ * \brief Steal from the top.
+ * \param[in,out] deque Deque.
+ * \relatesalso cgc_work_deque
+ * \return The oldest element.
+ * \retval NULL if the deque is empty, or if another thread took the element
+ * first.
+ */
+void * cgc_work_deque_steal (cgc_work_deque * deque);
+
+#endif /* _CGC_WORK_DEQUE_H_ */
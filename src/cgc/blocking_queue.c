@@ -0,0 +1,318 @@
+/**
+ * \file blocking_queue.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "cgc/blocking_queue.h"
+
+#include <time.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Compute the deadline of a timeout.
+ * \param timeout Timeout in milliseconds.
+ * \return The deadline, on the monotonic clock.
+ */
+static struct timespec _cgc_blocking_queue_deadline (long timeout)
+{
+    struct timespec deadline = { .tv_sec = 0, .tv_nsec = 0 };
+    if (timeout > 0)
+    {
+        clock_gettime (CLOCK_MONOTONIC, & deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += timeout % 1000 * 1000000;
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    return deadline;
+}
+
+/**
+ * \brief Wait on a condition variable of a queue.
+ * \param queue A pointer to a CGC Blocking queue, whose mutex is locked.
+ * \param condition The condition variable.
+ * \param timeout Timeout in milliseconds. Negative to wait forever.
+ * \param deadline Deadline computed by _cgc_blocking_queue_deadline().
+ * \retval 0 if the thread was woken up.
+ * \retval ETIMEDOUT if the deadline is reached.
+ */
+static int _cgc_blocking_queue_wait (cgc_blocking_queue * const queue, pthread_cond_t * const condition, long timeout, const struct timespec * const deadline)
+{
+    int error = 0;
+    if (timeout < 0)
+        pthread_cond_wait (condition, & queue->_mutex);
+    else if (timeout == 0)
+        error = ETIMEDOUT;
+    else
+        error = pthread_cond_timedwait (condition, & queue->_mutex, deadline);
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_blocking_queue * cgc_blocking_queue_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity)
+{
+    cgc_blocking_queue * queue = malloc (sizeof * queue);
+    if (queue != NULL)
+    {
+        int error = cgc_blocking_queue_init (queue, element_size, copy_fun, clean_fun, capacity);
+        if (error)
+        {
+            free (queue);
+            queue = NULL;
+        }
+    }
+
+    return queue;
+}
+
+void cgc_blocking_queue_destroy (cgc_blocking_queue * queue)
+{
+    if (queue != NULL)
+    {
+        cgc_blocking_queue_clean (queue);
+        free (queue);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_blocking_queue_init (cgc_blocking_queue * queue, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error && capacity == 0)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        cgc_queue_init (& queue->_queue, element_size, copy_fun, clean_fun);
+        error = cgc_queue_reserve (& queue->_queue, capacity);
+    }
+
+    /* Timeouts are measured on the monotonic clock, which does not jump when
+     * the system time is set. */
+    pthread_condattr_t attributes;
+    bool attributes_ready = ! error && pthread_condattr_init (& attributes) == 0;
+    bool mutex_ready = attributes_ready && pthread_mutex_init (& queue->_mutex, NULL) == 0;
+    bool not_empty_ready = mutex_ready
+        && pthread_condattr_setclock (& attributes, CLOCK_MONOTONIC) == 0
+        && pthread_cond_init (& queue->_not_empty, & attributes) == 0;
+    bool not_full_ready = not_empty_ready && pthread_cond_init (& queue->_not_full, & attributes) == 0;
+
+    if (! error && ! not_full_ready)
+    {
+        if (not_empty_ready)
+            pthread_cond_destroy (& queue->_not_empty);
+        if (mutex_ready)
+            pthread_mutex_destroy (& queue->_mutex);
+        cgc_queue_clean (& queue->_queue);
+        error = -2;
+    }
+    if (attributes_ready)
+        pthread_condattr_destroy (& attributes);
+
+    if (! error)
+    {
+        queue->_capacity = capacity;
+        queue->_closed = false;
+    }
+
+    return error;
+}
+
+int cgc_blocking_queue_clean (cgc_blocking_queue * queue)
+{
+    int error = cgc_check_pointer (queue);
+
+    if (! error)
+    {
+        cgc_queue_clean (& queue->_queue);
+        pthread_cond_destroy (& queue->_not_full);
+        pthread_cond_destroy (& queue->_not_empty);
+        pthread_mutex_destroy (& queue->_mutex);
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_blocking_queue_is_empty (cgc_blocking_queue * queue)
+{
+    return cgc_blocking_queue_size (queue) == 0;
+}
+
+size_t cgc_blocking_queue_size (cgc_blocking_queue * queue)
+{
+    pthread_mutex_lock (& queue->_mutex);
+    size_t size = cgc_queue_size (& queue->_queue);
+    pthread_mutex_unlock (& queue->_mutex);
+
+    return size;
+}
+
+bool cgc_blocking_queue_is_closed (cgc_blocking_queue * queue)
+{
+    pthread_mutex_lock (& queue->_mutex);
+    bool closed = queue->_closed;
+    pthread_mutex_unlock (& queue->_mutex);
+
+    return closed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_blocking_queue_push (cgc_blocking_queue * queue, const void * element, long timeout)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    int reason = 0;
+    if (! error)
+    {
+        struct timespec deadline = _cgc_blocking_queue_deadline (timeout);
+        pthread_mutex_lock (& queue->_mutex);
+
+        while (! queue->_closed && cgc_queue_size (& queue->_queue) == queue->_capacity && ! reason)
+            reason = _cgc_blocking_queue_wait (queue, & queue->_not_full, timeout, & deadline);
+
+        if (queue->_closed)
+            reason = EPIPE;
+        else if (cgc_queue_size (& queue->_queue) < queue->_capacity)
+        {
+            reason = 0;
+            error = cgc_queue_push (& queue->_queue, element);
+            if (! error)
+                pthread_cond_signal (& queue->_not_empty);
+        }
+
+        pthread_mutex_unlock (& queue->_mutex);
+    }
+
+    if (reason)
+    {
+        error = -1;
+        errno = reason;
+    }
+
+    return error;
+}
+
+int cgc_blocking_queue_pop_into (cgc_blocking_queue * queue, void * destination, long timeout)
+{
+    return cgc_blocking_queue_pop_batch (queue, destination, 1, timeout) == 1 ? 0 : -1;
+}
+
+size_t cgc_blocking_queue_pop_batch (cgc_blocking_queue * queue, void * destination, size_t max, long timeout)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (destination);
+    if (! error && max == 0)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    size_t count = 0;
+    int reason = 0;
+    if (! error)
+    {
+        char * const target = destination;
+        struct timespec deadline = _cgc_blocking_queue_deadline (timeout);
+        pthread_mutex_lock (& queue->_mutex);
+
+        while (! queue->_closed && cgc_queue_is_empty (& queue->_queue) && ! reason)
+            reason = _cgc_blocking_queue_wait (queue, & queue->_not_empty, timeout, & deadline);
+
+        size_t size = cgc_queue_size (& queue->_queue);
+        count = size < max ? size : max;
+        for (size_t i = 0; i < count; ++i)
+            cgc_queue_pop_into (& queue->_queue, target + i * queue->_queue._element_size);
+
+        if (count == 1)
+            pthread_cond_signal (& queue->_not_full);
+        else if (count > 1)
+            pthread_cond_broadcast (& queue->_not_full);
+        else if (queue->_closed)
+            reason = EPIPE;
+
+        pthread_mutex_unlock (& queue->_mutex);
+    }
+
+    if (count == 0 && reason)
+        errno = reason;
+
+    return count;
+}
+
+int cgc_blocking_queue_close (cgc_blocking_queue * queue)
+{
+    int error = cgc_check_pointer (queue);
+
+    if (! error)
+    {
+        pthread_mutex_lock (& queue->_mutex);
+        queue->_closed = true;
+        pthread_cond_broadcast (& queue->_not_empty);
+        pthread_cond_broadcast (& queue->_not_full);
+        pthread_mutex_unlock (& queue->_mutex);
+    }
+
+    return error;
+}
+
+int cgc_blocking_queue_clear (cgc_blocking_queue * queue)
+{
+    int error = cgc_check_pointer (queue);
+
+    if (! error)
+    {
+        pthread_mutex_lock (& queue->_mutex);
+        error = cgc_queue_clear (& queue->_queue);
+        pthread_cond_broadcast (& queue->_not_full);
+        pthread_mutex_unlock (& queue->_mutex);
+    }
+
+    return error;
+}
@@ -0,0 +1,595 @@
+/**
+ * \file compact_list.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/compact_list.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Index of no node.
+ */
+static const uint32_t _NIL = UINT32_MAX;
+
+/**
+ * \brief Initial number of nodes of the backing array.
+ */
+static const uint32_t _DEFAULT_CAPACITY = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Compute the alignment of the elements of a list.
+ * \param element_size The size in bytes of the elements.
+ * \return The largest power of two dividing \c element_size, up to the
+ * alignment of \c max_align_t.
+ */
+static inline size_t _cgc_compact_list_element_alignment (size_t element_size)
+{
+    size_t alignment = _Alignof (max_align_t);
+    while (alignment > 1 && element_size % alignment != 0)
+        alignment /= 2;
+
+    return alignment;
+}
+
+/**
+ * \brief Compute the offset of the content in the nodes of a list.
+ * \param element_size The size in bytes of the elements.
+ * \return The offset in bytes of the content, past the links and aligned for
+ * the elements.
+ */
+static inline size_t _cgc_compact_list_content_offset (size_t element_size)
+{
+    const size_t alignment = _cgc_compact_list_element_alignment (element_size);
+    return (sizeof (cgc_compact_list_links) + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * \brief Compute the size of the nodes of a list.
+ * \param element_size The size in bytes of the elements.
+ * \return The size in bytes of a node.
+ * Nodes are padded so that both their links and their contents stay aligned
+ * in the backing array.
+ */
+static inline size_t _cgc_compact_list_node_size (size_t element_size)
+{
+    size_t alignment = _cgc_compact_list_element_alignment (element_size);
+    if (alignment < _Alignof (cgc_compact_list_links))
+        alignment = _Alignof (cgc_compact_list_links);
+
+    const size_t node_size = _cgc_compact_list_content_offset (element_size) + element_size;
+    return (node_size + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * \brief Get the links of a node.
+ * \param list A pointer to a CGC Compact list.
+ * \param i Index of the node.
+ * \return A pointer to the links of the node.
+ */
+static inline cgc_compact_list_links * _cgc_compact_list_links (const cgc_compact_list * const list, uint32_t i)
+{
+    return (cgc_compact_list_links *) (void *) (list->_nodes + (size_t) i * list->_node_size);
+}
+
+/**
+ * \brief Get the content of a node.
+ * \param list A pointer to a CGC Compact list.
+ * \param i Index of the node.
+ * \return A pointer to the content of the node.
+ */
+static inline void * _cgc_compact_list_content (const cgc_compact_list * const list, uint32_t i)
+{
+    return list->_nodes + (size_t) i * list->_node_size + list->_content_offset;
+}
+
+/**
+ * \brief Resize the backing array.
+ * \param list A pointer to a CGC Compact list.
+ * \param capacity The new number of nodes.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of realloc.
+ */
+static int _cgc_compact_list_grow (cgc_compact_list * const list, uint32_t capacity)
+{
+    int error = 0;
+    char * const nodes = realloc (list->_nodes, (size_t) capacity * list->_node_size);
+    if (nodes != NULL)
+    {
+        list->_nodes = nodes;
+        list->_capacity = capacity;
+    }
+    else
+        error = -2;
+
+    return error;
+}
+
+/**
+ * \brief Get an unused node.
+ * \param list A pointer to a CGC Compact list.
+ * \param node Index of the node (output).
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of realloc, or if the list is full.
+ * Nodes of erased elements are reused first.
+ */
+static int _cgc_compact_list_node_alloc (cgc_compact_list * const list, uint32_t * const node)
+{
+    int error = 0;
+    if (list->_free != _NIL)
+    {
+        * node = list->_free;
+        list->_free = _cgc_compact_list_links (list, * node)->_next;
+    }
+    else
+    {
+        if (list->_used == list->_capacity)
+        {
+            uint32_t capacity = list->_capacity == 0 ? _DEFAULT_CAPACITY
+                : list->_capacity < _NIL / 2 ? list->_capacity * 2 : _NIL;
+            error = capacity > list->_capacity ? _cgc_compact_list_grow (list, capacity) : -2;
+        }
+
+        if (! error)
+            * node = list->_used++;
+    }
+
+    return error;
+}
+
+/**
+ * \brief Put a node in the chain of free nodes.
+ * \param list A pointer to a CGC Compact list.
+ * \param node Index of the node.
+ */
+static inline void _cgc_compact_list_node_free (cgc_compact_list * const list, uint32_t node)
+{
+    _cgc_compact_list_links (list, node)->_next = list->_free;
+    list->_free = node;
+}
+
+/**
+ * \brief Link a node before another one.
+ * \param list A pointer to a CGC Compact list.
+ * \param node Index of the node to link.
+ * \param next Index of the future successor of \c node, or _NIL to link
+ * \c node as the last one.
+ */
+static void _cgc_compact_list_link_before (cgc_compact_list * const list, uint32_t node, uint32_t next)
+{
+    cgc_compact_list_links * const links = _cgc_compact_list_links (list, node);
+    uint32_t previous = next != _NIL ? _cgc_compact_list_links (list, next)->_previous : list->_last;
+
+    links->_previous = previous;
+    links->_next = next;
+
+    if (previous != _NIL)
+        _cgc_compact_list_links (list, previous)->_next = node;
+    else
+        list->_first = node;
+
+    if (next != _NIL)
+        _cgc_compact_list_links (list, next)->_previous = node;
+    else
+        list->_last = node;
+
+    list->_size++;
+}
+
+/**
+ * \brief Unlink a node.
+ * \param list A pointer to a CGC Compact list.
+ * \param node Index of the node to unlink.
+ * \return Index of the successor of \c node.
+ * \note The node is put in the chain of free nodes.
+ */
+static uint32_t _cgc_compact_list_unlink (cgc_compact_list * const list, uint32_t node)
+{
+    const cgc_compact_list_links links = * _cgc_compact_list_links (list, node);
+
+    if (links._previous != _NIL)
+        _cgc_compact_list_links (list, links._previous)->_next = links._next;
+    else
+        list->_first = links._next;
+
+    if (links._next != _NIL)
+        _cgc_compact_list_links (list, links._next)->_previous = links._previous;
+    else
+        list->_last = links._previous;
+
+    _cgc_compact_list_node_free (list, node);
+    list->_size--;
+
+    return links._next;
+}
+
+/**
+ * \brief Find the node at index \c i.
+ * \param list A pointer to a CGC Compact list.
+ * \param i Target index.
+ * \return Index of the node.
+ * \pre i < list->_size
+ * The walk starts from whichever end of the list is the closest.
+ */
+static uint32_t _cgc_compact_list_node_at (const cgc_compact_list * const list, size_t i)
+{
+    uint32_t node;
+    if (i < list->_size / 2)
+    {
+        node = list->_first;
+        for (size_t j = 0; j < i; ++j)
+            node = _cgc_compact_list_links (list, node)->_next;
+    }
+    else
+    {
+        node = list->_last;
+        for (size_t j = list->_size - 1; j > i; --j)
+            node = _cgc_compact_list_links (list, node)->_previous;
+    }
+
+    return node;
+}
+
+/**
+ * \brief Copy an element into a new node linked before \c next.
+ * \param list A pointer to a CGC Compact list.
+ * \param element A pointer to the element.
+ * \param next Index of the successor of the new node, or _NIL.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the pointers is \c NULL.
+ * \retval -2 in case of failure because of realloc.
+ * \retval <= -3 in case of failure of the copy function.
+ */
+static int _cgc_compact_list_insert_before (cgc_compact_list * const list, const void * const element, uint32_t next)
+{
+    uint32_t node = _NIL;
+    int error = _cgc_compact_list_node_alloc (list, & node);
+
+    if (! error)
+    {
+        void * const content = _cgc_compact_list_content (list, node);
+        if (list->_copy_fun != NULL)
+            error = list->_copy_fun (element, content);
+        else
+            memcpy (content, element, list->_element_size);
+
+        if (! error)
+            _cgc_compact_list_link_before (list, node, next);
+        else
+            _cgc_compact_list_node_free (list, node);
+    }
+
+    return error;
+}
+
+/**
+ * \brief Copy the content of a node into a newly allocated memory area.
+ * \param list A pointer to a CGC Compact list.
+ * \param node Index of the node.
+ * \return A pointer to the copy.
+ * \retval \c NULL in case of failure.
+ */
+static inline void * _cgc_compact_list_content_dup (const cgc_compact_list * const list, uint32_t node)
+{
+    void * const copy = malloc (list->_element_size);
+    if (copy != NULL)
+        memcpy (copy, _cgc_compact_list_content (list, node), list->_element_size);
+
+    return copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_compact_list * cgc_compact_list_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
+{
+    cgc_compact_list * list = malloc (sizeof * list);
+    if (list != NULL)
+        cgc_compact_list_init (list, element_size, copy_fun, clean_fun);
+
+    return list;
+}
+
+void cgc_compact_list_destroy (cgc_compact_list * const list)
+{
+    if (list != NULL)
+    {
+        cgc_compact_list_clean (list);
+        free (list);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_compact_list_init (cgc_compact_list * const list, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
+{
+    int error = cgc_check_pointer (list);
+
+    if (! error)
+    {
+        list->_nodes = NULL;
+        list->_capacity = 0;
+        list->_used = 0;
+        list->_first = _NIL;
+        list->_last = _NIL;
+        list->_free = _NIL;
+        list->_clean_fun = clean_fun;
+        list->_copy_fun = copy_fun;
+        list->_size = 0;
+        list->_element_size = element_size;
+        list->_node_size = _cgc_compact_list_node_size (element_size);
+        list->_content_offset = _cgc_compact_list_content_offset (element_size);
+    }
+
+    return error;
+}
+
+int cgc_compact_list_clean (cgc_compact_list * const list)
+{
+    int error = cgc_compact_list_clear (list);
+    if (! error)
+    {
+        free (list->_nodes);
+        list->_nodes = NULL;
+        list->_capacity = 0;
+        list->_used = 0;
+        list->_free = _NIL;
+    }
+
+    return error;
+}
+
+int cgc_compact_list_reserve (cgc_compact_list * const list, size_t capacity)
+{
+    int error = cgc_check_pointer (list);
+    if (! error && capacity >= _NIL)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error && capacity > list->_capacity)
+        error = _cgc_compact_list_grow (list, (uint32_t) capacity);
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_compact_list * cgc_compact_list_copy (const cgc_compact_list * const list)
+{
+    cgc_compact_list * copy = NULL;
+    if (list != NULL)
+    {
+        copy = cgc_compact_list_create (list->_element_size, list->_copy_fun, list->_clean_fun);
+        if (copy != NULL)
+            cgc_compact_list_copy_into (list, copy);
+    }
+
+    return copy;
+}
+
+int cgc_compact_list_copy_into (const cgc_compact_list * const original, cgc_compact_list * const destination)
+{
+    int error = cgc_check_pointer (original);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    if (! error)
+        error = cgc_compact_list_init (destination, original->_element_size, original->_copy_fun, original->_clean_fun);
+    if (! error)
+        error = cgc_compact_list_reserve (destination, original->_size);
+
+    for (uint32_t node = original->_first; ! error && node != _NIL; node = _cgc_compact_list_links (original, node)->_next)
+        error = _cgc_compact_list_insert_before (destination, _cgc_compact_list_content (original, node), _NIL);
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Swap.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_compact_list_swap (cgc_compact_list * const a, cgc_compact_list * const b)
+{
+    int error = cgc_check_pointer (a);
+    if (! error)
+        error = cgc_check_pointer (b);
+
+    if (! error)
+    {
+        cgc_compact_list tmp = * a;
+        * a = * b;
+        * b = tmp;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_compact_list_is_empty (const cgc_compact_list * const list)
+{
+    return list->_size == 0;
+}
+
+size_t cgc_compact_list_size (const cgc_compact_list * const list)
+{
+    return list->_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+void * cgc_compact_list_at (const cgc_compact_list * const list, size_t i)
+{
+    return i < list->_size ? _cgc_compact_list_content (list, _cgc_compact_list_node_at (list, i)) : NULL;
+}
+
+void * cgc_compact_list_front (const cgc_compact_list * const list)
+{
+    return _cgc_compact_list_content (list, list->_first);
+}
+
+void * cgc_compact_list_back (const cgc_compact_list * const list)
+{
+    return _cgc_compact_list_content (list, list->_last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_compact_list_push_front (cgc_compact_list * const list, const void * const element)
+{
+    int error = cgc_check_pointer (list);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    if (! error)
+        error = _cgc_compact_list_insert_before (list, element, list->_first);
+
+    return error;
+}
+
+int cgc_compact_list_push_back (cgc_compact_list * const list, const void * const element)
+{
+    int error = cgc_check_pointer (list);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    if (! error)
+        error = _cgc_compact_list_insert_before (list, element, _NIL);
+
+    return error;
+}
+
+void * cgc_compact_list_pop_front (cgc_compact_list * const list)
+{
+    void * const element = _cgc_compact_list_content_dup (list, list->_first);
+    if (element != NULL)
+        _cgc_compact_list_unlink (list, list->_first);
+
+    return element;
+}
+
+void * cgc_compact_list_pop_back (cgc_compact_list * const list)
+{
+    void * const element = _cgc_compact_list_content_dup (list, list->_last);
+    if (element != NULL)
+        _cgc_compact_list_unlink (list, list->_last);
+
+    return element;
+}
+
+int cgc_compact_list_insert (cgc_compact_list * const list, size_t i, const void * const element)
+{
+    int error = cgc_check_pointer (list);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    if (! error)
+    {
+        uint32_t next = i < list->_size ? _cgc_compact_list_node_at (list, i) : _NIL;
+        error = _cgc_compact_list_insert_before (list, element, next);
+    }
+
+    return error;
+}
+
+int cgc_compact_list_clear (cgc_compact_list * const list)
+{
+    int error = cgc_check_pointer (list);
+
+    if (! error)
+    {
+        if (list->_clean_fun != NULL)
+            for (uint32_t node = list->_first; node != _NIL; node = _cgc_compact_list_links (list, node)->_next)
+                list->_clean_fun (_cgc_compact_list_content (list, node));
+
+        list->_first = _NIL;
+        list->_last = _NIL;
+        list->_free = _NIL;
+        list->_used = 0;
+        list->_size = 0;
+    }
+
+    return error;
+}
+
+int cgc_compact_list_erase (cgc_compact_list * const list, size_t start, size_t end)
+{
+    int error = cgc_check_pointer (list);
+    if (! error && (start >= end || start > list->_size))
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error && start < list->_size)
+    {
+        uint32_t node = _cgc_compact_list_node_at (list, start);
+        for (size_t j = start; j < end && node != _NIL; ++j)
+        {
+            if (list->_clean_fun != NULL)
+                list->_clean_fun (_cgc_compact_list_content (list, node));
+            node = _cgc_compact_list_unlink (list, node);
+        }
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions on lists.
+////////////////////////////////////////////////////////////////////////////////
+
+void cgc_compact_list_map (cgc_compact_list * const list, cgc_unary_op_function op_fun)
+{
+    for (uint32_t node = list->_first; node != _NIL; node = _cgc_compact_list_links (list, node)->_next)
+        op_fun (_cgc_compact_list_content (list, node));
+}
+
+void cgc_compact_list_fold_left (const cgc_compact_list * const list, cgc_binary_op_left_function op_fun, void * const base_result)
+{
+    for (uint32_t node = list->_first; node != _NIL; node = _cgc_compact_list_links (list, node)->_next)
+        op_fun (base_result, _cgc_compact_list_content (list, node));
+}
+
+void cgc_compact_list_fold_right (const cgc_compact_list * const list, cgc_binary_op_right_function op_fun, void * const base_result)
+{
+    for (uint32_t node = list->_last; node != _NIL; node = _cgc_compact_list_links (list, node)->_previous)
+        op_fun (_cgc_compact_list_content (list, node), base_result);
+}
@@ -0,0 +1,544 @@
+/**
+ * \file concurrent_stack.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/concurrent_stack.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Nodes.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Header of a node. The element is stored after it.
+ * \note The link is atomic because a thread walking a chain may read it while
+ * the node is being reused by another thread. Such a walk is always
+ * discarded by the failure of the following compare-and-swap.
+ */
+typedef struct _cgc_concurrent_stack_node
+{
+    atomic_uint_least32_t _next;    /**<- Index of the next node. */
+} _cgc_concurrent_stack_node;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Index of no node.
+ */
+static const uint32_t _NIL = UINT32_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Pack an index and a tag into a head.
+ * \param index Index of a node.
+ * \param tag Tag.
+ * \return The tagged index.
+ */
+static inline uint_least64_t _cgc_concurrent_stack_pack (uint32_t index, uint_least64_t tag)
+{
+    return tag << 32 | index;
+}
+
+/**
+ * \brief Get the index of a head.
+ * \param head Tagged index.
+ * \return The index.
+ */
+static inline uint32_t _cgc_concurrent_stack_index (uint_least64_t head)
+{
+    return (uint32_t) (head & UINT32_MAX);
+}
+
+/**
+ * \brief Get a node.
+ * \param stack A pointer to a CGC Concurrent stack.
+ * \param i Index of the node.
+ * \return A pointer to the header of the node.
+ */
+static inline _cgc_concurrent_stack_node * _cgc_concurrent_stack_node_at (const cgc_concurrent_stack * const stack, uint32_t i)
+{
+    return (_cgc_concurrent_stack_node *) (void *) (stack->_nodes + (size_t) i * stack->_node_size);
+}
+
+/**
+ * \brief Get the content of a node.
+ * \param stack A pointer to a CGC Concurrent stack.
+ * \param i Index of the node.
+ * \return A pointer to the content of the node.
+ */
+static inline void * _cgc_concurrent_stack_content (const cgc_concurrent_stack * const stack, uint32_t i)
+{
+    return stack->_nodes + (size_t) i * stack->_node_size + stack->_content_offset;
+}
+
+/**
+ * \brief Get the successor of a node.
+ * \param stack A pointer to a CGC Concurrent stack.
+ * \param i Index of the node.
+ * \return The index of the next node.
+ */
+static inline uint32_t _cgc_concurrent_stack_next (const cgc_concurrent_stack * const stack, uint32_t i)
+{
+    return (uint32_t) atomic_load_explicit (& _cgc_concurrent_stack_node_at (stack, i)->_next, memory_order_relaxed);
+}
+
+/**
+ * \brief Set the successor of a node.
+ * \param stack A pointer to a CGC Concurrent stack.
+ * \param i Index of the node.
+ * \param next Index of the next node.
+ */
+static inline void _cgc_concurrent_stack_set_next (const cgc_concurrent_stack * const stack, uint32_t i, uint32_t next)
+{
+    atomic_store_explicit (& _cgc_concurrent_stack_node_at (stack, i)->_next, next, memory_order_relaxed);
+}
+
+/**
+ * \brief Detach a chain of nodes from a shared head.
+ * \param stack A pointer to a CGC Concurrent stack.
+ * \param head Shared head (top or free list).
+ * \param max Maximal number of nodes.
+ * \param last Index of the last detached node (output).
+ * \param count Number of detached nodes (output).
+ * \return The index of the first detached node, or _NIL.
+ * \note The last detached node still links to the rest of the shared chain.
+ *
+ * The chain is walked before the compare-and-swap. If the tag did not change
+ * meanwhile, no node was popped from this head, hence the walked links are
+ * still those of the chain.
+ */
+static uint32_t _cgc_concurrent_stack_pop_chain (cgc_concurrent_stack * const stack, atomic_uint_least64_t * const head, uint32_t max, uint32_t * const last, uint32_t * const count)
+{
+    uint_least64_t old = atomic_load_explicit (head, memory_order_acquire);
+    uint32_t first = _NIL;
+    * count = 0;
+    bool done = false;
+    while (! done)
+    {
+        first = _cgc_concurrent_stack_index (old);
+        if (first != _NIL)
+        {
+            uint32_t n = 1;
+            uint32_t node = first;
+            uint32_t next = _cgc_concurrent_stack_next (stack, node);
+            while (n < max && next != _NIL)
+            {
+                node = next;
+                next = _cgc_concurrent_stack_next (stack, node);
+                ++n;
+            }
+
+            uint_least64_t new = _cgc_concurrent_stack_pack (next, (old >> 32) + 1);
+            if (atomic_compare_exchange_weak_explicit (head, & old, new, memory_order_acquire, memory_order_acquire))
+            {
+                * last = node;
+                * count = n;
+                done = true;
+            }
+        }
+        else
+            done = true;
+    }
+
+    return first;
+}
+
+/**
+ * \brief Attach a chain of nodes to a shared head.
+ * \param stack A pointer to a CGC Concurrent stack.
+ * \param head Shared head (top or free list).
+ * \param first Index of the first node of the chain.
+ * \param last Index of the last node of the chain.
+ */
+static void _cgc_concurrent_stack_push_chain (cgc_concurrent_stack * const stack, atomic_uint_least64_t * const head, uint32_t first, uint32_t last)
+{
+    uint_least64_t old = atomic_load_explicit (head, memory_order_relaxed);
+    uint_least64_t new;
+    do
+    {
+        _cgc_concurrent_stack_set_next (stack, last, _cgc_concurrent_stack_index (old));
+        new = _cgc_concurrent_stack_pack (first, (old >> 32) + 1);
+    }
+    while (! atomic_compare_exchange_weak_explicit (head, & old, new, memory_order_release, memory_order_relaxed));
+}
+
+/**
+ * \brief Give the oldest nodes of a private chain back to a shared head.
+ * \param stack A pointer to a CGC Concurrent stack.
+ * \param head Shared head (top or free list).
+ * \param chain First node of the private chain.
+ * \param count Number of nodes of the private chain.
+ * \param n Number of nodes to give back.
+ */
+static void _cgc_concurrent_stack_give (cgc_concurrent_stack * const stack, atomic_uint_least64_t * const head, uint32_t * const chain, uint32_t * const count, uint32_t n)
+{
+    uint32_t first = * chain;
+    if (n < * count)
+    {
+        uint32_t kept_last = * chain;
+        for (uint32_t i = 1; i < * count - n; ++i)
+            kept_last = _cgc_concurrent_stack_next (stack, kept_last);
+        first = _cgc_concurrent_stack_next (stack, kept_last);
+        _cgc_concurrent_stack_set_next (stack, kept_last, _NIL);
+    }
+    else
+        * chain = _NIL;
+
+    if (n != 0)
+    {
+        uint32_t last = first;
+        for (uint32_t i = 1; i < n; ++i)
+            last = _cgc_concurrent_stack_next (stack, last);
+        _cgc_concurrent_stack_push_chain (stack, head, first, last);
+    }
+    * count -= n;
+}
+
+/**
+ * \brief Take a chain of nodes from a shared head into an empty private chain.
+ * \param magazine A pointer to a magazine.
+ * \param head Shared head (top or free list).
+ * \param chain First node of the private chain.
+ * \param count Number of nodes of the private chain.
+ */
+static void _cgc_concurrent_stack_take (cgc_concurrent_stack_magazine * const magazine, atomic_uint_least64_t * const head, uint32_t * const chain, uint32_t * const count)
+{
+    uint32_t last = _NIL;
+    * chain = _cgc_concurrent_stack_pop_chain (magazine->_stack, head, magazine->_capacity / 2, & last, count);
+    if (* count != 0)
+        _cgc_concurrent_stack_set_next (magazine->_stack, last, _NIL);
+}
+
+/**
+ * \brief Copy an element into a node.
+ * \param stack A pointer to a CGC Concurrent stack.
+ * \param node Index of the node.
+ * \param element A pointer to the element.
+ * \retval 0 in case of success.
+ * \retval <= -3 in case of failure of the copy function.
+ */
+static inline int _cgc_concurrent_stack_fill (cgc_concurrent_stack * const stack, uint32_t node, const void * const element)
+{
+    int error = 0;
+    void * const content = _cgc_concurrent_stack_content (stack, node);
+    if (stack->_copy_fun != NULL)
+        error = stack->_copy_fun (element, content);
+    else
+        memcpy (content, element, stack->_element_size);
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_concurrent_stack * cgc_concurrent_stack_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity)
+{
+    cgc_concurrent_stack * stack = aligned_alloc (_Alignof (cgc_concurrent_stack), sizeof * stack);
+    if (stack != NULL)
+    {
+        int error = cgc_concurrent_stack_init (stack, element_size, copy_fun, clean_fun, capacity);
+        if (error)
+        {
+            free (stack);
+            stack = NULL;
+        }
+    }
+
+    return stack;
+}
+
+void cgc_concurrent_stack_destroy (cgc_concurrent_stack * stack)
+{
+    if (stack != NULL)
+    {
+        cgc_concurrent_stack_clean (stack);
+        free (stack);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_concurrent_stack_init (cgc_concurrent_stack * stack, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity)
+{
+    int error = cgc_check_pointer (stack);
+    if (! error && (capacity == 0 || capacity >= _NIL))
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    /* Align the contents on the largest power of two dividing their size,
+     * from the alignment of the header up to 8. */
+    size_t alignment = 8;
+    while (alignment > _Alignof (_cgc_concurrent_stack_node) && element_size % alignment != 0)
+        alignment /= 2;
+    size_t offset = (sizeof (_cgc_concurrent_stack_node) + alignment - 1) / alignment * alignment;
+    size_t node_size = (offset + element_size + alignment - 1) / alignment * alignment;
+
+    if (! error)
+    {
+        stack->_nodes = NULL;
+        if (node_size > element_size && capacity <= SIZE_MAX / node_size)
+            stack->_nodes = malloc (capacity * node_size);
+        if (stack->_nodes == NULL)
+            error = -2;
+    }
+
+    if (! error)
+    {
+        stack->_capacity = (uint32_t) capacity;
+        stack->_node_size = node_size;
+        stack->_content_offset = offset;
+        stack->_element_size = element_size;
+        stack->_copy_fun = copy_fun;
+        stack->_clean_fun = clean_fun;
+        for (uint32_t i = 0; i < stack->_capacity; ++i)
+            atomic_init (& _cgc_concurrent_stack_node_at (stack, i)->_next, i + 1 < stack->_capacity ? i + 1 : _NIL);
+        atomic_init (& stack->_top, _cgc_concurrent_stack_pack (_NIL, 0));
+        atomic_init (& stack->_free, _cgc_concurrent_stack_pack (0, 0));
+    }
+
+    return error;
+}
+
+int cgc_concurrent_stack_clean (cgc_concurrent_stack * stack)
+{
+    int error = cgc_concurrent_stack_clear (stack);
+    if (! error)
+    {
+        free (stack->_nodes);
+        stack->_nodes = NULL;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_concurrent_stack_is_empty (const cgc_concurrent_stack * stack)
+{
+    return _cgc_concurrent_stack_index (atomic_load_explicit (& stack->_top, memory_order_relaxed)) == _NIL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_concurrent_stack_push (cgc_concurrent_stack * stack, const void * element)
+{
+    int error = cgc_check_pointer (stack);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    uint32_t node = _NIL;
+    if (! error)
+    {
+        uint32_t last = _NIL;
+        uint32_t count = 0;
+        node = _cgc_concurrent_stack_pop_chain (stack, & stack->_free, 1, & last, & count);
+        if (count == 0)
+        {
+            error = -1;
+            errno = EAGAIN;
+        }
+    }
+
+    if (! error)
+    {
+        error = _cgc_concurrent_stack_fill (stack, node, element);
+        _cgc_concurrent_stack_push_chain (stack, error ? & stack->_free : & stack->_top, node, node);
+    }
+
+    return error;
+}
+
+int cgc_concurrent_stack_pop_into (cgc_concurrent_stack * stack, void * destination)
+{
+    int error = cgc_check_pointer (stack);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    uint32_t node = _NIL;
+    if (! error)
+    {
+        uint32_t last = _NIL;
+        uint32_t count = 0;
+        node = _cgc_concurrent_stack_pop_chain (stack, & stack->_top, 1, & last, & count);
+        if (count == 0)
+        {
+            error = -1;
+            errno = EAGAIN;
+        }
+    }
+
+    if (! error)
+    {
+        memcpy (destination, _cgc_concurrent_stack_content (stack, node), stack->_element_size);
+        _cgc_concurrent_stack_push_chain (stack, & stack->_free, node, node);
+    }
+
+    return error;
+}
+
+int cgc_concurrent_stack_clear (cgc_concurrent_stack * stack)
+{
+    int error = cgc_check_pointer (stack);
+
+    if (! error)
+    {
+        uint32_t last = _NIL;
+        uint32_t count = 0;
+        uint32_t first = _cgc_concurrent_stack_pop_chain (stack, & stack->_top, stack->_capacity, & last, & count);
+        if (count != 0)
+        {
+            if (stack->_clean_fun != NULL)
+                for (uint32_t i = 0, node = first; i < count; ++i, node = _cgc_concurrent_stack_next (stack, node))
+                    stack->_clean_fun (_cgc_concurrent_stack_content (stack, node));
+            _cgc_concurrent_stack_push_chain (stack, & stack->_free, first, last);
+        }
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Magazines.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_concurrent_stack_magazine_init (cgc_concurrent_stack_magazine * magazine, cgc_concurrent_stack * stack, size_t capacity)
+{
+    int error = cgc_check_pointer (magazine);
+    if (! error)
+        error = cgc_check_pointer (stack);
+    if (! error && (capacity < 2 || capacity >= _NIL))
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        magazine->_stack = stack;
+        magazine->_loaded = _NIL;
+        magazine->_loaded_count = 0;
+        magazine->_empty = _NIL;
+        magazine->_empty_count = 0;
+        magazine->_capacity = (uint32_t) capacity;
+    }
+
+    return error;
+}
+
+int cgc_concurrent_stack_magazine_flush (cgc_concurrent_stack_magazine * magazine)
+{
+    int error = cgc_check_pointer (magazine);
+
+    if (! error)
+    {
+        cgc_concurrent_stack * const stack = magazine->_stack;
+        _cgc_concurrent_stack_give (stack, & stack->_top, & magazine->_loaded, & magazine->_loaded_count, magazine->_loaded_count);
+        _cgc_concurrent_stack_give (stack, & stack->_free, & magazine->_empty, & magazine->_empty_count, magazine->_empty_count);
+    }
+
+    return error;
+}
+
+int cgc_concurrent_stack_magazine_push (cgc_concurrent_stack_magazine * magazine, const void * element)
+{
+    int error = cgc_check_pointer (magazine);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    cgc_concurrent_stack * const stack = ! error ? magazine->_stack : NULL;
+    if (! error && magazine->_empty_count == 0)
+    {
+        _cgc_concurrent_stack_take (magazine, & stack->_free, & magazine->_empty, & magazine->_empty_count);
+        if (magazine->_empty_count == 0)
+        {
+            error = -1;
+            errno = EAGAIN;
+        }
+    }
+
+    if (! error)
+    {
+        uint32_t node = magazine->_empty;
+        error = _cgc_concurrent_stack_fill (stack, node, element);
+        if (! error)
+        {
+            magazine->_empty = _cgc_concurrent_stack_next (stack, node);
+            magazine->_empty_count--;
+            _cgc_concurrent_stack_set_next (stack, node, magazine->_loaded);
+            magazine->_loaded = node;
+            magazine->_loaded_count++;
+        }
+    }
+
+    if (! error && magazine->_loaded_count > magazine->_capacity)
+        _cgc_concurrent_stack_give (stack, & stack->_top, & magazine->_loaded, & magazine->_loaded_count, magazine->_capacity / 2);
+
+    return error;
+}
+
+int cgc_concurrent_stack_magazine_pop_into (cgc_concurrent_stack_magazine * magazine, void * destination)
+{
+    int error = cgc_check_pointer (magazine);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    cgc_concurrent_stack * const stack = ! error ? magazine->_stack : NULL;
+    if (! error && magazine->_loaded_count == 0)
+    {
+        _cgc_concurrent_stack_take (magazine, & stack->_top, & magazine->_loaded, & magazine->_loaded_count);
+        if (magazine->_loaded_count == 0)
+        {
+            error = -1;
+            errno = EAGAIN;
+        }
+    }
+
+    if (! error)
+    {
+        uint32_t node = magazine->_loaded;
+        memcpy (destination, _cgc_concurrent_stack_content (stack, node), stack->_element_size);
+        magazine->_loaded = _cgc_concurrent_stack_next (stack, node);
+        magazine->_loaded_count--;
+        _cgc_concurrent_stack_set_next (stack, node, magazine->_empty);
+        magazine->_empty = node;
+        magazine->_empty_count++;
+    }
+
+    if (! error && magazine->_empty_count > magazine->_capacity)
+        _cgc_concurrent_stack_give (stack, & stack->_free, & magazine->_empty, & magazine->_empty_count, magazine->_capacity / 2);
+
+    return error;
+}
@@ -0,0 +1,485 @@
+/**
+ * \file indexed_heap.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/indexed_heap.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Arity used when none is supplied.
+ */
+static const size_t _DEFAULT_ARITY = 4;
+
+/**
+ * \brief Initial number of slots and ids.
+ */
+static const size_t _DEFAULT_CAPACITY = 16;
+
+/**
+ * \brief Position of the ids which are not in the heap.
+ */
+static const size_t _ABSENT = SIZE_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Round \c size up to a multiple of \c alignment.
+ * \param size Size.
+ * \param alignment Alignment, a power of two.
+ * \return Rounded size.
+ */
+static inline size_t _cgc_indexed_heap_round (size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * \brief Get a slot of the heap.
+ * \param heap A pointer to a CGC Indexed heap.
+ * \param position Position of the slot.
+ * \return A pointer to the slot, which starts with the key.
+ */
+static inline void * _cgc_indexed_heap_slot (const cgc_indexed_heap * const heap, size_t position)
+{
+    return heap->_slots + position * heap->_slot_size;
+}
+
+/**
+ * \brief Get the id held by a slot.
+ * \param heap A pointer to a CGC Indexed heap.
+ * \param slot A pointer to a slot.
+ * \return Id.
+ */
+static inline size_t _cgc_indexed_heap_id (const cgc_indexed_heap * const heap, const void * const slot)
+{
+    size_t id;
+    memcpy (& id, (const char *) slot + heap->_id_offset, sizeof id);
+    return id;
+}
+
+/**
+ * \brief Move a slot to a position and record it in the id map.
+ * \param heap A pointer to a CGC Indexed heap.
+ * \param position Target position.
+ * \param slot A pointer to the slot to move.
+ */
+static inline void _cgc_indexed_heap_place (cgc_indexed_heap * const heap, size_t position, const void * const slot)
+{
+    memcpy (_cgc_indexed_heap_slot (heap, position), slot, heap->_slot_size);
+    heap->_positions[_cgc_indexed_heap_id (heap, slot)] = position;
+}
+
+/**
+ * \brief Move the slot held in the hole up from a position.
+ * \param heap A pointer to a CGC Indexed heap.
+ * \param position Position of the vacant slot.
+ */
+static void _cgc_indexed_heap_sift_up (cgc_indexed_heap * const heap, size_t position)
+{
+    while (position > 0)
+    {
+        size_t parent = (position - 1) / heap->_arity;
+        void * const parent_slot = _cgc_indexed_heap_slot (heap, parent);
+        if (heap->_compare_fun (heap->_hole, parent_slot) >= 0)
+            break;
+        _cgc_indexed_heap_place (heap, position, parent_slot);
+        position = parent;
+    }
+    _cgc_indexed_heap_place (heap, position, heap->_hole);
+}
+
+/**
+ * \brief Move the slot held in the hole down from a position.
+ * \param heap A pointer to a CGC Indexed heap.
+ * \param position Position of the vacant slot.
+ */
+static void _cgc_indexed_heap_sift_down (cgc_indexed_heap * const heap, size_t position)
+{
+    const size_t arity = heap->_arity;
+    for (;;)
+    {
+        size_t first = position * arity + 1;
+        if (first >= heap->_size)
+            break;
+
+        size_t end = heap->_size - first > arity ? first + arity : heap->_size;
+        size_t best = first;
+        void * best_slot = _cgc_indexed_heap_slot (heap, first);
+        if (first * arity + 1 < heap->_size)
+            CGC_PREFETCH (_cgc_indexed_heap_slot (heap, first * arity + 1));
+        for (size_t child = first + 1; child < end; ++child)
+        {
+            void * const child_slot = _cgc_indexed_heap_slot (heap, child);
+            if (heap->_compare_fun (child_slot, best_slot) < 0)
+            {
+                best = child;
+                best_slot = child_slot;
+            }
+        }
+
+        if (heap->_compare_fun (best_slot, heap->_hole) >= 0)
+            break;
+        _cgc_indexed_heap_place (heap, position, best_slot);
+        position = best;
+    }
+    _cgc_indexed_heap_place (heap, position, heap->_hole);
+}
+
+/**
+ * \brief Grow the heap storage.
+ * \param heap A pointer to a CGC Indexed heap.
+ * \param capacity The new number of slots.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of realloc.
+ */
+static int _cgc_indexed_heap_grow_slots (cgc_indexed_heap * const heap, size_t capacity)
+{
+    int error = 0;
+    char * slots = NULL;
+    if (capacity <= SIZE_MAX / heap->_slot_size)
+        slots = realloc (heap->_slots, capacity * heap->_slot_size);
+
+    if (slots != NULL)
+    {
+        heap->_slots = slots;
+        heap->_capacity = capacity;
+    }
+    else
+        error = -2;
+
+    return error;
+}
+
+/**
+ * \brief Grow the id map.
+ * \param heap A pointer to a CGC Indexed heap.
+ * \param id_count The new number of ids.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of realloc.
+ */
+static int _cgc_indexed_heap_grow_ids (cgc_indexed_heap * const heap, size_t id_count)
+{
+    int error = 0;
+    size_t * positions = NULL;
+    if (id_count <= SIZE_MAX / sizeof * positions)
+        positions = realloc (heap->_positions, id_count * sizeof * positions);
+
+    if (positions != NULL)
+    {
+        for (size_t id = heap->_id_count; id < id_count; ++id)
+            positions[id] = _ABSENT;
+        heap->_positions = positions;
+        heap->_id_count = id_count;
+    }
+    else
+        error = -2;
+
+    return error;
+}
+
+/**
+ * \brief Get a geometrically grown size.
+ * \param current Current size.
+ * \param needed Needed size.
+ * \return The larger of \c needed and twice \c current.
+ */
+static inline size_t _cgc_indexed_heap_next_size (size_t current, size_t needed)
+{
+    size_t doubled = current == 0 ? _DEFAULT_CAPACITY
+        : current <= SIZE_MAX / 2 ? current * 2 : SIZE_MAX;
+    return needed > doubled ? needed : doubled;
+}
+
+/**
+ * \brief Check that an id is in the heap and that a key moves it the right
+ * way.
+ * \param heap A pointer to a CGC Indexed heap.
+ * \param id Id.
+ * \param key New key.
+ * \param direction Negative for a decrease, positive for an increase.
+ * \retval 0 if the key may be changed.
+ * \retval -1 otherwise. \c errno shall be set to \c EINVAL.
+ */
+static int _cgc_indexed_heap_check_update (const cgc_indexed_heap * const heap, size_t id, const void * const key, int direction)
+{
+    int error = cgc_check_pointer (heap);
+    if (! error)
+        error = cgc_check_pointer (key);
+
+    if (! error)
+    {
+        if (! cgc_indexed_heap_contains (heap, id))
+            error = -1;
+        else
+        {
+            int order = heap->_compare_fun (key, cgc_indexed_heap_key (heap, id));
+            if ((direction < 0 && order > 0) || (direction > 0 && order < 0))
+                error = -1;
+        }
+        if (error)
+            errno = EINVAL;
+    }
+
+    return error;
+}
+
+/**
+ * \brief Load an id and a key into the hole.
+ * \param heap A pointer to a CGC Indexed heap.
+ * \param id Id.
+ * \param key Key.
+ */
+static inline void _cgc_indexed_heap_fill_hole (cgc_indexed_heap * const heap, size_t id, const void * const key)
+{
+    memcpy (heap->_hole, key, heap->_key_size);
+    memcpy ((char *) heap->_hole + heap->_id_offset, & id, sizeof id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_indexed_heap * cgc_indexed_heap_create (size_t key_size, cgc_compare_function compare_fun, size_t arity)
+{
+    cgc_indexed_heap * heap = malloc (sizeof * heap);
+    if (heap != NULL)
+    {
+        int error = cgc_indexed_heap_init (heap, key_size, compare_fun, arity);
+        if (error)
+        {
+            free (heap);
+            heap = NULL;
+        }
+    }
+
+    return heap;
+}
+
+void cgc_indexed_heap_destroy (cgc_indexed_heap * heap)
+{
+    if (heap != NULL)
+    {
+        cgc_indexed_heap_clean (heap);
+        free (heap);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_indexed_heap_init (cgc_indexed_heap * heap, size_t key_size, cgc_compare_function compare_fun, size_t arity)
+{
+    int error = cgc_check_pointer (heap);
+    if (! error && (compare_fun == NULL || key_size == 0 || arity == 1
+        || key_size > SIZE_MAX / 2))
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        /* Keep the key at the start of the slot, suitably aligned. */
+        size_t alignment = key_size >= _Alignof (max_align_t) ? _Alignof (max_align_t) : _Alignof (size_t);
+        heap->_id_offset = _cgc_indexed_heap_round (key_size, _Alignof (size_t));
+        heap->_slot_size = _cgc_indexed_heap_round (heap->_id_offset + sizeof (size_t), alignment);
+        heap->_key_size = key_size;
+        heap->_arity = arity == 0 ? _DEFAULT_ARITY : arity;
+        heap->_compare_fun = compare_fun;
+        heap->_slots = NULL;
+        heap->_positions = NULL;
+        heap->_size = 0;
+        heap->_capacity = 0;
+        heap->_id_count = 0;
+        heap->_hole = malloc (heap->_slot_size);
+        if (heap->_hole == NULL)
+            error = -2;
+    }
+
+    return error;
+}
+
+int cgc_indexed_heap_clean (cgc_indexed_heap * heap)
+{
+    int error = cgc_check_pointer (heap);
+    if (! error)
+    {
+        free (heap->_slots);
+        free (heap->_positions);
+        free (heap->_hole);
+        heap->_slots = NULL;
+        heap->_positions = NULL;
+        heap->_hole = NULL;
+        heap->_size = 0;
+        heap->_capacity = 0;
+        heap->_id_count = 0;
+    }
+
+    return error;
+}
+
+int cgc_indexed_heap_reserve (cgc_indexed_heap * heap, size_t id_count)
+{
+    int error = cgc_check_pointer (heap);
+    if (! error && id_count > heap->_id_count)
+        error = _cgc_indexed_heap_grow_ids (heap, id_count);
+    if (! error && id_count > heap->_capacity)
+        error = _cgc_indexed_heap_grow_slots (heap, id_count);
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_indexed_heap_is_empty (const cgc_indexed_heap * heap)
+{
+    return heap->_size == 0;
+}
+
+size_t cgc_indexed_heap_size (const cgc_indexed_heap * heap)
+{
+    return heap->_size;
+}
+
+bool cgc_indexed_heap_contains (const cgc_indexed_heap * heap, size_t id)
+{
+    return id < heap->_id_count && heap->_positions[id] != _ABSENT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+size_t cgc_indexed_heap_top (const cgc_indexed_heap * heap)
+{
+    return _cgc_indexed_heap_id (heap, _cgc_indexed_heap_slot (heap, 0));
+}
+
+const void * cgc_indexed_heap_key (const cgc_indexed_heap * heap, size_t id)
+{
+    return _cgc_indexed_heap_slot (heap, heap->_positions[id]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_indexed_heap_push (cgc_indexed_heap * heap, size_t id, const void * key)
+{
+    int error = cgc_check_pointer (heap);
+    if (! error)
+        error = cgc_check_pointer (key);
+    if (! error && (id == _ABSENT || cgc_indexed_heap_contains (heap, id)))
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error && id >= heap->_id_count)
+        error = _cgc_indexed_heap_grow_ids (heap, _cgc_indexed_heap_next_size (heap->_id_count, id + 1));
+    if (! error && heap->_size == heap->_capacity)
+        error = _cgc_indexed_heap_grow_slots (heap, _cgc_indexed_heap_next_size (heap->_capacity, heap->_size + 1));
+
+    if (! error)
+    {
+        _cgc_indexed_heap_fill_hole (heap, id, key);
+        heap->_size++;
+        _cgc_indexed_heap_sift_up (heap, heap->_size - 1);
+    }
+
+    return error;
+}
+
+int cgc_indexed_heap_pop (cgc_indexed_heap * heap, size_t * id, void * key)
+{
+    int error = cgc_check_pointer (heap);
+    if (! error && heap->_size == 0)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        const void * const top = _cgc_indexed_heap_slot (heap, 0);
+        size_t top_id = _cgc_indexed_heap_id (heap, top);
+        if (id != NULL)
+            * id = top_id;
+        if (key != NULL)
+            memcpy (key, top, heap->_key_size);
+        heap->_positions[top_id] = _ABSENT;
+
+        heap->_size--;
+        if (heap->_size > 0)
+        {
+            memcpy (heap->_hole, _cgc_indexed_heap_slot (heap, heap->_size), heap->_slot_size);
+            _cgc_indexed_heap_sift_down (heap, 0);
+        }
+    }
+
+    return error;
+}
+
+int cgc_indexed_heap_decrease_key (cgc_indexed_heap * heap, size_t id, const void * key)
+{
+    int error = _cgc_indexed_heap_check_update (heap, id, key, -1);
+    if (! error)
+    {
+        _cgc_indexed_heap_fill_hole (heap, id, key);
+        _cgc_indexed_heap_sift_up (heap, heap->_positions[id]);
+    }
+
+    return error;
+}
+
+int cgc_indexed_heap_increase_key (cgc_indexed_heap * heap, size_t id, const void * key)
+{
+    int error = _cgc_indexed_heap_check_update (heap, id, key, 1);
+    if (! error)
+    {
+        _cgc_indexed_heap_fill_hole (heap, id, key);
+        _cgc_indexed_heap_sift_down (heap, heap->_positions[id]);
+    }
+
+    return error;
+}
+
+int cgc_indexed_heap_clear (cgc_indexed_heap * heap)
+{
+    int error = cgc_check_pointer (heap);
+    if (! error)
+    {
+        for (size_t i = 0; i < heap->_size; ++i)
+            heap->_positions[_cgc_indexed_heap_id (heap, _cgc_indexed_heap_slot (heap, i))] = _ABSENT;
+        heap->_size = 0;
+    }
+
+    return error;
+}
@@ -23,6 +23,19 @@
  */
 #include "cgc/list.h"
 
+////////////////////////////////////////////////////////////////////////////////
+// Blocks.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Block of list elements allocated by cgc_list_compact().
+ * The elements follow the header, each one directly followed by its content.
+ */
+struct cgc_list_block
+{
+    size_t _references;     /**< Number of elements still stored in the block. */
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Static utilities.
 ////////////////////////////////////////////////////////////////////////////////
@@ -56,7 +69,7 @@ static cgc_list_element * _cgc_list_element_alloc (void)
 {
     cgc_list_element * const e = malloc (sizeof * e);
     if (e != NULL)
-        * e = (cgc_list_element) { ._content = NULL, ._next = NULL, ._previous = NULL };
+        * e = (cgc_list_element) { ._content = NULL, ._next = NULL, ._previous = NULL, ._block = NULL };
 
     return e;
 }
@@ -102,12 +115,192 @@ static int _cgc_list_push_prelude (cgc_list * const list, const void * const con
     if (! error)
     {
         * e = _cgc_list_element_alloc ();
-        error = e != NULL ? _cgc_list_copy_content (list, * e, content) : -2;
+        error = * e != NULL ? _cgc_list_copy_content (list, * e, content) : -2;
+        if (error && * e != NULL)
+        {
+            free (* e);
+            * e = NULL;
+        }
+    }
+
+    return error;
+}
+
+/**
+ * \brief Link an element before another one.
+ * \param list A pointer to a CGC list.
+ * \param e A pointer to the list element to link.
+ * \param next A pointer to the future successor of \c e, or \c NULL to link
+ * \c e as the last element.
+ */
+static inline void _cgc_list_link_before (cgc_list * const list, cgc_list_element * const e, cgc_list_element * const next)
+{
+    cgc_list_element * const previous = next != NULL ? next->_previous : list->_last;
+
+    e->_previous = previous;
+    e->_next = next;
+
+    if (previous != NULL)
+        previous->_next = e;
+    else
+        list->_first = e;
+
+    if (next != NULL)
+        next->_previous = e;
+    else
+        list->_last = e;
+
+    list->_size++;
+}
+
+/**
+ * \brief Move all the elements of a list before an element of another list.
+ * \param list A pointer to the destination CGC list.
+ * \param other A pointer to the source CGC list, which will be emptied.
+ * \param next A pointer to the future successor of the moved elements, or
+ * \c NULL to move them at the end of \c list.
+ * \pre list != other
+ */
+static inline void _cgc_list_splice_before (cgc_list * const list, cgc_list * const other, cgc_list_element * const next)
+{
+    if (other->_first != NULL)
+    {
+        cgc_list_element * const previous = next != NULL ? next->_previous : list->_last;
+
+        other->_first->_previous = previous;
+        other->_last->_next = next;
+
+        if (previous != NULL)
+            previous->_next = other->_first;
+        else
+            list->_first = other->_first;
+
+        if (next != NULL)
+            next->_previous = other->_last;
+        else
+            list->_last = other->_last;
+
+        list->_size += other->_size;
+        other->_first = NULL;
+        other->_last = NULL;
+        other->_size = 0;
+    }
+}
+
+/**
+ * \brief Check whether the elements of a list can be moved into another one.
+ * \param list A pointer to the destination CGC list.
+ * \param other A pointer to the source CGC list.
+ * \retval 0 if both lists are distinct and hold elements of the same size.
+ * \retval -1 otherwise. \c errno shall be set to \c EINVAL.
+ */
+static inline int _cgc_list_check_compatible (const cgc_list * const list, const cgc_list * const other)
+{
+    int error = cgc_check_pointer (list);
+    if (! error)
+        error = cgc_check_pointer (other);
+
+    if (! error && (list == other || list->_element_size != other->_element_size))
+    {
+        error = -1;
+        errno = EINVAL;
     }
 
     return error;
 }
 
+/**
+ * \brief Unlink an element from a list.
+ * \param list A pointer to a CGC list.
+ * \param e A pointer to the list element to unlink.
+ * \return A pointer to the successor of \c e.
+ * \note Neither the element nor its content are freed.
+ */
+static inline cgc_list_element * _cgc_list_unlink (cgc_list * const list, cgc_list_element * const e)
+{
+    cgc_list_element * const previous = e->_previous;
+    cgc_list_element * const next = e->_next;
+
+    if (previous != NULL)
+        previous->_next = next;
+    else
+        list->_first = next;
+
+    if (next != NULL)
+        next->_previous = previous;
+    else
+        list->_last = previous;
+
+    list->_size--;
+
+    return next;
+}
+
+/**
+ * \brief Release the memory of a list element and of its content.
+ * \param e A pointer to the list element.
+ * \note The content is not cleaned. Elements stored in a block release their
+ * share of it, and the block is freed along with its last element.
+ */
+static inline void _cgc_list_element_release (cgc_list_element * const e)
+{
+    if (e->_block == NULL)
+    {
+        free (e->_content);
+        free (e);
+    }
+    else if (--e->_block->_references == 0)
+        free (e->_block);
+}
+
+/**
+ * \brief Free a list element and its content.
+ * \param list A pointer to a CGC list.
+ * \param e A pointer to the list element.
+ */
+static inline void _cgc_list_element_free (cgc_list * const list, cgc_list_element * const e)
+{
+    if (list->_clean_fun != NULL)
+        list->_clean_fun (e->_content);
+    _cgc_list_element_release (e);
+}
+
+/**
+ * \brief Detach the content of a list element.
+ * \param list A pointer to a CGC list.
+ * \param e A pointer to the list element.
+ * \return A pointer to the content, which the caller shall free.
+ * \retval NULL if the content is stored in a block and could not be copied
+ * out of it.
+ * \note On success, the element may be released without its content.
+ */
+static inline void * _cgc_list_element_take (cgc_list * const list, cgc_list_element * const e)
+{
+    void * content = e->_content;
+    if (e->_block == NULL)
+        e->_content = NULL;
+    else
+    {
+        content = malloc (list->_element_size);
+        if (content != NULL)
+            memcpy (content, e->_content, list->_element_size);
+    }
+
+    return content;
+}
+
+/**
+ * \brief Round a size up to the fundamental alignment.
+ * \param size Size in bytes.
+ * \return The smallest multiple of \c _Alignof (max_align_t) not lower than
+ * \c size.
+ */
+static inline size_t _cgc_list_align (size_t size)
+{
+    const size_t alignment = _Alignof (max_align_t);
+    return (size + alignment - 1) / alignment * alignment;
+}
+
 /**
  * \brief Get the list element at the specified index if possible, or the last
  * element otherwise.
@@ -134,20 +327,66 @@ static inline cgc_list_element * _cgc_list_element_at (cgc_list * const list, si
  */
 static inline cgc_list_element * _cgc_list_erase_until (cgc_list * const list, cgc_list_element * e, size_t i)
 {
-    size_t j = 0;
-    for (e = e; j != i && e != NULL; j++)
+    for (size_t j = 0; j != i && e != NULL; j++)
     {
-        cgc_list_element * next = e->_next;
-        if (list->_clean_fun != NULL)
-            list->_clean_fun (e->_content);
-        free (e->_content);
-        free (e);
+        CGC_PREFETCH (e->_next);
+        cgc_list_element * next = _cgc_list_unlink (list, e);
+        _cgc_list_element_free (list, e);
         e = next;
     }
 
     return e;
 }
 
+/**
+ * \brief Merge two sorted chains of elements linked by \c _next.
+ * \param a First chain.
+ * \param b Second chain.
+ * \param compare_fun Comparison function.
+ * \return The first element of the merged chain.
+ * On equal elements, those of \c a come first. The \c _previous links are
+ * not maintained.
+ */
+static cgc_list_element * _cgc_list_merge_chains (cgc_list_element * a, cgc_list_element * b, cgc_compare_function compare_fun)
+{
+    cgc_list_element head = { ._content = NULL, ._next = NULL, ._previous = NULL, ._block = NULL };
+    cgc_list_element * tail = & head;
+
+    while (a != NULL && b != NULL)
+    {
+        if (compare_fun (a->_content, b->_content) <= 0)
+        {
+            tail->_next = a;
+            a = a->_next;
+        }
+        else
+        {
+            tail->_next = b;
+            b = b->_next;
+        }
+        tail = tail->_next;
+    }
+    tail->_next = a != NULL ? a : b;
+
+    return head._next;
+}
+
+/**
+ * \brief Rebuild the \c _previous links and the last element of a list.
+ * \param list A pointer to a CGC list whose \c _first and \c _next links
+ * are valid.
+ */
+static void _cgc_list_relink_previous (cgc_list * const list)
+{
+    cgc_list_element * previous = NULL;
+    for (cgc_list_element * e = list->_first; e != NULL; e = e->_next)
+    {
+        e->_previous = previous;
+        previous = e;
+    }
+    list->_last = previous;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Dynamic creation and destruction.
 ////////////////////////////////////////////////////////////////////////////////
@@ -218,7 +457,10 @@ int cgc_list_copy_into (const cgc_list * const original, cgc_list * const destin
     if (! error && ! cgc_list_is_empty (original))
     {
         for (cgc_list_element * e = original->_first; e != NULL; e = e->_next)
+        {
+            CGC_PREFETCH (e->_next);
             cgc_list_push_back (destination, e->_content);
+        }
     }
     return error;
 }
@@ -290,15 +532,7 @@ int cgc_list_push_front (cgc_list * const list, const void * const content)
     int error = _cgc_list_push_prelude (list, content, & e);
 
     if (! error)
-    {
-        e->_next = list->_first;
-        if (list->_first != NULL)
-            list->_first->_previous = e;
-        list->_first = e;
-        if (list->_last == NULL)
-            list->_last = e;
-        list->_size++;
-    }
+        _cgc_list_link_before (list, e, list->_first);
 
     return error;
 }
@@ -309,43 +543,35 @@ int cgc_list_push_back (cgc_list * const list, const void * const content)
     int error = _cgc_list_push_prelude (list, content, & e);
 
     if (! error)
-    {
-        e->_previous = list->_last;
-        if (list->_last != NULL)
-            list->_last->_next = e;
-        list->_last = e;
-        if (list->_first == NULL)
-            list->_first = e;
-        list->_size++;
-    }
+        _cgc_list_link_before (list, e, NULL);
 
     return error;
 }
 
 void * cgc_list_pop_front (cgc_list * const list)
 {
-    void * content = list->_first->_content;
+    cgc_list_element * const first = list->_first;
+    void * content = _cgc_list_element_take (list, first);
 
-    cgc_list_element * new_first = list->_first->_next;
-    if (new_first != NULL)
-        new_first->_previous = NULL;
-    free (list->_first);
-    list->_first = new_first;
-    list->_size--;
+    if (content != NULL)
+    {
+        _cgc_list_unlink (list, first);
+        _cgc_list_element_release (first);
+    }
 
     return content;
 }
 
 void * cgc_list_pop_back (cgc_list * const list)
 {
-    void * content = list->_last->_content;
+    cgc_list_element * const last = list->_last;
+    void * content = _cgc_list_element_take (list, last);
 
-    cgc_list_element * new_last = list->_last->_previous;
-    if (new_last != NULL)
-        new_last->_next = NULL;
-    free (list->_last);
-    list->_last = new_last;
-    list->_size--;
+    if (content != NULL)
+    {
+        _cgc_list_unlink (list, last);
+        _cgc_list_element_release (last);
+    }
 
     return content;
 }
@@ -359,19 +585,11 @@ int cgc_list_insert (cgc_list * const list, size_t i, const void * const element
         error = cgc_list_push_back (list, element);
     else
     {
-        cgc_list_element * new_e = _cgc_list_element_alloc ();
-        error = new_e != NULL ? _cgc_list_copy_content (list, new_e, element) : -2;
+        cgc_list_element * new_e = NULL;
+        error = _cgc_list_push_prelude (list, element, & new_e);
 
         if (! error)
-        {
-            cgc_list_element * target = _cgc_list_element_at (list, i);
-            cgc_list_element * previous = target->_previous;
-            new_e->_previous = previous;
-            previous->_next = new_e;
-            new_e->_next = target;
-            target->_previous = new_e;
-            list->_size++;
-        }
+            _cgc_list_link_before (list, new_e, _cgc_list_element_at (list, i));
     }
 
     return error;
@@ -388,25 +606,309 @@ int cgc_list_erase (cgc_list * const list, size_t start, size_t end)
     if (! error)
         error = start >= end || start > list->_size ? -1 : 0;
 
+    if (! error && start < list->_size)
+        _cgc_list_erase_until (list, _cgc_list_element_at (list, start), end - start);
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Splicing.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_list_concat (cgc_list * const list, cgc_list * const other)
+{
+    int error = _cgc_list_check_compatible (list, other);
+
+    if (! error)
+        _cgc_list_splice_before (list, other, NULL);
+
+    return error;
+}
+
+int cgc_list_splice (cgc_list * const list, size_t i, cgc_list * const other)
+{
+    int error = _cgc_list_check_compatible (list, other);
+
+    if (! error)
+    {
+        cgc_list_element * const next = i < list->_size ? _cgc_list_element_at (list, i) : NULL;
+        _cgc_list_splice_before (list, other, next);
+    }
+
+    return error;
+}
+
+int cgc_list_split_at (cgc_list * const list, size_t i, cgc_list * const tail)
+{
+    int error = cgc_check_pointer (list);
     if (! error)
+        error = cgc_check_pointer (tail);
+    if (! error && list == tail)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+        error = cgc_list_init (tail, list->_element_size, list->_copy_fun, list->_clean_fun);
+
+    if (! error && i < list->_size)
+    {
+        cgc_list_element * const first = _cgc_list_element_at (list, i);
+
+        tail->_first = first;
+        tail->_last = list->_last;
+        tail->_size = list->_size - i;
+
+        list->_last = first->_previous;
+        if (list->_last != NULL)
+            list->_last->_next = NULL;
+        else
+            list->_first = NULL;
+        list->_size = i;
+
+        first->_previous = NULL;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sorting.
+////////////////////////////////////////////////////////////////////////////////
+
+/* cgc_list_sort():
+ * ----------------
+ * Bottom-up merge sort. runs[k] holds either nothing or a sorted run of 2^k
+ * elements. Each element is merged into the runs like a carry propagates in a
+ * binary counter, so runs are always merged with runs of the same length.
+ * Earlier runs are always the first argument of the merges, which keeps the
+ * sort stable.
+ */
+int cgc_list_sort (cgc_list * const list, cgc_compare_function compare_fun)
+{
+    int error = cgc_check_pointer (list);
+    if (! error && compare_fun == NULL)
     {
-        cgc_list_element * current = _cgc_list_element_at (list, start);
-        if (current != NULL)
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error && list->_size > 1)
+    {
+        cgc_list_element * runs[sizeof (size_t) * 8] = { NULL };
+        size_t max_rank = 0;
+
+        cgc_list_element * e = list->_first;
+        while (e != NULL)
         {
-            cgc_list_element * before_start = current->_previous;
-            current = _cgc_list_erase_until (list, current, end - start);
+            cgc_list_element * const next = e->_next;
+            cgc_list_element * carry = e;
+            carry->_next = NULL;
+
+            size_t k;
+            for (k = 0; runs[k] != NULL; ++k)
+            {
+                carry = _cgc_list_merge_chains (runs[k], carry, compare_fun);
+                runs[k] = NULL;
+            }
+            runs[k] = carry;
+            if (k > max_rank)
+                max_rank = k;
+
+            e = next;
+        }
 
-            if (before_start == NULL)
-                list->_first = before_start;
-            else
-                before_start->_next = current;
+        cgc_list_element * sorted = NULL;
+        for (size_t k = 0; k <= max_rank; ++k)
+            if (runs[k] != NULL)
+                sorted = _cgc_list_merge_chains (runs[k], sorted, compare_fun);
+
+        list->_first = sorted;
+        _cgc_list_relink_previous (list);
+    }
+
+    return error;
+}
+
+int cgc_list_merge (cgc_list * const list, cgc_list * const other, cgc_compare_function compare_fun)
+{
+    int error = _cgc_list_check_compatible (list, other);
+    if (! error && compare_fun == NULL)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error && other->_first != NULL)
+    {
+        list->_first = _cgc_list_merge_chains (list->_first, other->_first, compare_fun);
+        list->_size += other->_size;
+        _cgc_list_relink_previous (list);
+
+        other->_first = NULL;
+        other->_last = NULL;
+        other->_size = 0;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Memory layout.
+////////////////////////////////////////////////////////////////////////////////
+
+/* cgc_list_compact():
+ * -------------------
+ * The block starts with its header, followed by one slot per element: the
+ * element itself, then its content. The header, the elements and the slots
+ * are padded to the fundamental alignment, so that contents of any type stay
+ * aligned. Each old element is released as soon as it has been moved.
+ */
+int cgc_list_compact (cgc_list * const list)
+{
+    int error = cgc_check_pointer (list);
+    struct cgc_list_block * block = NULL;
+    const size_t header = _cgc_list_align (sizeof (struct cgc_list_block));
+    const size_t offset = _cgc_list_align (sizeof (cgc_list_element));
+    size_t slot = 0;
+
+    if (! error && list->_size > 0)
+    {
+        if (list->_element_size <= SIZE_MAX - 2 * offset)
+            slot = _cgc_list_align (offset + list->_element_size);
+        if (slot == 0 || list->_size > (SIZE_MAX - header) / slot)
+        {
+            error = -2;
+            errno = ENOMEM;
+        }
+        else
+        {
+            block = malloc (header + list->_size * slot);
+            if (block == NULL)
+                error = -2;
+        }
+    }
 
-            if (current == NULL)
-                list->_last = before_start;
+    if (! error && block != NULL)
+    {
+        block->_references = list->_size;
+        char * memory = (char *) block + header;
+        cgc_list_element * previous = NULL;
+        cgc_list_element * e = list->_first;
+        while (e != NULL)
+        {
+            CGC_PREFETCH (e->_next);
+            cgc_list_element * const n = (cgc_list_element *) (void *) memory;
+            n->_content = memory + offset;
+            n->_previous = previous;
+            n->_block = block;
+            memcpy (n->_content, e->_content, list->_element_size);
+            if (previous != NULL)
+                previous->_next = n;
+            else
+                list->_first = n;
 
-            size_t deleted = end >= list->_size ? list->_size - start : end - start;
-            list->_size -= deleted;
+            cgc_list_element * const next = e->_next;
+            _cgc_list_element_release (e);
+            previous = n;
+            e = next;
+            memory += slot;
         }
+        previous->_next = NULL;
+        list->_last = previous;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Cursors.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_list_cursor cgc_list_cursor_first (cgc_list * const list)
+{
+    return (cgc_list_cursor) { ._list = list, ._element = list->_first };
+}
+
+cgc_list_cursor cgc_list_cursor_last (cgc_list * const list)
+{
+    return (cgc_list_cursor) { ._list = list, ._element = list->_last };
+}
+
+bool cgc_list_cursor_is_valid (const cgc_list_cursor * const cursor)
+{
+    return cursor->_element != NULL;
+}
+
+void cgc_list_cursor_next (cgc_list_cursor * const cursor)
+{
+    cursor->_element = cursor->_element != NULL ? cursor->_element->_next : cursor->_list->_first;
+}
+
+void cgc_list_cursor_previous (cgc_list_cursor * const cursor)
+{
+    cursor->_element = cursor->_element != NULL ? cursor->_element->_previous : cursor->_list->_last;
+}
+
+void * cgc_list_cursor_get (const cgc_list_cursor * const cursor)
+{
+    return cursor->_element->_content;
+}
+
+int cgc_list_insert_before (cgc_list_cursor * const cursor, const void * const element)
+{
+    cgc_list_element * e = NULL;
+    int error = cgc_check_pointer (cursor);
+    if (! error)
+        error = _cgc_list_push_prelude (cursor->_list, element, & e);
+
+    if (! error)
+        _cgc_list_link_before (cursor->_list, e, cursor->_element);
+
+    return error;
+}
+
+int cgc_list_insert_after (cgc_list_cursor * const cursor, const void * const element)
+{
+    cgc_list_element * e = NULL;
+    int error = cgc_check_pointer (cursor);
+    if (! error)
+        error = _cgc_list_push_prelude (cursor->_list, element, & e);
+
+    if (! error)
+    {
+        cgc_list_element * const next = cursor->_element != NULL ? cursor->_element->_next : cursor->_list->_first;
+        _cgc_list_link_before (cursor->_list, e, next);
+    }
+
+    return error;
+}
+
+int cgc_list_splice_at (cgc_list_cursor * const cursor, cgc_list * const other)
+{
+    int error = cgc_check_pointer (cursor);
+    if (! error)
+        error = _cgc_list_check_compatible (cursor->_list, other);
+
+    if (! error)
+        _cgc_list_splice_before (cursor->_list, other, cursor->_element);
+
+    return error;
+}
+
+int cgc_list_erase_at (cgc_list_cursor * const cursor)
+{
+    int error = cgc_check_pointer (cursor);
+    if (! error)
+        error = cgc_check_pointer (cursor->_element);
+
+    if (! error)
+    {
+        cgc_list_element * const e = cursor->_element;
+        cursor->_element = _cgc_list_unlink (cursor->_list, e);
+        _cgc_list_element_free (cursor->_list, e);
     }
 
     return error;
@@ -420,7 +922,10 @@ void cgc_list_map (cgc_list * const list, cgc_unary_op_function op_fun)
 {
     if (! cgc_list_is_empty (list))
         for (cgc_list_element * e = list->_first; e != NULL; e = e->_next)
+        {
+            CGC_PREFETCH (e->_next);
             op_fun (e->_content);
+        }
 }
 
 void cgc_list_fold_left (const cgc_list * const list, cgc_binary_op_left_function op_fun, void * const base_result)
@@ -429,7 +934,10 @@ void cgc_list_fold_left (const cgc_list * const list, cgc_binary_op_left_functio
     {
         op_fun (base_result, list->_first->_content);
         for (cgc_list_element * e = list->_first->_next; e != NULL; e = e->_next)
+        {
+            CGC_PREFETCH (e->_next);
             op_fun (base_result, e->_content);
+        }
     }
 }
 
@@ -439,6 +947,9 @@ void cgc_list_fold_right (const cgc_list * const list, cgc_binary_op_right_funct
     {
         op_fun (list->_first->_content, base_result);
         for (cgc_list_element * e = list->_last; e != NULL; e = e->_previous)
+        {
+            CGC_PREFETCH (e->_previous);
             op_fun (e->_content, base_result);
+        }
     }
 }
@@ -0,0 +1,395 @@
+/**
+ * \file mpmc_queue.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "cgc/mpmc_queue.h"
+
+#include <sched.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Slots.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Header of a slot. The element is stored right after it.
+ *
+ * A slot at position \c p is ready to be written when its sequence is \c p,
+ * and ready to be read when its sequence is \c p + 1. Once read, its
+ * sequence becomes \c p + capacity, the next position it will hold.
+ */
+typedef struct _cgc_mpmc_queue_slot
+{
+    atomic_size_t _sequence;    /**<- Sequence number. */
+    bool _valid;                /**<- Whether the copy of the element succeeded. */
+} _cgc_mpmc_queue_slot;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of failed attempts before yielding the processor.
+ */
+static const unsigned int _SPINS_BEFORE_YIELD = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the header of a slot.
+ * \param queue A pointer to a CGC MPMC Queue.
+ * \param position Position, not yet reduced modulo the capacity.
+ * \return A pointer to the header of the slot.
+ */
+static inline _cgc_mpmc_queue_slot * _cgc_mpmc_queue_slot_at (const cgc_mpmc_queue * const queue, size_t position)
+{
+    return (_cgc_mpmc_queue_slot *) (void *) (queue->_slots + (position & (queue->_capacity - 1)) * queue->_slot_size);
+}
+
+/**
+ * \brief Get the content of a slot.
+ * \param slot A pointer to the header of the slot.
+ * \return A pointer to the element stored in the slot.
+ */
+static inline void * _cgc_mpmc_queue_slot_content (_cgc_mpmc_queue_slot * const slot)
+{
+    return slot + 1;
+}
+
+/**
+ * \brief Signed distance between a sequence number and a position.
+ * \param sequence Sequence number.
+ * \param position Position.
+ * \return \c sequence - \c position, as a signed integer.
+ */
+static inline intptr_t _cgc_mpmc_queue_distance (size_t sequence, size_t position)
+{
+    return (intptr_t) (sequence - position);
+}
+
+/**
+ * \brief Claim a slot to write.
+ * \param queue A pointer to a CGC MPMC Queue.
+ * \param position The claimed position (output).
+ * \return A pointer to the claimed slot.
+ * \retval NULL if the queue is full.
+ */
+static _cgc_mpmc_queue_slot * _cgc_mpmc_queue_claim_push (cgc_mpmc_queue * const queue, size_t * const position)
+{
+    _cgc_mpmc_queue_slot * slot = NULL;
+    size_t tail = atomic_load_explicit (& queue->_tail, memory_order_relaxed);
+    bool done = false;
+    while (! done)
+    {
+        _cgc_mpmc_queue_slot * const candidate = _cgc_mpmc_queue_slot_at (queue, tail);
+        size_t sequence = atomic_load_explicit (& candidate->_sequence, memory_order_acquire);
+        intptr_t distance = _cgc_mpmc_queue_distance (sequence, tail);
+        if (distance == 0)
+        {
+            /* On failure, tail is updated to the current value. */
+            if (atomic_compare_exchange_weak_explicit (& queue->_tail, & tail, tail + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                slot = candidate;
+                done = true;
+            }
+        }
+        else if (distance < 0)
+            done = true;
+        else
+            tail = atomic_load_explicit (& queue->_tail, memory_order_relaxed);
+    }
+
+    * position = tail;
+    return slot;
+}
+
+/**
+ * \brief Claim a slot to read.
+ * \param queue A pointer to a CGC MPMC Queue.
+ * \param position The claimed position (output).
+ * \return A pointer to the claimed slot.
+ * \retval NULL if the queue is empty.
+ */
+static _cgc_mpmc_queue_slot * _cgc_mpmc_queue_claim_pop (cgc_mpmc_queue * const queue, size_t * const position)
+{
+    _cgc_mpmc_queue_slot * slot = NULL;
+    size_t head = atomic_load_explicit (& queue->_head, memory_order_relaxed);
+    bool done = false;
+    while (! done)
+    {
+        _cgc_mpmc_queue_slot * const candidate = _cgc_mpmc_queue_slot_at (queue, head);
+        size_t sequence = atomic_load_explicit (& candidate->_sequence, memory_order_acquire);
+        intptr_t distance = _cgc_mpmc_queue_distance (sequence, head + 1);
+        if (distance == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit (& queue->_head, & head, head + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                slot = candidate;
+                done = true;
+            }
+        }
+        else if (distance < 0)
+            done = true;
+        else
+            head = atomic_load_explicit (& queue->_head, memory_order_relaxed);
+    }
+
+    * position = head;
+    return slot;
+}
+
+/**
+ * \brief Wait before retrying a push or a pop.
+ * \param attempts Number of failed attempts so far.
+ */
+static inline void _cgc_mpmc_queue_backoff (unsigned int attempts)
+{
+    if (attempts >= _SPINS_BEFORE_YIELD)
+        sched_yield ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_mpmc_queue * cgc_mpmc_queue_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity)
+{
+    cgc_mpmc_queue * queue = aligned_alloc (_Alignof (cgc_mpmc_queue), sizeof * queue);
+    if (queue != NULL)
+    {
+        int error = cgc_mpmc_queue_init (queue, element_size, copy_fun, clean_fun, capacity);
+        if (error)
+        {
+            free (queue);
+            queue = NULL;
+        }
+    }
+
+    return queue;
+}
+
+void cgc_mpmc_queue_destroy (cgc_mpmc_queue * queue)
+{
+    if (queue != NULL)
+    {
+        cgc_mpmc_queue_clean (queue);
+        free (queue);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_mpmc_queue_init (cgc_mpmc_queue * queue, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error && capacity == 0)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    /* A single slot could not tell a full queue from an empty one. */
+    size_t power = 2;
+    while (! error && power < capacity && power <= SIZE_MAX / 2)
+        power *= 2;
+
+    size_t alignment = _Alignof (_cgc_mpmc_queue_slot);
+    size_t slot_size = (sizeof (_cgc_mpmc_queue_slot) + element_size + alignment - 1) / alignment * alignment;
+
+    if (! error)
+    {
+        queue->_slots = NULL;
+        if (power >= capacity && slot_size > element_size && power <= SIZE_MAX / slot_size)
+            queue->_slots = malloc (power * slot_size);
+        if (queue->_slots == NULL)
+            error = -2;
+    }
+
+    if (! error)
+    {
+        queue->_capacity = power;
+        queue->_slot_size = slot_size;
+        queue->_element_size = element_size;
+        queue->_copy_fun = copy_fun;
+        queue->_clean_fun = clean_fun;
+        atomic_init (& queue->_tail, 0);
+        atomic_init (& queue->_head, 0);
+        for (size_t i = 0; i < power; ++i)
+        {
+            _cgc_mpmc_queue_slot * const slot = _cgc_mpmc_queue_slot_at (queue, i);
+            atomic_init (& slot->_sequence, i);
+            slot->_valid = false;
+        }
+    }
+
+    return error;
+}
+
+int cgc_mpmc_queue_clean (cgc_mpmc_queue * queue)
+{
+    int error = cgc_mpmc_queue_clear (queue);
+    if (! error)
+    {
+        free (queue->_slots);
+        queue->_slots = NULL;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_mpmc_queue_is_empty (const cgc_mpmc_queue * queue)
+{
+    return cgc_mpmc_queue_size (queue) == 0;
+}
+
+size_t cgc_mpmc_queue_size (const cgc_mpmc_queue * queue)
+{
+    size_t head = atomic_load_explicit (& queue->_head, memory_order_acquire);
+    size_t tail = atomic_load_explicit (& queue->_tail, memory_order_acquire);
+    return _cgc_mpmc_queue_distance (tail, head) > 0 ? tail - head : 0;
+}
+
+size_t cgc_mpmc_queue_capacity (const cgc_mpmc_queue * queue)
+{
+    return queue->_capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_mpmc_queue_try_push (cgc_mpmc_queue * queue, const void * element)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    size_t position = 0;
+    _cgc_mpmc_queue_slot * slot = NULL;
+    if (! error)
+    {
+        slot = _cgc_mpmc_queue_claim_push (queue, & position);
+        if (slot == NULL)
+        {
+            error = -1;
+            errno = EAGAIN;
+        }
+    }
+
+    if (! error)
+    {
+        void * const content = _cgc_mpmc_queue_slot_content (slot);
+        if (queue->_copy_fun != NULL)
+            error = queue->_copy_fun (element, content);
+        else
+            memcpy (content, element, queue->_element_size);
+
+        /* The slot is claimed: publish it even if the copy failed, consumers
+         * will skip it. */
+        slot->_valid = ! error;
+        atomic_store_explicit (& slot->_sequence, position + 1, memory_order_release);
+    }
+
+    return error;
+}
+
+int cgc_mpmc_queue_push (cgc_mpmc_queue * queue, const void * element)
+{
+    int error = cgc_mpmc_queue_try_push (queue, element);
+    for (unsigned int attempts = 1; error == -1 && errno == EAGAIN; ++attempts)
+    {
+        _cgc_mpmc_queue_backoff (attempts);
+        error = cgc_mpmc_queue_try_push (queue, element);
+    }
+
+    return error;
+}
+
+int cgc_mpmc_queue_try_pop_into (cgc_mpmc_queue * queue, void * destination)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    bool popped = false;
+    while (! error && ! popped)
+    {
+        size_t position = 0;
+        _cgc_mpmc_queue_slot * const slot = _cgc_mpmc_queue_claim_pop (queue, & position);
+        if (slot != NULL)
+        {
+            popped = slot->_valid;
+            if (popped)
+                memcpy (destination, _cgc_mpmc_queue_slot_content (slot), queue->_element_size);
+            atomic_store_explicit (& slot->_sequence, position + queue->_capacity, memory_order_release);
+        }
+        else
+        {
+            error = -1;
+            errno = EAGAIN;
+        }
+    }
+
+    return error;
+}
+
+int cgc_mpmc_queue_pop_into (cgc_mpmc_queue * queue, void * destination)
+{
+    int error = cgc_mpmc_queue_try_pop_into (queue, destination);
+    for (unsigned int attempts = 1; error == -1 && errno == EAGAIN; ++attempts)
+    {
+        _cgc_mpmc_queue_backoff (attempts);
+        error = cgc_mpmc_queue_try_pop_into (queue, destination);
+    }
+
+    return error;
+}
+
+int cgc_mpmc_queue_clear (cgc_mpmc_queue * queue)
+{
+    int error = cgc_check_pointer (queue);
+
+    if (! error)
+    {
+        size_t head = atomic_load_explicit (& queue->_head, memory_order_relaxed);
+        size_t tail = atomic_load_explicit (& queue->_tail, memory_order_relaxed);
+        for (size_t position = head; position != tail; ++position)
+        {
+            _cgc_mpmc_queue_slot * const slot = _cgc_mpmc_queue_slot_at (queue, position);
+            if (slot->_valid && queue->_clean_fun != NULL)
+                queue->_clean_fun (_cgc_mpmc_queue_slot_content (slot));
+            atomic_store_explicit (& slot->_sequence, position + queue->_capacity, memory_order_relaxed);
+        }
+        atomic_store_explicit (& queue->_head, tail, memory_order_relaxed);
+    }
+
+    return error;
+}
@@ -0,0 +1,403 @@
+/**
+ * \file priority_queue.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/priority_queue.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get an element of the heap.
+ * \param queue A pointer to a CGC Priority queue.
+ * \param i Index of the element.
+ * \return A pointer to the element.
+ */
+static inline void * _cgc_priority_queue_at (const cgc_priority_queue * const queue, size_t i)
+{
+    return (char *) queue->_heap._content + i * queue->_heap._element_size;
+}
+
+/**
+ * \brief Compare two elements of the heap.
+ * \param queue A pointer to a CGC Priority queue.
+ * \param a A pointer to an element.
+ * \param b A pointer to an element.
+ * \retval true if \c a is lower than \c b.
+ * \retval false otherwise.
+ */
+static inline bool _cgc_priority_queue_less (const cgc_priority_queue * const queue, const void * const a, const void * const b)
+{
+    return queue->_compare_fun (a, b) < 0;
+}
+
+/**
+ * \brief Move the element held in the hole up from index \c i.
+ * \param queue A pointer to a CGC Priority queue.
+ * \param i Index of the vacant slot.
+ * \pre The slot at index \c i holds no element.
+ */
+static void _cgc_priority_queue_sift_up (cgc_priority_queue * const queue, size_t i)
+{
+    const size_t element_size = queue->_heap._element_size;
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        void * const parent_element = _cgc_priority_queue_at (queue, parent);
+        if (! _cgc_priority_queue_less (queue, queue->_hole, parent_element))
+            break;
+        memcpy (_cgc_priority_queue_at (queue, i), parent_element, element_size);
+        i = parent;
+    }
+    memcpy (_cgc_priority_queue_at (queue, i), queue->_hole, element_size);
+}
+
+/**
+ * \brief Move the element held in the hole down from index \c i.
+ * \param queue A pointer to a CGC Priority queue.
+ * \param i Index of the vacant slot.
+ * \pre The slot at index \c i holds no element.
+ */
+static void _cgc_priority_queue_sift_down (cgc_priority_queue * const queue, size_t i)
+{
+    const size_t element_size = queue->_heap._element_size;
+    const size_t size = queue->_heap._size;
+    const size_t last_parent = size / 2;
+    while (i < last_parent)
+    {
+        size_t child = 2 * i + 1;
+        void * child_element = _cgc_priority_queue_at (queue, child);
+        if (child + 1 < size)
+        {
+            void * const right = _cgc_priority_queue_at (queue, child + 1);
+            if (_cgc_priority_queue_less (queue, right, child_element))
+            {
+                child++;
+                child_element = right;
+            }
+        }
+        if (! _cgc_priority_queue_less (queue, child_element, queue->_hole))
+            break;
+        memcpy (_cgc_priority_queue_at (queue, i), child_element, element_size);
+        i = child;
+    }
+    memcpy (_cgc_priority_queue_at (queue, i), queue->_hole, element_size);
+}
+
+/**
+ * \brief Restore the heap property over the whole storage, bottom-up.
+ * \param queue A pointer to a CGC Priority queue.
+ */
+static void _cgc_priority_queue_build (cgc_priority_queue * const queue)
+{
+    for (size_t i = queue->_heap._size / 2; i-- > 0;)
+    {
+        memcpy (queue->_hole, _cgc_priority_queue_at (queue, i), queue->_heap._element_size);
+        _cgc_priority_queue_sift_down (queue, i);
+    }
+}
+
+/**
+ * \brief Make room for \c count more elements.
+ * \param queue A pointer to a CGC Priority queue.
+ * \param count Number of elements about to be pushed.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of realloc.
+ * \note The storage at least doubles, so that a sequence of pushes costs
+ * amortized constant time instead of following the vector's size step.
+ */
+static int _cgc_priority_queue_make_room (cgc_priority_queue * const queue, size_t count)
+{
+    int error = 0;
+    const size_t size = queue->_heap._size;
+    const size_t max_size = queue->_heap._max_size;
+    if (count > SIZE_MAX - size)
+    {
+        error = -2;
+        errno = ENOMEM;
+    }
+    else if (size + count > max_size)
+    {
+        size_t doubled = max_size <= SIZE_MAX / 2 ? max_size * 2 : SIZE_MAX;
+        error = cgc_vector_reserve (& queue->_heap, size + count > doubled ? size + count : doubled);
+    }
+
+    return error;
+}
+
+/**
+ * \brief Copy an element at the end of the storage.
+ * \param queue A pointer to a CGC Priority queue.
+ * \param element A pointer to the element.
+ * \retval 0 in case of success.
+ * \retval <=-3 in case of failure because of the copy function.
+ * \pre There is room for one more element.
+ * \note The heap property is not restored.
+ */
+static int _cgc_priority_queue_append (cgc_priority_queue * const queue, const void * const element)
+{
+    int error = 0;
+    void * const slot = _cgc_priority_queue_at (queue, queue->_heap._size);
+    if (queue->_heap._copy_fun != NULL)
+        error = queue->_heap._copy_fun (element, slot);
+    else
+        memcpy (slot, element, queue->_heap._element_size);
+
+    if (! error)
+        queue->_heap._size++;
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_priority_queue * cgc_priority_queue_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, cgc_compare_function compare_fun)
+{
+    cgc_priority_queue * queue = malloc (sizeof * queue);
+    if (queue != NULL)
+    {
+        int error = cgc_priority_queue_init (queue, element_size, copy_fun, clean_fun, compare_fun);
+        if (error)
+        {
+            free (queue);
+            queue = NULL;
+        }
+    }
+
+    return queue;
+}
+
+void cgc_priority_queue_destroy (cgc_priority_queue * queue)
+{
+    if (queue != NULL)
+    {
+        cgc_priority_queue_clean (queue);
+        free (queue);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_priority_queue_init (cgc_priority_queue * queue, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, cgc_compare_function compare_fun)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error && (compare_fun == NULL || element_size == 0))
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        queue->_compare_fun = compare_fun;
+        queue->_hole = malloc (element_size);
+        if (queue->_hole == NULL)
+            error = -2;
+    }
+    if (! error)
+    {
+        error = cgc_vector_init (& queue->_heap, element_size, copy_fun, clean_fun, 0);
+        if (error)
+            free (queue->_hole);
+    }
+
+    return error;
+}
+
+int cgc_priority_queue_clean (cgc_priority_queue * queue)
+{
+    int error = cgc_priority_queue_clear (queue);
+    if (! error)
+    {
+        free (queue->_heap._content);
+        queue->_heap._content = NULL;
+        queue->_heap._max_size = 0;
+        free (queue->_hole);
+        queue->_hole = NULL;
+    }
+
+    return error;
+}
+
+int cgc_priority_queue_reserve (cgc_priority_queue * queue, size_t capacity)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_vector_reserve (& queue->_heap, capacity);
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_priority_queue_is_empty (const cgc_priority_queue * queue)
+{
+    return cgc_vector_is_empty (& queue->_heap);
+}
+
+size_t cgc_priority_queue_size (const cgc_priority_queue * queue)
+{
+    return cgc_vector_size (& queue->_heap);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+void * cgc_priority_queue_top (const cgc_priority_queue * queue)
+{
+    return _cgc_priority_queue_at (queue, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_priority_queue_push (cgc_priority_queue * queue, const void * element)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (element);
+    if (! error)
+        error = _cgc_priority_queue_make_room (queue, 1);
+    if (! error)
+        error = _cgc_priority_queue_append (queue, element);
+
+    if (! error)
+    {
+        size_t last = queue->_heap._size - 1;
+        memcpy (queue->_hole, _cgc_priority_queue_at (queue, last), queue->_heap._element_size);
+        _cgc_priority_queue_sift_up (queue, last);
+    }
+
+    return error;
+}
+
+int cgc_priority_queue_push_n (cgc_priority_queue * queue, const void * elements, size_t count)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (elements);
+    if (! error)
+        error = _cgc_priority_queue_make_room (queue, count);
+
+    if (! error)
+    {
+        const char * element = elements;
+        const size_t element_size = queue->_heap._element_size;
+        const bool rebuild = count > queue->_heap._size;
+        for (size_t i = 0; ! error && i < count; ++i, element += element_size)
+        {
+            error = _cgc_priority_queue_append (queue, element);
+            if (! error && ! rebuild)
+            {
+                size_t last = queue->_heap._size - 1;
+                memcpy (queue->_hole, _cgc_priority_queue_at (queue, last), element_size);
+                _cgc_priority_queue_sift_up (queue, last);
+            }
+        }
+
+        if (rebuild)
+            _cgc_priority_queue_build (queue);
+    }
+
+    return error;
+}
+
+void * cgc_priority_queue_pop (cgc_priority_queue * queue)
+{
+    void * element = NULL;
+    if (queue != NULL)
+    {
+        element = malloc (queue->_heap._element_size);
+        if (element != NULL && cgc_priority_queue_pop_into (queue, element) != 0)
+        {
+            free (element);
+            element = NULL;
+        }
+    }
+
+    return element;
+}
+
+int cgc_priority_queue_pop_into (cgc_priority_queue * queue, void * destination)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (destination);
+    if (! error && queue->_heap._size == 0)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        const size_t element_size = queue->_heap._element_size;
+        memcpy (destination, _cgc_priority_queue_at (queue, 0), element_size);
+        queue->_heap._size--;
+        if (queue->_heap._size > 0)
+        {
+            memcpy (queue->_hole, _cgc_priority_queue_at (queue, queue->_heap._size), element_size);
+            _cgc_priority_queue_sift_down (queue, 0);
+        }
+    }
+
+    return error;
+}
+
+int cgc_priority_queue_heapify (cgc_priority_queue * queue, cgc_vector * vector)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (vector);
+    if (! error && ! cgc_vector_is_compatible (& queue->_heap, vector))
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+        error = cgc_vector_clear (& queue->_heap);
+    if (! error)
+        error = cgc_vector_swap (& queue->_heap, vector);
+    if (! error)
+        _cgc_priority_queue_build (queue);
+
+    return error;
+}
+
+int cgc_priority_queue_clear (cgc_priority_queue * queue)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_vector_clear (& queue->_heap);
+
+    return error;
+}
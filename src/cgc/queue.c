@@ -23,18 +23,96 @@
  */
 #include "cgc/queue.h"
 
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initial number of elements of the buffer.
+ * \note Must be a power of two.
+ */
+static const size_t _DEFAULT_CAPACITY = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get an element of a queue.
+ * \param queue A pointer to a CGC Queue.
+ * \param i Index of the element, from the front.
+ * \return A pointer to the element.
+ */
+static inline void * _cgc_queue_at (const cgc_queue * const queue, size_t i)
+{
+    return queue->_content + ((queue->_first + i) & (queue->_capacity - 1)) * queue->_element_size;
+}
+
+/**
+ * \brief Resize the buffer.
+ * \param queue A pointer to a CGC Queue.
+ * \param capacity The new number of elements. Must be a power of two, greater
+ * than the current capacity.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of realloc.
+ * The elements which wrapped around the end of the old buffer are moved
+ * after the others.
+ */
+static int _cgc_queue_grow (cgc_queue * const queue, size_t capacity)
+{
+    int error = 0;
+    char * content = NULL;
+    if (queue->_element_size == 0 || capacity <= SIZE_MAX / queue->_element_size)
+        content = realloc (queue->_content, capacity * queue->_element_size);
+
+    if (content != NULL)
+    {
+        if (queue->_first + queue->_size > queue->_capacity)
+        {
+            size_t wrapped = queue->_first + queue->_size - queue->_capacity;
+            memcpy (content + queue->_capacity * queue->_element_size, content, wrapped * queue->_element_size);
+        }
+        queue->_content = content;
+        queue->_capacity = capacity;
+    }
+    else
+        error = -2;
+
+    return error;
+}
+
+/**
+ * \brief Get the number of elements stored from index \c i to the end of the
+ * buffer.
+ * \param queue A pointer to a CGC Queue.
+ * \param i Index of an element, from the front.
+ * \return Number of contiguous slots starting at \c i.
+ */
+static inline size_t _cgc_queue_contiguous (const cgc_queue * const queue, size_t i)
+{
+    return queue->_capacity - ((queue->_first + i) & (queue->_capacity - 1));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Dynamic creation and destruction.
 ////////////////////////////////////////////////////////////////////////////////
 
 cgc_queue * cgc_queue_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
 {
-    return cgc_list_create (element_size, copy_fun, clean_fun);
+    cgc_queue * queue = malloc (sizeof * queue);
+    if (queue != NULL)
+        cgc_queue_init (queue, element_size, copy_fun, clean_fun);
+
+    return queue;
 }
 
 void cgc_queue_destroy (cgc_queue * queue)
 {
-    cgc_list_destroy (queue);
+    if (queue != NULL)
+    {
+        cgc_queue_clean (queue);
+        free (queue);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -43,12 +121,47 @@ void cgc_queue_destroy (cgc_queue * queue)
 
 int cgc_queue_init (cgc_queue * queue, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
 {
-    return cgc_list_init (queue, element_size, copy_fun, clean_fun);
+    int error = cgc_check_pointer (queue);
+
+    if (! error)
+    {
+        queue->_content = NULL;
+        queue->_first = 0;
+        queue->_size = 0;
+        queue->_capacity = 0;
+        queue->_element_size = element_size;
+        queue->_copy_fun = copy_fun;
+        queue->_clean_fun = clean_fun;
+    }
+
+    return error;
 }
 
 int cgc_queue_clean (cgc_queue * queue)
 {
-    return cgc_list_clean (queue);
+    int error = cgc_queue_clear (queue);
+    if (! error)
+    {
+        free (queue->_content);
+        queue->_content = NULL;
+        queue->_capacity = 0;
+    }
+
+    return error;
+}
+
+int cgc_queue_reserve (cgc_queue * queue, size_t capacity)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error && capacity > queue->_capacity)
+    {
+        size_t power = queue->_capacity == 0 ? _DEFAULT_CAPACITY : queue->_capacity;
+        while (power < capacity && power <= SIZE_MAX / 2)
+            power *= 2;
+        error = power >= capacity ? _cgc_queue_grow (queue, power) : -2;
+    }
+
+    return error;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,12 +170,32 @@ int cgc_queue_clean (cgc_queue * queue)
 
 cgc_queue * cgc_queue_copy (const cgc_queue * queue)
 {
-    return cgc_list_copy (queue);
+    cgc_queue * copy = NULL;
+    if (queue != NULL)
+    {
+        copy = cgc_queue_create (queue->_element_size, queue->_copy_fun, queue->_clean_fun);
+        if (copy != NULL)
+            cgc_queue_copy_into (queue, copy);
+    }
+
+    return copy;
 }
 
 int cgc_queue_copy_into (const cgc_queue * original, cgc_queue * destination)
 {
-    return cgc_list_copy_into (original, destination);
+    int error = cgc_check_pointer (original);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    if (! error)
+        error = cgc_queue_init (destination, original->_element_size, original->_copy_fun, original->_clean_fun);
+    if (! error)
+        error = cgc_queue_reserve (destination, original->_size);
+
+    for (size_t i = 0; ! error && i < original->_size; ++i)
+        error = cgc_queue_push (destination, _cgc_queue_at (original, i));
+
+    return error;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -71,7 +204,18 @@ int cgc_queue_copy_into (const cgc_queue * original, cgc_queue * destination)
 
 int cgc_queue_swap (cgc_queue * a, cgc_queue * b)
 {
-    return cgc_list_swap (a, b);
+    int error = cgc_check_pointer (a);
+    if (! error)
+        error = cgc_check_pointer (b);
+
+    if (! error)
+    {
+        cgc_queue tmp = * a;
+        * a = * b;
+        * b = tmp;
+    }
+
+    return error;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,12 +224,12 @@ int cgc_queue_swap (cgc_queue * a, cgc_queue * b)
 
 bool cgc_queue_is_empty (const cgc_queue * queue)
 {
-    return cgc_list_is_empty (queue);
+    return queue->_size == 0;
 }
 
 size_t cgc_queue_size (const cgc_queue * queue)
 {
-    return cgc_list_size (queue);
+    return queue->_size;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -94,12 +238,12 @@ size_t cgc_queue_size (const cgc_queue * queue)
 
 void * cgc_queue_front (const cgc_queue * queue)
 {
-    return cgc_list_front (queue);
+    return _cgc_queue_at (queue, 0);
 }
 
 void * cgc_queue_back (const cgc_queue * queue)
 {
-    return cgc_list_back (queue);
+    return _cgc_queue_at (queue, queue->_size - 1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -108,15 +252,140 @@ void * cgc_queue_back (const cgc_queue * queue)
 
 int cgc_queue_push (cgc_queue * queue, const void * element)
 {
-    return cgc_list_push_back (queue, element);
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    if (! error && queue->_size == queue->_capacity)
+    {
+        size_t capacity = queue->_capacity == 0 ? _DEFAULT_CAPACITY
+            : queue->_capacity <= SIZE_MAX / 2 ? queue->_capacity * 2 : 0;
+        error = capacity > queue->_capacity ? _cgc_queue_grow (queue, capacity) : -2;
+    }
+
+    if (! error)
+    {
+        void * const content = _cgc_queue_at (queue, queue->_size);
+        if (queue->_copy_fun != NULL)
+            error = queue->_copy_fun (element, content);
+        else
+            memcpy (content, element, queue->_element_size);
+
+        if (! error)
+            queue->_size++;
+    }
+
+    return error;
 }
 
 void * cgc_queue_pop (cgc_queue * queue)
 {
-    return cgc_list_pop_front (queue);
+    void * element = NULL;
+    if (queue != NULL)
+    {
+        element = malloc (queue->_element_size);
+        if (element != NULL && cgc_queue_pop_into (queue, element) != 0)
+        {
+            free (element);
+            element = NULL;
+        }
+    }
+
+    return element;
+}
+
+int cgc_queue_pop_into (cgc_queue * queue, void * destination)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (destination);
+    if (! error && queue->_size == 0)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        memcpy (destination, _cgc_queue_at (queue, 0), queue->_element_size);
+        queue->_first = (queue->_first + 1) & (queue->_capacity - 1);
+        queue->_size--;
+    }
+
+    return error;
+}
+
+int cgc_queue_push_n (cgc_queue * queue, const void * elements, size_t count)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (elements);
+    if (! error && count > SIZE_MAX - queue->_size)
+    {
+        error = -2;
+        errno = ENOMEM;
+    }
+    if (! error && count > 0)
+        error = cgc_queue_reserve (queue, queue->_size + count);
+
+    if (! error && count > 0 && queue->_copy_fun == NULL)
+    {
+        const char * const source = elements;
+        size_t head = _cgc_queue_contiguous (queue, queue->_size);
+        if (head > count)
+            head = count;
+        memcpy (_cgc_queue_at (queue, queue->_size), source, head * queue->_element_size);
+        memcpy (queue->_content, source + head * queue->_element_size, (count - head) * queue->_element_size);
+        queue->_size += count;
+    }
+    else if (! error)
+    {
+        const char * element = elements;
+        for (size_t i = 0; ! error && i < count; ++i, element += queue->_element_size)
+        {
+            error = queue->_copy_fun (element, _cgc_queue_at (queue, queue->_size));
+            if (! error)
+                queue->_size++;
+        }
+    }
+
+    return error;
+}
+
+size_t cgc_queue_pop_n (cgc_queue * queue, void * destination, size_t max)
+{
+    size_t count = 0;
+    if (queue != NULL && destination != NULL)
+    {
+        count = queue->_size < max ? queue->_size : max;
+        if (count > 0)
+        {
+            char * const target = destination;
+            size_t head = _cgc_queue_contiguous (queue, 0);
+            if (head > count)
+                head = count;
+            memcpy (target, _cgc_queue_at (queue, 0), head * queue->_element_size);
+            memcpy (target + head * queue->_element_size, queue->_content, (count - head) * queue->_element_size);
+            queue->_first = (queue->_first + count) & (queue->_capacity - 1);
+            queue->_size -= count;
+        }
+    }
+
+    return count;
 }
 
 int cgc_queue_clear (cgc_queue * queue)
 {
-    return cgc_list_clear (queue);
+    int error = cgc_check_pointer (queue);
+
+    if (! error)
+    {
+        if (queue->_clean_fun != NULL)
+            for (size_t i = 0; i < queue->_size; ++i)
+                queue->_clean_fun (_cgc_queue_at (queue, i));
+        queue->_first = 0;
+        queue->_size = 0;
+    }
+
+    return error;
 }
@@ -0,0 +1,1178 @@
+/**
+ * \file radix_tree.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/radix_tree.h"
+
+#if defined (__SSE2__) && defined (__GNUC__)
+#include <emmintrin.h>
+#define _CGC_RADIX_TREE_SSE2
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of prefix bytes stored in a node.
+ *
+ * Longer prefixes are only partially stored: their remaining bytes are read
+ * from a leaf below the node when they are needed.
+ */
+#define _MAX_PREFIX 12
+
+/**
+ * \brief Types of nodes.
+ */
+enum _cgc_radix_tree_type
+{
+    _LEAF,
+    _NODE4,
+    _NODE16,
+    _NODE48,
+    _NODE256,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Nodes.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Leaf of a radix tree.
+ *
+ * The value is stored at the value offset of the tree, and is followed by
+ * the key.
+ */
+typedef struct _cgc_radix_tree_leaf
+{
+    uint8_t _type;                      /**<- _LEAF. */
+    size_t _length;                     /**<- Length of the key. */
+} _cgc_radix_tree_leaf;
+
+/**
+ * \brief Header of the inner nodes.
+ */
+struct cgc_radix_tree_node
+{
+    uint8_t _type;                      /**<- Type of node. */
+    uint16_t _count;                    /**<- Number of children. */
+    unsigned char _prefix[_MAX_PREFIX]; /**<- First bytes of the prefix. */
+    size_t _prefix_length;              /**<- Length of the prefix. */
+    _cgc_radix_tree_leaf * _leaf;       /**<- Entry whose key ends here. */
+};
+
+/**
+ * \brief Node with up to 4 children, sorted by key.
+ */
+typedef struct _cgc_radix_tree_node4
+{
+    cgc_radix_tree_node _header;            /**<- Header. */
+    unsigned char _keys[4];                 /**<- Keys. */
+    cgc_radix_tree_node * _children[4];     /**<- Children. */
+} _cgc_radix_tree_node4;
+
+/**
+ * \brief Node with up to 16 children, sorted by key.
+ */
+typedef struct _cgc_radix_tree_node16
+{
+    cgc_radix_tree_node _header;            /**<- Header. */
+    unsigned char _keys[16];                /**<- Keys. */
+    cgc_radix_tree_node * _children[16];    /**<- Children. */
+} _cgc_radix_tree_node16;
+
+/**
+ * \brief Node with up to 48 children, indexed by key.
+ */
+typedef struct _cgc_radix_tree_node48
+{
+    cgc_radix_tree_node _header;            /**<- Header. */
+    unsigned char _indices[256];            /**<- Index of each key plus one. */
+    cgc_radix_tree_node * _children[48];    /**<- Children. */
+} _cgc_radix_tree_node48;
+
+/**
+ * \brief Node with up to 256 children.
+ */
+typedef struct _cgc_radix_tree_node256
+{
+    cgc_radix_tree_node _header;            /**<- Header. */
+    cgc_radix_tree_node * _children[256];   /**<- Children. */
+} _cgc_radix_tree_node256;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get the type of a node or of a leaf.
+ * \param node Node or leaf.
+ * \return Type.
+ * \note Leaves and nodes both start with their type.
+ */
+static inline uint8_t _cgc_radix_tree_type (const void * const node)
+{
+    return * (const uint8_t *) node;
+}
+
+/**
+ * \brief Check whether a child is a leaf.
+ * \param node Child.
+ * \retval true if the child is a leaf.
+ * \retval false if it is an inner node.
+ */
+static inline bool _cgc_radix_tree_is_leaf (const void * const node)
+{
+    return _cgc_radix_tree_type (node) == _LEAF;
+}
+
+/**
+ * \brief Get the value of a leaf.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param leaf Leaf.
+ * \return A pointer to the value.
+ */
+static inline void * _cgc_radix_tree_value (const cgc_radix_tree * const tree, _cgc_radix_tree_leaf * const leaf)
+{
+    return (char *) leaf + tree->_value_offset;
+}
+
+/**
+ * \brief Get the key of a leaf.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param leaf Leaf.
+ * \return A pointer to the key.
+ */
+static inline const unsigned char * _cgc_radix_tree_key (const cgc_radix_tree * const tree, const _cgc_radix_tree_leaf * const leaf)
+{
+    return (const unsigned char *) leaf + tree->_value_offset + tree->_element_size;
+}
+
+/**
+ * \brief Check whether a leaf holds a key.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param leaf Leaf.
+ * \param key Key.
+ * \param length Length of the key.
+ * \retval true if the key of the leaf is \c key.
+ * \retval false otherwise.
+ */
+static inline bool _cgc_radix_tree_matches (const cgc_radix_tree * const tree, const _cgc_radix_tree_leaf * const leaf, const unsigned char * const key, size_t length)
+{
+    return leaf->_length == length && (length == 0 || memcmp (_cgc_radix_tree_key (tree, leaf), key, length) == 0);
+}
+
+/**
+ * \brief Allocate a leaf holding a copy of a key and of a value.
+ * \param[in] tree A pointer to a CGC Radix tree.
+ * \param[in] key Key.
+ * \param[in] length Length of the key.
+ * \param[in] value Value.
+ * \param[out] leaf New leaf.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of malloc.
+ * \retval -3 or lower if the copy function failed.
+ */
+static int _cgc_radix_tree_new_leaf (const cgc_radix_tree * const tree, const unsigned char * const key, size_t length, const void * const value, _cgc_radix_tree_leaf ** const leaf)
+{
+    int error = 0;
+    size_t header = tree->_value_offset + tree->_element_size;
+    _cgc_radix_tree_leaf * new_leaf = NULL;
+    if (length <= SIZE_MAX - header)
+        new_leaf = malloc (header + length);
+
+    if (new_leaf != NULL)
+    {
+        new_leaf->_type = _LEAF;
+        new_leaf->_length = length;
+        if (length > 0)
+            memcpy ((unsigned char *) new_leaf + header, key, length);
+        if (tree->_copy_fun != NULL)
+            error = tree->_copy_fun (value, _cgc_radix_tree_value (tree, new_leaf));
+        else
+            memcpy (_cgc_radix_tree_value (tree, new_leaf), value, tree->_element_size);
+
+        if (error)
+        {
+            free (new_leaf);
+            new_leaf = NULL;
+        }
+    }
+    else
+        error = -2;
+
+    * leaf = new_leaf;
+    return error;
+}
+
+/**
+ * \brief Clean and free a leaf.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param leaf Leaf.
+ */
+static void _cgc_radix_tree_free_leaf (const cgc_radix_tree * const tree, _cgc_radix_tree_leaf * const leaf)
+{
+    if (tree->_clean_fun != NULL)
+        tree->_clean_fun (_cgc_radix_tree_value (tree, leaf));
+    free (leaf);
+}
+
+/**
+ * \brief Allocate an empty inner node.
+ * \param type Type of the node.
+ * \return A pointer to the node, or \c NULL in case of failure.
+ */
+static cgc_radix_tree_node * _cgc_radix_tree_new_node (uint8_t type)
+{
+    size_t size = sizeof (_cgc_radix_tree_node4);
+    switch (type)
+    {
+        case _NODE16:
+            size = sizeof (_cgc_radix_tree_node16);
+            break;
+        case _NODE48:
+            size = sizeof (_cgc_radix_tree_node48);
+            break;
+        case _NODE256:
+            size = sizeof (_cgc_radix_tree_node256);
+            break;
+        default:
+            break;
+    }
+
+    cgc_radix_tree_node * node = calloc (1, size);
+    if (node != NULL)
+        node->_type = type;
+    return node;
+}
+
+/**
+ * \brief Free a node and everything below it.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param node Node or leaf, may be \c NULL.
+ */
+static void _cgc_radix_tree_free_node (const cgc_radix_tree * const tree, cgc_radix_tree_node * const node)
+{
+    if (node == NULL)
+        return;
+    if (_cgc_radix_tree_is_leaf (node))
+    {
+        _cgc_radix_tree_free_leaf (tree, (_cgc_radix_tree_leaf *) node);
+        return;
+    }
+
+    if (node->_leaf != NULL)
+        _cgc_radix_tree_free_leaf (tree, node->_leaf);
+    switch (node->_type)
+    {
+        case _NODE4:
+            for (size_t i = 0; i < node->_count; ++i)
+                _cgc_radix_tree_free_node (tree, ((_cgc_radix_tree_node4 *) node)->_children[i]);
+            break;
+        case _NODE16:
+            for (size_t i = 0; i < node->_count; ++i)
+                _cgc_radix_tree_free_node (tree, ((_cgc_radix_tree_node16 *) node)->_children[i]);
+            break;
+        case _NODE48:
+            for (size_t i = 0; i < 48; ++i)
+                _cgc_radix_tree_free_node (tree, ((_cgc_radix_tree_node48 *) node)->_children[i]);
+            break;
+        case _NODE256:
+            for (size_t i = 0; i < 256; ++i)
+                _cgc_radix_tree_free_node (tree, ((_cgc_radix_tree_node256 *) node)->_children[i]);
+            break;
+        default:
+            break;
+    }
+    free (node);
+}
+
+/**
+ * \brief Find the child of a node for a byte.
+ * \param node Inner node.
+ * \param byte Byte.
+ * \return A pointer to the child pointer, or \c NULL if there is no child.
+ */
+static cgc_radix_tree_node ** _cgc_radix_tree_find_child (cgc_radix_tree_node * const node, unsigned char byte)
+{
+    switch (node->_type)
+    {
+        case _NODE4:
+        {
+            _cgc_radix_tree_node4 * const node4 = (_cgc_radix_tree_node4 *) node;
+            for (size_t i = 0; i < node->_count; ++i)
+                if (node4->_keys[i] == byte)
+                    return & node4->_children[i];
+            break;
+        }
+        case _NODE16:
+        {
+            _cgc_radix_tree_node16 * const node16 = (_cgc_radix_tree_node16 *) node;
+#if defined (_CGC_RADIX_TREE_SSE2)
+            /* Compare the 16 keys at once, and ignore the unused ones. */
+            __m128i keys = _mm_loadu_si128 ((const __m128i *) (const void *) node16->_keys);
+            __m128i matches = _mm_cmpeq_epi8 (keys, _mm_set1_epi8 ((char) byte));
+            unsigned int mask = (unsigned int) _mm_movemask_epi8 (matches) & ((1u << node->_count) - 1);
+            if (mask != 0)
+                return & node16->_children[__builtin_ctz (mask)];
+#else
+            for (size_t i = 0; i < node->_count && node16->_keys[i] <= byte; ++i)
+                if (node16->_keys[i] == byte)
+                    return & node16->_children[i];
+#endif
+            break;
+        }
+        case _NODE48:
+        {
+            _cgc_radix_tree_node48 * const node48 = (_cgc_radix_tree_node48 *) node;
+            if (node48->_indices[byte] != 0)
+                return & node48->_children[node48->_indices[byte] - 1];
+            break;
+        }
+        case _NODE256:
+        {
+            _cgc_radix_tree_node256 * const node256 = (_cgc_radix_tree_node256 *) node;
+            if (node256->_children[byte] != NULL)
+                return & node256->_children[byte];
+            break;
+        }
+        default:
+            break;
+    }
+    return NULL;
+}
+
+/**
+ * \brief Insert a child into sorted arrays of keys and children.
+ * \param keys Keys.
+ * \param children Children.
+ * \param count Number of children, lower than the capacity of the arrays.
+ * \param byte Key of the child.
+ * \param child Child.
+ */
+static void _cgc_radix_tree_insert_sorted (unsigned char * const keys, cgc_radix_tree_node ** const children, size_t count, unsigned char byte, cgc_radix_tree_node * const child)
+{
+    size_t i = 0;
+    while (i < count && keys[i] < byte)
+        ++i;
+    memmove (keys + i + 1, keys + i, count - i);
+    memmove (children + i + 1, children + i, (count - i) * sizeof * children);
+    keys[i] = byte;
+    children[i] = child;
+}
+
+/**
+ * \brief Move the children of a node into a node of another type.
+ * \param node Node.
+ * \param type Type of the new node.
+ * \return A pointer to the new node, or \c NULL in case of failure.
+ * \note The old node is freed in case of success.
+ * \pre The new node can hold the children of the old one.
+ */
+static cgc_radix_tree_node * _cgc_radix_tree_resize (cgc_radix_tree_node * const node, uint8_t type)
+{
+    cgc_radix_tree_node * new_node = _cgc_radix_tree_new_node (type);
+    if (new_node == NULL)
+        return NULL;
+
+    * new_node = * node;
+    new_node->_type = type;
+
+    /* Gather the children in key order. */
+    unsigned char keys[256];
+    cgc_radix_tree_node * children[256];
+    size_t count = 0;
+    switch (node->_type)
+    {
+        case _NODE4:
+            count = node->_count;
+            memcpy (keys, ((_cgc_radix_tree_node4 *) node)->_keys, count);
+            memcpy (children, ((_cgc_radix_tree_node4 *) node)->_children, count * sizeof * children);
+            break;
+        case _NODE16:
+            count = node->_count;
+            memcpy (keys, ((_cgc_radix_tree_node16 *) node)->_keys, count);
+            memcpy (children, ((_cgc_radix_tree_node16 *) node)->_children, count * sizeof * children);
+            break;
+        case _NODE48:
+        {
+            _cgc_radix_tree_node48 * const node48 = (_cgc_radix_tree_node48 *) node;
+            for (size_t byte = 0; byte < 256; ++byte)
+                if (node48->_indices[byte] != 0)
+                {
+                    keys[count] = (unsigned char) byte;
+                    children[count++] = node48->_children[node48->_indices[byte] - 1];
+                }
+            break;
+        }
+        case _NODE256:
+        {
+            _cgc_radix_tree_node256 * const node256 = (_cgc_radix_tree_node256 *) node;
+            for (size_t byte = 0; byte < 256; ++byte)
+                if (node256->_children[byte] != NULL)
+                {
+                    keys[count] = (unsigned char) byte;
+                    children[count++] = node256->_children[byte];
+                }
+            break;
+        }
+        default:
+            break;
+    }
+
+    switch (type)
+    {
+        case _NODE4:
+            memcpy (((_cgc_radix_tree_node4 *) new_node)->_keys, keys, count);
+            memcpy (((_cgc_radix_tree_node4 *) new_node)->_children, children, count * sizeof * children);
+            break;
+        case _NODE16:
+            memcpy (((_cgc_radix_tree_node16 *) new_node)->_keys, keys, count);
+            memcpy (((_cgc_radix_tree_node16 *) new_node)->_children, children, count * sizeof * children);
+            break;
+        case _NODE48:
+        {
+            _cgc_radix_tree_node48 * const node48 = (_cgc_radix_tree_node48 *) new_node;
+            for (size_t i = 0; i < count; ++i)
+            {
+                node48->_indices[keys[i]] = (unsigned char) (i + 1);
+                node48->_children[i] = children[i];
+            }
+            break;
+        }
+        case _NODE256:
+            for (size_t i = 0; i < count; ++i)
+                ((_cgc_radix_tree_node256 *) new_node)->_children[keys[i]] = children[i];
+            break;
+        default:
+            break;
+    }
+
+    free (node);
+    return new_node;
+}
+
+/**
+ * \brief Add a child to a node, growing the node if it is full.
+ * \param ref Pointer to the node.
+ * \param byte Key of the child.
+ * \param child Child.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of malloc.
+ * \pre The node has no child for \c byte.
+ */
+static int _cgc_radix_tree_add_child (cgc_radix_tree_node ** const ref, unsigned char byte, cgc_radix_tree_node * const child)
+{
+    cgc_radix_tree_node * node = * ref;
+    uint8_t bigger = node->_type;
+    if ((node->_type == _NODE4 && node->_count == 4)
+        || (node->_type == _NODE16 && node->_count == 16)
+        || (node->_type == _NODE48 && node->_count == 48))
+    {
+        bigger = (uint8_t) (node->_type + 1);
+        node = _cgc_radix_tree_resize (node, bigger);
+        if (node == NULL)
+            return -2;
+        * ref = node;
+    }
+
+    switch (node->_type)
+    {
+        case _NODE4:
+            _cgc_radix_tree_insert_sorted (((_cgc_radix_tree_node4 *) node)->_keys, ((_cgc_radix_tree_node4 *) node)->_children, node->_count, byte, child);
+            break;
+        case _NODE16:
+            _cgc_radix_tree_insert_sorted (((_cgc_radix_tree_node16 *) node)->_keys, ((_cgc_radix_tree_node16 *) node)->_children, node->_count, byte, child);
+            break;
+        case _NODE48:
+        {
+            _cgc_radix_tree_node48 * const node48 = (_cgc_radix_tree_node48 *) node;
+            size_t i = 0;
+            while (node48->_children[i] != NULL)
+                ++i;
+            node48->_children[i] = child;
+            node48->_indices[byte] = (unsigned char) (i + 1);
+            break;
+        }
+        case _NODE256:
+            ((_cgc_radix_tree_node256 *) node)->_children[byte] = child;
+            break;
+        default:
+            break;
+    }
+    ++node->_count;
+    return 0;
+}
+
+/**
+ * \brief Remove the child of a node for a byte.
+ * \param node Node.
+ * \param byte Key of the child.
+ * \pre The node has a child for \c byte.
+ */
+static void _cgc_radix_tree_remove_child (cgc_radix_tree_node * const node, unsigned char byte)
+{
+    switch (node->_type)
+    {
+        case _NODE4:
+        case _NODE16:
+        {
+            unsigned char * const keys = node->_type == _NODE4 ? ((_cgc_radix_tree_node4 *) node)->_keys : ((_cgc_radix_tree_node16 *) node)->_keys;
+            cgc_radix_tree_node ** const children = node->_type == _NODE4 ? ((_cgc_radix_tree_node4 *) node)->_children : ((_cgc_radix_tree_node16 *) node)->_children;
+            size_t i = 0;
+            while (keys[i] != byte)
+                ++i;
+            memmove (keys + i, keys + i + 1, node->_count - i - 1);
+            memmove (children + i, children + i + 1, (node->_count - i - 1) * sizeof * children);
+            break;
+        }
+        case _NODE48:
+        {
+            _cgc_radix_tree_node48 * const node48 = (_cgc_radix_tree_node48 *) node;
+            node48->_children[node48->_indices[byte] - 1] = NULL;
+            node48->_indices[byte] = 0;
+            break;
+        }
+        case _NODE256:
+            ((_cgc_radix_tree_node256 *) node)->_children[byte] = NULL;
+            break;
+        default:
+            break;
+    }
+    --node->_count;
+}
+
+/**
+ * \brief Shrink or collapse a node after an entry was removed below it.
+ * \param ref Pointer to the node.
+ *
+ * Nodes move to the smaller type when they fall well below its capacity. A
+ * Node4 left with a single child and no entry of its own is merged into its
+ * child, and a Node4 without any child is replaced by its entry. Shrinking
+ * is skipped if the smaller node can not be allocated.
+ */
+static void _cgc_radix_tree_shrink (cgc_radix_tree_node ** const ref)
+{
+    cgc_radix_tree_node * const node = * ref;
+    cgc_radix_tree_node * smaller = NULL;
+    switch (node->_type)
+    {
+        case _NODE4:
+            if (node->_count == 0)
+            {
+                * ref = (cgc_radix_tree_node *) node->_leaf;
+                free (node);
+            }
+            else if (node->_count == 1 && node->_leaf == NULL)
+            {
+                _cgc_radix_tree_node4 * const node4 = (_cgc_radix_tree_node4 *) node;
+                cgc_radix_tree_node * const child = node4->_children[0];
+                if (! _cgc_radix_tree_is_leaf (child))
+                {
+                    /* The prefix of the child becomes: prefix of the node,
+                     * key of the child, prefix of the child. */
+                    size_t length = node->_prefix_length;
+                    if (length < _MAX_PREFIX)
+                        node->_prefix[length++] = node4->_keys[0];
+                    if (length < _MAX_PREFIX)
+                    {
+                        size_t copied = child->_prefix_length < _MAX_PREFIX - length ? child->_prefix_length : _MAX_PREFIX - length;
+                        memcpy (node->_prefix + length, child->_prefix, copied);
+                        length += copied;
+                    }
+                    memcpy (child->_prefix, node->_prefix, length < _MAX_PREFIX ? length : _MAX_PREFIX);
+                    child->_prefix_length += node->_prefix_length + 1;
+                }
+                * ref = child;
+                free (node);
+            }
+            break;
+        case _NODE16:
+            if (node->_count <= 3)
+                smaller = _cgc_radix_tree_resize (node, _NODE4);
+            break;
+        case _NODE48:
+            if (node->_count <= 12)
+                smaller = _cgc_radix_tree_resize (node, _NODE16);
+            break;
+        case _NODE256:
+            if (node->_count <= 37)
+                smaller = _cgc_radix_tree_resize (node, _NODE48);
+            break;
+        default:
+            break;
+    }
+    if (smaller != NULL)
+        * ref = smaller;
+}
+
+/**
+ * \brief Get the leaf with the smallest key below a node.
+ * \param node Node or leaf.
+ * \return The leaf.
+ */
+static _cgc_radix_tree_leaf * _cgc_radix_tree_minimum (cgc_radix_tree_node * node)
+{
+    while (! _cgc_radix_tree_is_leaf (node) && node->_leaf == NULL)
+    {
+        switch (node->_type)
+        {
+            case _NODE4:
+                node = ((_cgc_radix_tree_node4 *) node)->_children[0];
+                break;
+            case _NODE16:
+                node = ((_cgc_radix_tree_node16 *) node)->_children[0];
+                break;
+            case _NODE48:
+            {
+                _cgc_radix_tree_node48 * const node48 = (_cgc_radix_tree_node48 *) node;
+                size_t byte = 0;
+                while (node48->_indices[byte] == 0)
+                    ++byte;
+                node = node48->_children[node48->_indices[byte] - 1];
+                break;
+            }
+            case _NODE256:
+            {
+                _cgc_radix_tree_node256 * const node256 = (_cgc_radix_tree_node256 *) node;
+                size_t byte = 0;
+                while (node256->_children[byte] == NULL)
+                    ++byte;
+                node = node256->_children[byte];
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return _cgc_radix_tree_is_leaf (node) ? (_cgc_radix_tree_leaf *) node : node->_leaf;
+}
+
+/**
+ * \brief Check the prefix of a node against a key, using the stored bytes.
+ * \param node Inner node.
+ * \param key Key.
+ * \param length Length of the key.
+ * \param depth Position of the prefix in the key.
+ * \retval true if the key is long enough and matches the stored bytes.
+ * \retval false otherwise.
+ * \note Only the stored bytes are compared: the leaf eventually reached must
+ * be checked against the whole key.
+ */
+static inline bool _cgc_radix_tree_check_prefix (const cgc_radix_tree_node * const node, const unsigned char * const key, size_t length, size_t depth)
+{
+    size_t stored = node->_prefix_length < _MAX_PREFIX ? node->_prefix_length : _MAX_PREFIX;
+    return length - depth >= node->_prefix_length && memcmp (node->_prefix, key + depth, stored) == 0;
+}
+
+/**
+ * \brief Find the first byte of the prefix of a node which differs from a key.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param node Inner node.
+ * \param key Key.
+ * \param length Length of the key.
+ * \param depth Position of the prefix in the key.
+ * \return Number of matching bytes, which is the prefix length if the whole
+ * prefix matches.
+ */
+static size_t _cgc_radix_tree_prefix_mismatch (const cgc_radix_tree * const tree, cgc_radix_tree_node * const node, const unsigned char * const key, size_t length, size_t depth)
+{
+    size_t limit = length - depth < node->_prefix_length ? length - depth : node->_prefix_length;
+    size_t i = 0;
+    for (size_t stored = limit < _MAX_PREFIX ? limit : _MAX_PREFIX; i < stored; ++i)
+        if (node->_prefix[i] != key[depth + i])
+            return i;
+
+    if (i < limit)
+    {
+        /* Read the rest of the prefix from any leaf below the node. */
+        const unsigned char * const leaf_key = _cgc_radix_tree_key (tree, _cgc_radix_tree_minimum (node));
+        for (; i < limit; ++i)
+            if (leaf_key[depth + i] != key[depth + i])
+                return i;
+    }
+    return i;
+}
+
+/**
+ * \brief Attach a leaf to a new Node4.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param node4 Node4, with room for one more child.
+ * \param leaf Leaf.
+ * \param depth Depth of the node, prefix included.
+ */
+static void _cgc_radix_tree_attach (const cgc_radix_tree * const tree, _cgc_radix_tree_node4 * const node4, _cgc_radix_tree_leaf * const leaf, size_t depth)
+{
+    if (leaf->_length == depth)
+        node4->_header._leaf = leaf;
+    else
+    {
+        _cgc_radix_tree_insert_sorted (node4->_keys, node4->_children, node4->_header._count,
+            _cgc_radix_tree_key (tree, leaf)[depth], (cgc_radix_tree_node *) leaf);
+        ++node4->_header._count;
+    }
+}
+
+/**
+ * \brief Insert a leaf into a tree.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param leaf Leaf.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of malloc.
+ * \note If an entry has the same key, it is replaced by the leaf.
+ */
+static int _cgc_radix_tree_insert_leaf (cgc_radix_tree * const tree, _cgc_radix_tree_leaf * const leaf)
+{
+    const unsigned char * const key = _cgc_radix_tree_key (tree, leaf);
+    size_t length = leaf->_length;
+    cgc_radix_tree_node ** ref = & tree->_root;
+    size_t depth = 0;
+    for (;;)
+    {
+        cgc_radix_tree_node * const node = * ref;
+        if (node == NULL)
+        {
+            * ref = (cgc_radix_tree_node *) leaf;
+            ++tree->_size;
+            return 0;
+        }
+
+        if (_cgc_radix_tree_is_leaf (node))
+        {
+            _cgc_radix_tree_leaf * const old = (_cgc_radix_tree_leaf *) node;
+            if (_cgc_radix_tree_matches (tree, old, key, length))
+            {
+                * ref = (cgc_radix_tree_node *) leaf;
+                _cgc_radix_tree_free_leaf (tree, old);
+                return 0;
+            }
+
+            /* Split the leaf: a Node4 holds the bytes both keys share. */
+            _cgc_radix_tree_node4 * const node4 = (_cgc_radix_tree_node4 *) _cgc_radix_tree_new_node (_NODE4);
+            if (node4 == NULL)
+                return -2;
+            const unsigned char * const old_key = _cgc_radix_tree_key (tree, old);
+            size_t limit = old->_length < length ? old->_length : length;
+            size_t end = depth;
+            while (end < limit && old_key[end] == key[end])
+                ++end;
+            node4->_header._prefix_length = end - depth;
+            memcpy (node4->_header._prefix, key + depth, end - depth < _MAX_PREFIX ? end - depth : _MAX_PREFIX);
+            _cgc_radix_tree_attach (tree, node4, old, end);
+            _cgc_radix_tree_attach (tree, node4, leaf, end);
+            * ref = (cgc_radix_tree_node *) node4;
+            ++tree->_size;
+            return 0;
+        }
+
+        if (node->_prefix_length > 0)
+        {
+            size_t matched = _cgc_radix_tree_prefix_mismatch (tree, node, key, length, depth);
+            if (matched < node->_prefix_length)
+            {
+                /* Split the prefix: a Node4 holds the matching bytes, and
+                 * the node keeps the bytes after the mismatch. */
+                _cgc_radix_tree_node4 * const node4 = (_cgc_radix_tree_node4 *) _cgc_radix_tree_new_node (_NODE4);
+                if (node4 == NULL)
+                    return -2;
+                node4->_header._prefix_length = matched;
+                memcpy (node4->_header._prefix, node->_prefix, matched < _MAX_PREFIX ? matched : _MAX_PREFIX);
+
+                unsigned char byte;
+                if (node->_prefix_length <= _MAX_PREFIX)
+                {
+                    byte = node->_prefix[matched];
+                    node->_prefix_length -= matched + 1;
+                    memmove (node->_prefix, node->_prefix + matched + 1, node->_prefix_length);
+                }
+                else
+                {
+                    const unsigned char * const minimum_key = _cgc_radix_tree_key (tree, _cgc_radix_tree_minimum (node));
+                    byte = minimum_key[depth + matched];
+                    node->_prefix_length -= matched + 1;
+                    memcpy (node->_prefix, minimum_key + depth + matched + 1,
+                        node->_prefix_length < _MAX_PREFIX ? node->_prefix_length : _MAX_PREFIX);
+                }
+                node4->_keys[0] = byte;
+                node4->_children[0] = node;
+                node4->_header._count = 1;
+                _cgc_radix_tree_attach (tree, node4, leaf, depth + matched);
+                * ref = (cgc_radix_tree_node *) node4;
+                ++tree->_size;
+                return 0;
+            }
+            depth += node->_prefix_length;
+        }
+
+        if (depth == length)
+        {
+            if (node->_leaf != NULL)
+                _cgc_radix_tree_free_leaf (tree, node->_leaf);
+            else
+                ++tree->_size;
+            node->_leaf = leaf;
+            return 0;
+        }
+
+        cgc_radix_tree_node ** const child = _cgc_radix_tree_find_child (node, key[depth]);
+        if (child == NULL)
+        {
+            int error = _cgc_radix_tree_add_child (ref, key[depth], (cgc_radix_tree_node *) leaf);
+            if (! error)
+                ++tree->_size;
+            return error;
+        }
+        ref = child;
+        ++depth;
+    }
+}
+
+/**
+ * \brief Erase an entry below a node.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param ref Pointer to the node.
+ * \param key Key.
+ * \param length Length of the key.
+ * \param depth Depth of the node.
+ * \retval true if the entry was erased.
+ * \retval false if the key is not in the tree.
+ */
+static bool _cgc_radix_tree_erase (cgc_radix_tree * const tree, cgc_radix_tree_node ** const ref, const unsigned char * const key, size_t length, size_t depth)
+{
+    cgc_radix_tree_node * const node = * ref;
+    if (node == NULL)
+        return false;
+
+    if (_cgc_radix_tree_is_leaf (node))
+    {
+        _cgc_radix_tree_leaf * const leaf = (_cgc_radix_tree_leaf *) node;
+        if (! _cgc_radix_tree_matches (tree, leaf, key, length))
+            return false;
+        * ref = NULL;
+        _cgc_radix_tree_free_leaf (tree, leaf);
+        return true;
+    }
+
+    if (! _cgc_radix_tree_check_prefix (node, key, length, depth))
+        return false;
+    depth += node->_prefix_length;
+
+    if (depth == length)
+    {
+        if (node->_leaf == NULL || ! _cgc_radix_tree_matches (tree, node->_leaf, key, length))
+            return false;
+        _cgc_radix_tree_free_leaf (tree, node->_leaf);
+        node->_leaf = NULL;
+        _cgc_radix_tree_shrink (ref);
+        return true;
+    }
+
+    cgc_radix_tree_node ** const child = _cgc_radix_tree_find_child (node, key[depth]);
+    if (child == NULL)
+        return false;
+    if (_cgc_radix_tree_is_leaf (* child))
+    {
+        _cgc_radix_tree_leaf * const leaf = (_cgc_radix_tree_leaf *) * child;
+        if (! _cgc_radix_tree_matches (tree, leaf, key, length))
+            return false;
+        _cgc_radix_tree_remove_child (node, key[depth]);
+        _cgc_radix_tree_free_leaf (tree, leaf);
+        _cgc_radix_tree_shrink (ref);
+        return true;
+    }
+    return _cgc_radix_tree_erase (tree, child, key, length, depth + 1);
+}
+
+/**
+ * \brief Visit every entry below a node, in order.
+ * \param tree A pointer to a CGC Radix tree.
+ * \param node Node or leaf.
+ * \param visit_fun Function called on each entry.
+ * \param data Pointer passed to \c visit_fun.
+ * \return 0, or the first non-zero value returned by \c visit_fun.
+ */
+static int _cgc_radix_tree_visit (const cgc_radix_tree * const tree, cgc_radix_tree_node * const node, cgc_radix_tree_visit_function visit_fun, void * const data)
+{
+    if (node == NULL)
+        return 0;
+    if (_cgc_radix_tree_is_leaf (node))
+    {
+        _cgc_radix_tree_leaf * const leaf = (_cgc_radix_tree_leaf *) node;
+        return visit_fun (_cgc_radix_tree_key (tree, leaf), leaf->_length, _cgc_radix_tree_value (tree, leaf), data);
+    }
+
+    /* The entry of a node is a prefix of the keys of its children. */
+    int result = _cgc_radix_tree_visit (tree, (cgc_radix_tree_node *) node->_leaf, visit_fun, data);
+    switch (node->_type)
+    {
+        case _NODE4:
+            for (size_t i = 0; i < node->_count && ! result; ++i)
+                result = _cgc_radix_tree_visit (tree, ((_cgc_radix_tree_node4 *) node)->_children[i], visit_fun, data);
+            break;
+        case _NODE16:
+            for (size_t i = 0; i < node->_count && ! result; ++i)
+                result = _cgc_radix_tree_visit (tree, ((_cgc_radix_tree_node16 *) node)->_children[i], visit_fun, data);
+            break;
+        case _NODE48:
+        {
+            _cgc_radix_tree_node48 * const node48 = (_cgc_radix_tree_node48 *) node;
+            for (size_t byte = 0; byte < 256 && ! result; ++byte)
+                if (node48->_indices[byte] != 0)
+                    result = _cgc_radix_tree_visit (tree, node48->_children[node48->_indices[byte] - 1], visit_fun, data);
+            break;
+        }
+        case _NODE256:
+            for (size_t byte = 0; byte < 256 && ! result; ++byte)
+                result = _cgc_radix_tree_visit (tree, ((_cgc_radix_tree_node256 *) node)->_children[byte], visit_fun, data);
+            break;
+        default:
+            break;
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_radix_tree * cgc_radix_tree_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
+{
+    cgc_radix_tree * tree = malloc (sizeof * tree);
+    if (tree != NULL)
+        cgc_radix_tree_init (tree, element_size, copy_fun, clean_fun);
+
+    return tree;
+}
+
+void cgc_radix_tree_destroy (cgc_radix_tree * tree)
+{
+    if (tree != NULL)
+    {
+        cgc_radix_tree_clean (tree);
+        free (tree);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_radix_tree_init (cgc_radix_tree * tree, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
+{
+    int error = cgc_check_pointer (tree);
+    if (! error)
+    {
+        tree->_root = NULL;
+        tree->_size = 0;
+        tree->_element_size = element_size;
+        tree->_value_offset = (sizeof (_cgc_radix_tree_leaf) + _Alignof (max_align_t) - 1)
+            / _Alignof (max_align_t) * _Alignof (max_align_t);
+        tree->_copy_fun = copy_fun;
+        tree->_clean_fun = clean_fun;
+    }
+
+    return error;
+}
+
+int cgc_radix_tree_clean (cgc_radix_tree * tree)
+{
+    return cgc_radix_tree_clear (tree);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_radix_tree_is_empty (const cgc_radix_tree * tree)
+{
+    return tree->_size == 0;
+}
+
+size_t cgc_radix_tree_size (const cgc_radix_tree * tree)
+{
+    return tree->_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+/* cgc_radix_tree_find():
+ * ----------------------
+ * Prefixes are checked optimistically: only the stored bytes are compared on
+ * the way down, and the leaf is compared against the whole key.
+ */
+void * cgc_radix_tree_find (const cgc_radix_tree * tree, const void * key, size_t length)
+{
+    const unsigned char * const bytes = key;
+    cgc_radix_tree_node * node = tree->_root;
+    size_t depth = 0;
+    while (node != NULL)
+    {
+        if (_cgc_radix_tree_is_leaf (node))
+        {
+            _cgc_radix_tree_leaf * const leaf = (_cgc_radix_tree_leaf *) node;
+            return _cgc_radix_tree_matches (tree, leaf, bytes, length) ? _cgc_radix_tree_value (tree, leaf) : NULL;
+        }
+
+        if (! _cgc_radix_tree_check_prefix (node, bytes, length, depth))
+            return NULL;
+        depth += node->_prefix_length;
+
+        if (depth == length)
+            return node->_leaf != NULL && _cgc_radix_tree_matches (tree, node->_leaf, bytes, length)
+                ? _cgc_radix_tree_value (tree, node->_leaf) : NULL;
+
+        cgc_radix_tree_node ** const child = _cgc_radix_tree_find_child (node, bytes[depth]);
+        node = child != NULL ? * child : NULL;
+        ++depth;
+    }
+    return NULL;
+}
+
+void * cgc_radix_tree_longest_prefix (const cgc_radix_tree * tree, const void * key, size_t length, size_t * matched)
+{
+    const unsigned char * const bytes = key;
+    _cgc_radix_tree_leaf * best = NULL;
+    cgc_radix_tree_node * node = tree->_root;
+    size_t depth = 0;
+    while (node != NULL)
+    {
+        _cgc_radix_tree_leaf * const leaf = _cgc_radix_tree_is_leaf (node) ? (_cgc_radix_tree_leaf *) node : NULL;
+        if (leaf == NULL)
+        {
+            if (! _cgc_radix_tree_check_prefix (node, bytes, length, depth))
+                break;
+            depth += node->_prefix_length;
+        }
+
+        /* Candidates are checked in full, as prefixes are checked
+         * optimistically. */
+        _cgc_radix_tree_leaf * const candidate = leaf != NULL ? leaf : node->_leaf;
+        if (candidate != NULL && candidate->_length <= length
+            && (candidate->_length == 0 || memcmp (_cgc_radix_tree_key (tree, candidate), bytes, candidate->_length) == 0))
+            best = candidate;
+
+        if (leaf != NULL || depth == length)
+            break;
+        cgc_radix_tree_node ** const child = _cgc_radix_tree_find_child (node, bytes[depth]);
+        node = child != NULL ? * child : NULL;
+        ++depth;
+    }
+
+    if (best != NULL && matched != NULL)
+        * matched = best->_length;
+    return best != NULL ? _cgc_radix_tree_value (tree, best) : NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_radix_tree_insert (cgc_radix_tree * tree, const void * key, size_t length, const void * value)
+{
+    int error = cgc_check_pointer (tree);
+    if (! error)
+        error = cgc_check_pointer (value);
+    if (! error && length > 0)
+        error = cgc_check_pointer (key);
+
+    _cgc_radix_tree_leaf * leaf = NULL;
+    if (! error)
+        error = _cgc_radix_tree_new_leaf (tree, key, length, value, & leaf);
+    if (! error)
+    {
+        error = _cgc_radix_tree_insert_leaf (tree, leaf);
+        if (error)
+            _cgc_radix_tree_free_leaf (tree, leaf);
+    }
+
+    return error;
+}
+
+bool cgc_radix_tree_erase (cgc_radix_tree * tree, const void * key, size_t length)
+{
+    bool erased = _cgc_radix_tree_erase (tree, & tree->_root, key, length, 0);
+    if (erased)
+        --tree->_size;
+    return erased;
+}
+
+int cgc_radix_tree_clear (cgc_radix_tree * tree)
+{
+    int error = cgc_check_pointer (tree);
+    if (! error)
+    {
+        _cgc_radix_tree_free_node (tree, tree->_root);
+        tree->_root = NULL;
+        tree->_size = 0;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Iteration.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_radix_tree_for_each (const cgc_radix_tree * tree, cgc_radix_tree_visit_function visit_fun, void * data)
+{
+    return _cgc_radix_tree_visit (tree, tree->_root, visit_fun, data);
+}
+
+/* cgc_radix_tree_for_each_prefix():
+ * ---------------------------------
+ * Walk down the prefix until it is exhausted: every entry below the node
+ * reached then starts with the prefix. Prefixes of nodes are checked in full,
+ * as no leaf is compared against the prefix on the way.
+ */
+int cgc_radix_tree_for_each_prefix (const cgc_radix_tree * tree, const void * prefix, size_t length, cgc_radix_tree_visit_function visit_fun, void * data)
+{
+    const unsigned char * const bytes = prefix;
+    cgc_radix_tree_node * node = tree->_root;
+    size_t depth = 0;
+    while (node != NULL && depth < length)
+    {
+        if (_cgc_radix_tree_is_leaf (node))
+        {
+            _cgc_radix_tree_leaf * const leaf = (_cgc_radix_tree_leaf *) node;
+            if (leaf->_length < length || memcmp (_cgc_radix_tree_key (tree, leaf), bytes, length) != 0)
+                node = NULL;
+            break;
+        }
+
+        size_t matched = _cgc_radix_tree_prefix_mismatch (tree, node, bytes, length, depth);
+        if (depth + matched == length)
+            break;
+        if (matched < node->_prefix_length)
+        {
+            node = NULL;
+            break;
+        }
+        depth += node->_prefix_length;
+
+        cgc_radix_tree_node ** const child = _cgc_radix_tree_find_child (node, bytes[depth]);
+        node = child != NULL ? * child : NULL;
+        ++depth;
+    }
+    return _cgc_radix_tree_visit (tree, node, visit_fun, data);
+}
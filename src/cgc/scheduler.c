@@ -0,0 +1,409 @@
+/**
+ * \file scheduler.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "cgc/scheduler.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Tasks and workers.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Task.
+ */
+typedef struct _cgc_scheduler_task
+{
+    cgc_unary_op_function _op_fun;  /**<- Operation function. */
+    void * _argument;               /**<- Argument. */
+} _cgc_scheduler_task;
+
+/**
+ * \brief Worker.
+ */
+struct cgc_scheduler_worker
+{
+    cgc_work_deque _deque;          /**<- Tasks spawned by this worker. */
+    cgc_scheduler * _scheduler;     /**<- Scheduler. */
+    size_t _index;                  /**<- Index of the worker. */
+    uint64_t _seed;                 /**<- State of the victim selection. */
+};
+
+/**
+ * \brief Worker running on the current thread, if any.
+ */
+static _Thread_local cgc_scheduler_worker * _current_worker = NULL;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initial capacity of the deques.
+ */
+static const size_t _DEQUE_CAPACITY = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Try to steal a task from the other workers.
+ * \param worker A pointer to the thief.
+ * \return A pointer to the task.
+ * \retval NULL if no task could be stolen.
+ * The victims are visited from a random one, so that thieves spread.
+ */
+static _cgc_scheduler_task * _cgc_scheduler_steal (cgc_scheduler_worker * const worker)
+{
+    cgc_scheduler * const scheduler = worker->_scheduler;
+    worker->_seed ^= worker->_seed >> 12;
+    worker->_seed ^= worker->_seed << 25;
+    worker->_seed ^= worker->_seed >> 27;
+    size_t start = (size_t) ((worker->_seed * UINT64_C (2685821657736338717)) % scheduler->_worker_count);
+
+    _cgc_scheduler_task * task = NULL;
+    for (size_t i = 0; i < scheduler->_worker_count && task == NULL; ++i)
+    {
+        size_t victim = (start + i) % scheduler->_worker_count;
+        if (victim != worker->_index)
+            task = cgc_work_deque_steal (& scheduler->_workers[victim]._deque);
+    }
+
+    return task;
+}
+
+/**
+ * \brief Find a task to run.
+ * \param worker A pointer to a worker.
+ * \return A pointer to the task.
+ * \retval NULL if no task was found.
+ */
+static _cgc_scheduler_task * _cgc_scheduler_find (cgc_scheduler_worker * const worker)
+{
+    cgc_scheduler * const scheduler = worker->_scheduler;
+    _cgc_scheduler_task * task = cgc_work_deque_pop (& worker->_deque);
+    if (task == NULL)
+        task = _cgc_scheduler_steal (worker);
+    if (task == NULL)
+    {
+        pthread_mutex_lock (& scheduler->_mutex);
+        if (! cgc_queue_is_empty (& scheduler->_injected))
+            cgc_queue_pop_into (& scheduler->_injected, & task);
+        pthread_mutex_unlock (& scheduler->_mutex);
+    }
+
+    return task;
+}
+
+/**
+ * \brief Check whether a task is waiting anywhere.
+ * \param scheduler A pointer to a CGC Scheduler, whose mutex is locked.
+ * \retval true if a task is waiting.
+ * \retval false otherwise.
+ */
+static bool _cgc_scheduler_has_work (cgc_scheduler * const scheduler)
+{
+    bool has_work = ! cgc_queue_is_empty (& scheduler->_injected);
+    for (size_t i = 0; i < scheduler->_worker_count && ! has_work; ++i)
+        has_work = cgc_work_deque_size (& scheduler->_workers[i]._deque) != 0;
+
+    return has_work;
+}
+
+/**
+ * \brief Count a task as done, and wake the waiting threads up if it was the
+ * last one.
+ * \param scheduler A pointer to a CGC Scheduler.
+ */
+static void _cgc_scheduler_task_done (cgc_scheduler * const scheduler)
+{
+    if (atomic_fetch_sub (& scheduler->_pending, 1) == 1)
+    {
+        pthread_mutex_lock (& scheduler->_mutex);
+        pthread_cond_broadcast (& scheduler->_done);
+        pthread_mutex_unlock (& scheduler->_mutex);
+    }
+}
+
+/**
+ * \brief Run a task, then free it.
+ * \param scheduler A pointer to a CGC Scheduler.
+ * \param task A pointer to the task.
+ */
+static void _cgc_scheduler_run (cgc_scheduler * const scheduler, _cgc_scheduler_task * const task)
+{
+    task->_op_fun (task->_argument);
+    free (task);
+    _cgc_scheduler_task_done (scheduler);
+}
+
+/**
+ * \brief Main function of the worker threads.
+ * \param argument A pointer to the worker.
+ * \return \c NULL.
+ */
+static void * _cgc_scheduler_work (void * argument)
+{
+    cgc_scheduler_worker * const worker = argument;
+    cgc_scheduler * const scheduler = worker->_scheduler;
+    _current_worker = worker;
+
+    while (! atomic_load (& scheduler->_stop))
+    {
+        _cgc_scheduler_task * task = _cgc_scheduler_find (worker);
+        if (task != NULL)
+            _cgc_scheduler_run (scheduler, task);
+        else
+        {
+            /* Announce the sleep before the last check: a worker spawning a
+             * task checks for sleepers after publishing it. */
+            pthread_mutex_lock (& scheduler->_mutex);
+            atomic_fetch_add (& scheduler->_sleeping, 1);
+            atomic_thread_fence (memory_order_seq_cst);
+            if (! atomic_load (& scheduler->_stop) && ! _cgc_scheduler_has_work (scheduler))
+                pthread_cond_wait (& scheduler->_wake, & scheduler->_mutex);
+            atomic_fetch_sub (& scheduler->_sleeping, 1);
+            pthread_mutex_unlock (& scheduler->_mutex);
+        }
+    }
+
+    _current_worker = NULL;
+    return NULL;
+}
+
+/**
+ * \brief Stop the first workers of a scheduler and free its resources.
+ * \param scheduler A pointer to a CGC Scheduler.
+ * \param started Number of started workers.
+ */
+static void _cgc_scheduler_stop (cgc_scheduler * const scheduler, size_t started)
+{
+    pthread_mutex_lock (& scheduler->_mutex);
+    atomic_store (& scheduler->_stop, true);
+    pthread_cond_broadcast (& scheduler->_wake);
+    pthread_mutex_unlock (& scheduler->_mutex);
+    for (size_t i = 0; i < started; ++i)
+        pthread_join (scheduler->_threads[i], NULL);
+
+    for (size_t i = 0; i < scheduler->_worker_count; ++i)
+    {
+        _cgc_scheduler_task * task;
+        while ((task = cgc_work_deque_pop (& scheduler->_workers[i]._deque)) != NULL)
+            free (task);
+        cgc_work_deque_clean (& scheduler->_workers[i]._deque);
+    }
+    _cgc_scheduler_task * task;
+    while (cgc_queue_pop_into (& scheduler->_injected, & task) == 0)
+        free (task);
+
+    cgc_queue_clean (& scheduler->_injected);
+    pthread_cond_destroy (& scheduler->_done);
+    pthread_cond_destroy (& scheduler->_wake);
+    pthread_mutex_destroy (& scheduler->_mutex);
+    free (scheduler->_threads);
+    free (scheduler->_workers);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_scheduler * cgc_scheduler_create (size_t worker_count)
+{
+    cgc_scheduler * scheduler = malloc (sizeof * scheduler);
+    if (scheduler != NULL && cgc_scheduler_init (scheduler, worker_count) != 0)
+    {
+        free (scheduler);
+        scheduler = NULL;
+    }
+
+    return scheduler;
+}
+
+void cgc_scheduler_destroy (cgc_scheduler * scheduler)
+{
+    if (scheduler != NULL)
+    {
+        cgc_scheduler_clean (scheduler);
+        free (scheduler);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_scheduler_init (cgc_scheduler * scheduler, size_t worker_count)
+{
+    int error = cgc_check_pointer (scheduler);
+    if (! error && worker_count == 0)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        scheduler->_workers = NULL;
+        scheduler->_threads = NULL;
+        if (worker_count <= SIZE_MAX / sizeof (cgc_scheduler_worker))
+        {
+            scheduler->_workers = aligned_alloc (_Alignof (cgc_scheduler_worker), worker_count * sizeof (cgc_scheduler_worker));
+            scheduler->_threads = malloc (worker_count * sizeof (pthread_t));
+        }
+
+        bool ready = scheduler->_workers != NULL && scheduler->_threads != NULL;
+        size_t deques = 0;
+        while (ready && deques < worker_count && cgc_work_deque_init (& scheduler->_workers[deques]._deque, _DEQUE_CAPACITY) == 0)
+            ++deques;
+        ready = ready && deques == worker_count;
+
+        bool mutex_ready = ready && pthread_mutex_init (& scheduler->_mutex, NULL) == 0;
+        bool wake_ready = mutex_ready && pthread_cond_init (& scheduler->_wake, NULL) == 0;
+        bool done_ready = wake_ready && pthread_cond_init (& scheduler->_done, NULL) == 0;
+        if (! done_ready)
+        {
+            if (wake_ready)
+                pthread_cond_destroy (& scheduler->_wake);
+            if (mutex_ready)
+                pthread_mutex_destroy (& scheduler->_mutex);
+            for (size_t i = 0; i < deques; ++i)
+                cgc_work_deque_clean (& scheduler->_workers[i]._deque);
+            free (scheduler->_threads);
+            free (scheduler->_workers);
+            error = -2;
+        }
+    }
+
+    if (! error)
+    {
+        scheduler->_worker_count = worker_count;
+        cgc_queue_init (& scheduler->_injected, sizeof (_cgc_scheduler_task *), NULL, NULL);
+        atomic_init (& scheduler->_pending, 0);
+        atomic_init (& scheduler->_sleeping, 0);
+        atomic_init (& scheduler->_stop, false);
+
+        for (size_t i = 0; i < worker_count; ++i)
+        {
+            scheduler->_workers[i]._scheduler = scheduler;
+            scheduler->_workers[i]._index = i;
+            scheduler->_workers[i]._seed = UINT64_C (0x9E3779B97F4A7C15) * (i + 1);
+        }
+
+        size_t started = 0;
+        while (started < worker_count
+            && pthread_create (& scheduler->_threads[started], NULL, _cgc_scheduler_work, & scheduler->_workers[started]) == 0)
+            ++started;
+
+        if (started != worker_count)
+        {
+            _cgc_scheduler_stop (scheduler, started);
+            error = -2;
+        }
+    }
+
+    return error;
+}
+
+int cgc_scheduler_clean (cgc_scheduler * scheduler)
+{
+    int error = cgc_check_pointer (scheduler);
+    if (! error)
+        _cgc_scheduler_stop (scheduler, scheduler->_worker_count);
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tasks.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_scheduler_spawn (cgc_scheduler * scheduler, cgc_unary_op_function op_fun, void * argument)
+{
+    int error = cgc_check_pointer (scheduler);
+    if (! error && op_fun == NULL)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    _cgc_scheduler_task * task = NULL;
+    if (! error)
+    {
+        task = malloc (sizeof * task);
+        if (task != NULL)
+            * task = (_cgc_scheduler_task) { ._op_fun = op_fun, ._argument = argument };
+        else
+            error = -2;
+    }
+
+    if (! error)
+    {
+        /* Count the task before anyone can run it. */
+        atomic_fetch_add (& scheduler->_pending, 1);
+        cgc_scheduler_worker * const worker = _current_worker;
+        if (worker != NULL && worker->_scheduler == scheduler)
+        {
+            error = cgc_work_deque_push (& worker->_deque, task);
+            atomic_thread_fence (memory_order_seq_cst);
+            if (! error && atomic_load (& scheduler->_sleeping) != 0)
+            {
+                pthread_mutex_lock (& scheduler->_mutex);
+                pthread_cond_signal (& scheduler->_wake);
+                pthread_mutex_unlock (& scheduler->_mutex);
+            }
+        }
+        else
+        {
+            pthread_mutex_lock (& scheduler->_mutex);
+            error = cgc_queue_push (& scheduler->_injected, & task);
+            if (! error)
+                pthread_cond_signal (& scheduler->_wake);
+            pthread_mutex_unlock (& scheduler->_mutex);
+        }
+
+        if (error)
+        {
+            free (task);
+            _cgc_scheduler_task_done (scheduler);
+        }
+    }
+
+    return error;
+}
+
+int cgc_scheduler_wait (cgc_scheduler * scheduler)
+{
+    int error = cgc_check_pointer (scheduler);
+
+    if (! error)
+    {
+        pthread_mutex_lock (& scheduler->_mutex);
+        while (atomic_load (& scheduler->_pending) != 0)
+            pthread_cond_wait (& scheduler->_done, & scheduler->_mutex);
+        pthread_mutex_unlock (& scheduler->_mutex);
+    }
+
+    return error;
+}
@@ -0,0 +1,502 @@
+/**
+ * \file skip_list.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/skip_list.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initial state of the level generator.
+ */
+static const uint64_t _RANDOM_SEED = 0x9E3779B97F4A7C15ULL;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Allocate a node.
+ * \param level_count Number of levels of the node.
+ * \return A pointer to the node.
+ * \retval \c NULL in case of failure.
+ * \note In case of failure, \c errno may be set to \c ENOMEM.
+ */
+static cgc_skip_list_node * _cgc_skip_list_node_alloc (size_t level_count)
+{
+    cgc_skip_list_node * const node = malloc (sizeof * node + level_count * sizeof (cgc_skip_list_link));
+    if (node != NULL)
+    {
+        node->_content = NULL;
+        node->_level_count = level_count;
+    }
+
+    return node;
+}
+
+/**
+ * \brief Draw the number of levels of a new node.
+ * \param list A pointer to a CGC Skip list.
+ * \return A number of levels between 1 and CGC_SKIP_LIST_MAX_LEVEL.
+ * Each additional level is drawn with probability 1/4 (xorshift64*).
+ */
+static size_t _cgc_skip_list_random_level (cgc_skip_list * const list)
+{
+    uint64_t x = list->_random_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    list->_random_state = x;
+    x *= 0x2545F4914F6CDD1DULL;
+
+    size_t level = 1;
+    for (x >>= 32; level < CGC_SKIP_LIST_MAX_LEVEL && (x & 3) == 0; x >>= 2)
+        level++;
+
+    return level;
+}
+
+/**
+ * \brief Find the predecessors, on each level, of the position \c i.
+ * \param list A pointer to a CGC Skip list.
+ * \param i Target index.
+ * \param update Predecessors (output).
+ * \param positions Positions of the predecessors (output), the head being at
+ * position 0 and the Nth element at position N + 1.
+ */
+static void _cgc_skip_list_find (const cgc_skip_list * const list, size_t i, cgc_skip_list_node ** const update, size_t * const positions)
+{
+    cgc_skip_list_node * node = list->_head;
+    size_t position = 0;
+    for (size_t l = list->_level_count; l > 0; --l)
+    {
+        const cgc_skip_list_link * link = & node->_links[l - 1];
+        while (link->_next != NULL && position + link->_width <= i)
+        {
+            position += link->_width;
+            node = link->_next;
+            link = & node->_links[l - 1];
+        }
+        update[l - 1] = node;
+        positions[l - 1] = position;
+    }
+}
+
+/**
+ * \brief Copy an element into a new node and link it at index \c i.
+ * \param list A pointer to a CGC Skip list.
+ * \param i Target index.
+ * \param element A pointer to the element.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of malloc.
+ * \retval <= -3 in case of failure of the copy function.
+ * \pre i <= list->_size
+ */
+static int _cgc_skip_list_link_at (cgc_skip_list * const list, size_t i, const void * const element)
+{
+    int error = 0;
+    size_t level_count = _cgc_skip_list_random_level (list);
+    cgc_skip_list_node * const node = _cgc_skip_list_node_alloc (level_count);
+    if (node != NULL)
+        node->_content = malloc (list->_element_size);
+
+    if (node == NULL || node->_content == NULL)
+        error = -2;
+    else if (list->_copy_fun != NULL)
+        error = list->_copy_fun (element, node->_content);
+    else
+        memcpy (node->_content, element, list->_element_size);
+
+    if (! error)
+    {
+        cgc_skip_list_node * update[CGC_SKIP_LIST_MAX_LEVEL];
+        size_t positions[CGC_SKIP_LIST_MAX_LEVEL];
+        _cgc_skip_list_find (list, i, update, positions);
+
+        for (size_t l = list->_level_count; l < level_count; ++l)
+        {
+            list->_head->_links[l] = (cgc_skip_list_link) { ._next = NULL, ._width = list->_size + 1 };
+            update[l] = list->_head;
+            positions[l] = 0;
+        }
+        if (level_count > list->_level_count)
+            list->_level_count = level_count;
+
+        /* The new node takes the position i + 1. */
+        for (size_t l = 0; l < level_count; ++l)
+        {
+            cgc_skip_list_link * const link = & update[l]->_links[l];
+            node->_links[l] = (cgc_skip_list_link) { ._next = link->_next, ._width = positions[l] + link->_width - i };
+            * link = (cgc_skip_list_link) { ._next = node, ._width = i + 1 - positions[l] };
+        }
+        for (size_t l = level_count; l < list->_level_count; ++l)
+            update[l]->_links[l]._width++;
+
+        list->_size++;
+    }
+    else if (node != NULL)
+    {
+        free (node->_content);
+        free (node);
+    }
+
+    return error;
+}
+
+/**
+ * \brief Unlink the node at index \c i.
+ * \param list A pointer to a CGC Skip list.
+ * \param i Target index.
+ * \return A pointer to the unlinked node.
+ * \pre i < list->_size
+ */
+static cgc_skip_list_node * _cgc_skip_list_unlink_at (cgc_skip_list * const list, size_t i)
+{
+    cgc_skip_list_node * update[CGC_SKIP_LIST_MAX_LEVEL];
+    size_t positions[CGC_SKIP_LIST_MAX_LEVEL];
+    _cgc_skip_list_find (list, i, update, positions);
+
+    cgc_skip_list_node * const node = update[0]->_links[0]._next;
+    for (size_t l = 0; l < list->_level_count; ++l)
+    {
+        cgc_skip_list_link * const link = & update[l]->_links[l];
+        if (link->_next == node)
+            * link = (cgc_skip_list_link) { ._next = node->_links[l]._next, ._width = link->_width + node->_links[l]._width - 1 };
+        else
+            link->_width--;
+    }
+
+    while (list->_level_count > 1 && list->_head->_links[list->_level_count - 1]._next == NULL)
+        list->_level_count--;
+
+    list->_size--;
+    return node;
+}
+
+/**
+ * \brief Clean and free a node.
+ * \param list A pointer to a CGC Skip list.
+ * \param node A pointer to a node.
+ */
+static inline void _cgc_skip_list_node_free (cgc_skip_list * const list, cgc_skip_list_node * const node)
+{
+    if (list->_clean_fun != NULL)
+        list->_clean_fun (node->_content);
+    free (node->_content);
+    free (node);
+}
+
+/**
+ * \brief Get the node at index \c i.
+ * \param list A pointer to a CGC Skip list.
+ * \param i Target index.
+ * \return A pointer to the node.
+ * \pre i < list->_size
+ */
+static cgc_skip_list_node * _cgc_skip_list_node_at (const cgc_skip_list * const list, size_t i)
+{
+    cgc_skip_list_node * node = list->_head;
+    size_t position = 0;
+    for (size_t l = list->_level_count; l > 0 && position != i + 1; --l)
+    {
+        const cgc_skip_list_link * link = & node->_links[l - 1];
+        while (link->_next != NULL && position + link->_width <= i + 1)
+        {
+            position += link->_width;
+            node = link->_next;
+            link = & node->_links[l - 1];
+        }
+    }
+
+    return node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_skip_list * cgc_skip_list_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
+{
+    cgc_skip_list * list = malloc (sizeof * list);
+    if (list != NULL)
+    {
+        int error = cgc_skip_list_init (list, element_size, copy_fun, clean_fun);
+        if (error)
+        {
+            free (list);
+            list = NULL;
+        }
+    }
+
+    return list;
+}
+
+void cgc_skip_list_destroy (cgc_skip_list * const list)
+{
+    if (list != NULL)
+    {
+        cgc_skip_list_clean (list);
+        free (list);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_skip_list_init (cgc_skip_list * const list, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
+{
+    int error = cgc_check_pointer (list);
+
+    if (! error)
+    {
+        list->_head = _cgc_skip_list_node_alloc (CGC_SKIP_LIST_MAX_LEVEL);
+        if (list->_head != NULL)
+        {
+            list->_head->_links[0] = (cgc_skip_list_link) { ._next = NULL, ._width = 1 };
+            list->_level_count = 1;
+            list->_clean_fun = clean_fun;
+            list->_copy_fun = copy_fun;
+            list->_size = 0;
+            list->_element_size = element_size;
+            list->_random_state = _RANDOM_SEED;
+        }
+        else
+            error = -2;
+    }
+
+    return error;
+}
+
+int cgc_skip_list_clean (cgc_skip_list * const list)
+{
+    int error = cgc_skip_list_clear (list);
+    if (! error)
+    {
+        free (list->_head);
+        list->_head = NULL;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_skip_list * cgc_skip_list_copy (const cgc_skip_list * const list)
+{
+    cgc_skip_list * copy = NULL;
+    if (list != NULL)
+    {
+        copy = malloc (sizeof * copy);
+        if (copy != NULL && cgc_skip_list_copy_into (list, copy) != 0)
+        {
+            free (copy);
+            copy = NULL;
+        }
+    }
+
+    return copy;
+}
+
+int cgc_skip_list_copy_into (const cgc_skip_list * const original, cgc_skip_list * const destination)
+{
+    int error = cgc_check_pointer (original);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    if (! error)
+        error = cgc_skip_list_init (destination, original->_element_size, original->_copy_fun, original->_clean_fun);
+
+    if (! error)
+    {
+        for (cgc_skip_list_node * node = original->_head->_links[0]._next; ! error && node != NULL; node = node->_links[0]._next)
+            error = _cgc_skip_list_link_at (destination, destination->_size, node->_content);
+
+        /* Do not leak the elements copied so far. */
+        if (error)
+            cgc_skip_list_clean (destination);
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Swap.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_skip_list_swap (cgc_skip_list * const a, cgc_skip_list * const b)
+{
+    int error = cgc_check_pointer (a);
+    if (! error)
+        error = cgc_check_pointer (b);
+
+    if (! error)
+    {
+        cgc_skip_list tmp = * a;
+        * a = * b;
+        * b = tmp;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_skip_list_is_empty (const cgc_skip_list * const list)
+{
+    return list->_size == 0;
+}
+
+size_t cgc_skip_list_size (const cgc_skip_list * const list)
+{
+    return list->_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+void * cgc_skip_list_at (const cgc_skip_list * const list, size_t i)
+{
+    return i < list->_size ? _cgc_skip_list_node_at (list, i)->_content : NULL;
+}
+
+void * cgc_skip_list_front (const cgc_skip_list * const list)
+{
+    return list->_head->_links[0]._next->_content;
+}
+
+void * cgc_skip_list_back (const cgc_skip_list * const list)
+{
+    return _cgc_skip_list_node_at (list, list->_size - 1)->_content;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_skip_list_push_front (cgc_skip_list * const list, const void * const element)
+{
+    return cgc_skip_list_insert (list, 0, element);
+}
+
+int cgc_skip_list_push_back (cgc_skip_list * const list, const void * const element)
+{
+    int error = cgc_check_pointer (list);
+    if (! error)
+        error = cgc_skip_list_insert (list, list->_size, element);
+
+    return error;
+}
+
+void * cgc_skip_list_pop_front (cgc_skip_list * const list)
+{
+    cgc_skip_list_node * const node = _cgc_skip_list_unlink_at (list, 0);
+    void * const content = node->_content;
+    free (node);
+
+    return content;
+}
+
+void * cgc_skip_list_pop_back (cgc_skip_list * const list)
+{
+    cgc_skip_list_node * const node = _cgc_skip_list_unlink_at (list, list->_size - 1);
+    void * const content = node->_content;
+    free (node);
+
+    return content;
+}
+
+int cgc_skip_list_insert (cgc_skip_list * const list, size_t i, const void * const element)
+{
+    int error = cgc_check_pointer (list);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    if (! error)
+        error = _cgc_skip_list_link_at (list, i < list->_size ? i : list->_size, element);
+
+    return error;
+}
+
+int cgc_skip_list_clear (cgc_skip_list * const list)
+{
+    int error = cgc_check_pointer (list);
+
+    if (! error)
+    {
+        cgc_skip_list_node * node = list->_head->_links[0]._next;
+        while (node != NULL)
+        {
+            cgc_skip_list_node * const next = node->_links[0]._next;
+            _cgc_skip_list_node_free (list, node);
+            node = next;
+        }
+
+        list->_head->_links[0] = (cgc_skip_list_link) { ._next = NULL, ._width = 1 };
+        list->_level_count = 1;
+        list->_size = 0;
+    }
+
+    return error;
+}
+
+int cgc_skip_list_erase (cgc_skip_list * const list, size_t start, size_t end)
+{
+    int error = cgc_check_pointer (list);
+    if (! error && (start >= end || start > list->_size))
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        size_t count = (end > list->_size ? list->_size : end) - start;
+        for (size_t j = 0; j < count; ++j)
+            _cgc_skip_list_node_free (list, _cgc_skip_list_unlink_at (list, start));
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions on lists.
+////////////////////////////////////////////////////////////////////////////////
+
+void cgc_skip_list_map (cgc_skip_list * const list, cgc_unary_op_function op_fun)
+{
+    for (cgc_skip_list_node * node = list->_head->_links[0]._next; node != NULL; node = node->_links[0]._next)
+        op_fun (node->_content);
+}
+
+void cgc_skip_list_fold_left (const cgc_skip_list * const list, cgc_binary_op_left_function op_fun, void * const base_result)
+{
+    for (cgc_skip_list_node * node = list->_head->_links[0]._next; node != NULL; node = node->_links[0]._next)
+        op_fun (base_result, node->_content);
+}
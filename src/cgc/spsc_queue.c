@@ -0,0 +1,326 @@
+/**
+ * \file spsc_queue.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/spsc_queue.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get a slot of a queue.
+ * \param queue A pointer to a CGC SPSC Queue.
+ * \param index Index of the slot, not yet reduced modulo the capacity.
+ * \return A pointer to the slot.
+ */
+static inline char * _cgc_spsc_queue_slot (const cgc_spsc_queue * const queue, size_t index)
+{
+    return queue->_content + (index & (queue->_capacity - 1)) * queue->_element_size;
+}
+
+/**
+ * \brief Get the number of slots the producer may fill.
+ * \param queue A pointer to a CGC SPSC Queue.
+ * \param tail The current tail.
+ * \param n The number of slots needed.
+ * \return The number of free slots, at most \c n.
+ * The shared head is only read if the cached one does not leave enough room.
+ */
+static inline size_t _cgc_spsc_queue_free_slots (cgc_spsc_queue * const queue, size_t tail, size_t n)
+{
+    size_t free_slots = queue->_capacity - (tail - queue->_cached_head);
+    if (free_slots < n)
+    {
+        queue->_cached_head = atomic_load_explicit (& queue->_head, memory_order_acquire);
+        free_slots = queue->_capacity - (tail - queue->_cached_head);
+    }
+
+    return free_slots < n ? free_slots : n;
+}
+
+/**
+ * \brief Get the number of elements the consumer may pop.
+ * \param queue A pointer to a CGC SPSC Queue.
+ * \param head The current head.
+ * \param n The number of elements needed.
+ * \return The number of available elements, at most \c n.
+ * The shared tail is only read if the cached one does not show enough
+ * elements.
+ */
+static inline size_t _cgc_spsc_queue_used_slots (cgc_spsc_queue * const queue, size_t head, size_t n)
+{
+    size_t used_slots = queue->_cached_tail - head;
+    if (used_slots < n)
+    {
+        queue->_cached_tail = atomic_load_explicit (& queue->_tail, memory_order_acquire);
+        used_slots = queue->_cached_tail - head;
+    }
+
+    return used_slots < n ? used_slots : n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_spsc_queue * cgc_spsc_queue_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity)
+{
+    cgc_spsc_queue * queue = aligned_alloc (_Alignof (cgc_spsc_queue), sizeof * queue);
+    if (queue != NULL)
+    {
+        int error = cgc_spsc_queue_init (queue, element_size, copy_fun, clean_fun, capacity);
+        if (error)
+        {
+            free (queue);
+            queue = NULL;
+        }
+    }
+
+    return queue;
+}
+
+void cgc_spsc_queue_destroy (cgc_spsc_queue * queue)
+{
+    if (queue != NULL)
+    {
+        cgc_spsc_queue_clean (queue);
+        free (queue);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_spsc_queue_init (cgc_spsc_queue * queue, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, size_t capacity)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error && capacity == 0)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    size_t power = 1;
+    while (! error && power < capacity && power <= SIZE_MAX / 2)
+        power *= 2;
+
+    if (! error)
+    {
+        queue->_content = NULL;
+        if (power >= capacity && (element_size == 0 || power <= SIZE_MAX / element_size))
+            queue->_content = malloc (power * element_size);
+        if (queue->_content == NULL)
+            error = -2;
+    }
+
+    if (! error)
+    {
+        atomic_init (& queue->_head, 0);
+        atomic_init (& queue->_tail, 0);
+        queue->_cached_head = 0;
+        queue->_cached_tail = 0;
+        queue->_capacity = power;
+        queue->_element_size = element_size;
+        queue->_copy_fun = copy_fun;
+        queue->_clean_fun = clean_fun;
+    }
+
+    return error;
+}
+
+int cgc_spsc_queue_clean (cgc_spsc_queue * queue)
+{
+    int error = cgc_spsc_queue_clear (queue);
+    if (! error)
+    {
+        free (queue->_content);
+        queue->_content = NULL;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_spsc_queue_is_empty (const cgc_spsc_queue * queue)
+{
+    return cgc_spsc_queue_size (queue) == 0;
+}
+
+size_t cgc_spsc_queue_size (const cgc_spsc_queue * queue)
+{
+    /* Load the head first: the tail can only grow meanwhile. */
+    size_t head = atomic_load_explicit (& queue->_head, memory_order_acquire);
+    size_t tail = atomic_load_explicit (& queue->_tail, memory_order_acquire);
+    return tail - head;
+}
+
+size_t cgc_spsc_queue_capacity (const cgc_spsc_queue * queue)
+{
+    return queue->_capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_spsc_queue_push (cgc_spsc_queue * queue, const void * element)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    size_t tail = 0;
+    if (! error)
+    {
+        tail = atomic_load_explicit (& queue->_tail, memory_order_relaxed);
+        if (_cgc_spsc_queue_free_slots (queue, tail, 1) == 0)
+        {
+            error = -1;
+            errno = EAGAIN;
+        }
+    }
+
+    if (! error)
+    {
+        char * const slot = _cgc_spsc_queue_slot (queue, tail);
+        if (queue->_copy_fun != NULL)
+            error = queue->_copy_fun (element, slot);
+        else
+            memcpy (slot, element, queue->_element_size);
+
+        if (! error)
+            atomic_store_explicit (& queue->_tail, tail + 1, memory_order_release);
+    }
+
+    return error;
+}
+
+size_t cgc_spsc_queue_push_n (cgc_spsc_queue * queue, const void * elements, size_t n)
+{
+    size_t count = 0;
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (elements);
+
+    if (! error)
+    {
+        const char * const source = elements;
+        size_t tail = atomic_load_explicit (& queue->_tail, memory_order_relaxed);
+        size_t available = _cgc_spsc_queue_free_slots (queue, tail, n);
+
+        if (queue->_copy_fun != NULL)
+            while (count < available
+                && queue->_copy_fun (source + count * queue->_element_size, _cgc_spsc_queue_slot (queue, tail + count)) == 0)
+                ++count;
+        else if (available != 0)
+        {
+            /* At most two memcpy: before and after the end of the buffer. */
+            size_t offset = tail & (queue->_capacity - 1);
+            size_t first = queue->_capacity - offset < available ? queue->_capacity - offset : available;
+            memcpy (_cgc_spsc_queue_slot (queue, tail), source, first * queue->_element_size);
+            memcpy (queue->_content, source + first * queue->_element_size, (available - first) * queue->_element_size);
+            count = available;
+        }
+
+        if (count != 0)
+            atomic_store_explicit (& queue->_tail, tail + count, memory_order_release);
+    }
+
+    return count;
+}
+
+int cgc_spsc_queue_pop_into (cgc_spsc_queue * queue, void * destination)
+{
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    size_t head = 0;
+    if (! error)
+    {
+        head = atomic_load_explicit (& queue->_head, memory_order_relaxed);
+        if (_cgc_spsc_queue_used_slots (queue, head, 1) == 0)
+        {
+            error = -1;
+            errno = EAGAIN;
+        }
+    }
+
+    if (! error)
+    {
+        memcpy (destination, _cgc_spsc_queue_slot (queue, head), queue->_element_size);
+        atomic_store_explicit (& queue->_head, head + 1, memory_order_release);
+    }
+
+    return error;
+}
+
+size_t cgc_spsc_queue_pop_n (cgc_spsc_queue * queue, void * destination, size_t n)
+{
+    size_t count = 0;
+    int error = cgc_check_pointer (queue);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    if (! error)
+    {
+        char * const target = destination;
+        size_t head = atomic_load_explicit (& queue->_head, memory_order_relaxed);
+        count = _cgc_spsc_queue_used_slots (queue, head, n);
+
+        if (count != 0)
+        {
+            size_t offset = head & (queue->_capacity - 1);
+            size_t first = queue->_capacity - offset < count ? queue->_capacity - offset : count;
+            memcpy (target, _cgc_spsc_queue_slot (queue, head), first * queue->_element_size);
+            memcpy (target + first * queue->_element_size, queue->_content, (count - first) * queue->_element_size);
+            atomic_store_explicit (& queue->_head, head + count, memory_order_release);
+        }
+    }
+
+    return count;
+}
+
+int cgc_spsc_queue_clear (cgc_spsc_queue * queue)
+{
+    int error = cgc_check_pointer (queue);
+
+    if (! error)
+    {
+        size_t head = atomic_load_explicit (& queue->_head, memory_order_relaxed);
+        size_t tail = atomic_load_explicit (& queue->_tail, memory_order_relaxed);
+        if (queue->_clean_fun != NULL)
+            for (size_t i = head; i != tail; ++i)
+                queue->_clean_fun (_cgc_spsc_queue_slot (queue, i));
+
+        atomic_store_explicit (& queue->_head, tail, memory_order_relaxed);
+        queue->_cached_head = tail;
+        queue->_cached_tail = tail;
+    }
+
+    return error;
+}
@@ -23,18 +23,75 @@
  */
 #include "cgc/stack.h"
 
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initial number of elements of the array.
+ */
+static const size_t _DEFAULT_CAPACITY = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Get an element of a stack.
+ * \param stack A pointer to a CGC Stack.
+ * \param i Index of the element, from the bottom.
+ * \return A pointer to the element.
+ */
+static inline void * _cgc_stack_at (const cgc_stack * const stack, size_t i)
+{
+    return stack->_content + i * stack->_element_size;
+}
+
+/**
+ * \brief Resize the array.
+ * \param stack A pointer to a CGC Stack.
+ * \param capacity The new number of elements.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of realloc.
+ */
+static int _cgc_stack_grow (cgc_stack * const stack, size_t capacity)
+{
+    int error = 0;
+    char * content = NULL;
+    if (stack->_element_size == 0 || capacity <= SIZE_MAX / stack->_element_size)
+        content = realloc (stack->_content, capacity * stack->_element_size);
+
+    if (content != NULL)
+    {
+        stack->_content = content;
+        stack->_capacity = capacity;
+    }
+    else
+        error = -2;
+
+    return error;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Dynamic creation and destruction.
 ////////////////////////////////////////////////////////////////////////////////
 
 cgc_stack * cgc_stack_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
 {
-    return cgc_list_create (element_size, copy_fun, clean_fun);
+    cgc_stack * stack = malloc (sizeof * stack);
+    if (stack != NULL)
+        cgc_stack_init (stack, element_size, copy_fun, clean_fun);
+
+    return stack;
 }
 
 void cgc_stack_destroy (cgc_stack * stack)
 {
-    cgc_list_destroy (stack);
+    if (stack != NULL)
+    {
+        cgc_stack_clean (stack);
+        free (stack);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -43,12 +100,41 @@ void cgc_stack_destroy (cgc_stack * stack)
 
 int cgc_stack_init (cgc_stack * stack, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
 {
-    return cgc_list_init (stack, element_size, copy_fun, clean_fun);
+    int error = cgc_check_pointer (stack);
+
+    if (! error)
+    {
+        stack->_content = NULL;
+        stack->_size = 0;
+        stack->_capacity = 0;
+        stack->_element_size = element_size;
+        stack->_copy_fun = copy_fun;
+        stack->_clean_fun = clean_fun;
+    }
+
+    return error;
 }
 
 int cgc_stack_clean (cgc_stack * stack)
 {
-    return cgc_list_clean (stack);
+    int error = cgc_stack_clear (stack);
+    if (! error)
+    {
+        free (stack->_content);
+        stack->_content = NULL;
+        stack->_capacity = 0;
+    }
+
+    return error;
+}
+
+int cgc_stack_reserve (cgc_stack * stack, size_t capacity)
+{
+    int error = cgc_check_pointer (stack);
+    if (! error && capacity > stack->_capacity)
+        error = _cgc_stack_grow (stack, capacity);
+
+    return error;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,12 +143,38 @@ int cgc_stack_clean (cgc_stack * stack)
 
 cgc_stack * cgc_stack_copy (const cgc_stack * stack)
 {
-    return cgc_list_copy (stack);
+    cgc_stack * copy = NULL;
+    if (stack != NULL)
+    {
+        copy = cgc_stack_create (stack->_element_size, stack->_copy_fun, stack->_clean_fun);
+        if (copy != NULL)
+            cgc_stack_copy_into (stack, copy);
+    }
+
+    return copy;
 }
 
 int cgc_stack_copy_into (const cgc_stack * original, cgc_stack * destination)
 {
-    return cgc_list_copy_into (original, destination);
+    int error = cgc_check_pointer (original);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    if (! error)
+        error = cgc_stack_init (destination, original->_element_size, original->_copy_fun, original->_clean_fun);
+    if (! error)
+        error = cgc_stack_reserve (destination, original->_size);
+
+    if (! error && original->_copy_fun == NULL && original->_size != 0)
+    {
+        memcpy (destination->_content, original->_content, original->_size * original->_element_size);
+        destination->_size = original->_size;
+    }
+    else
+        for (size_t i = 0; ! error && i < original->_size; ++i)
+            error = cgc_stack_push (destination, _cgc_stack_at (original, i));
+
+    return error;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -71,7 +183,18 @@ int cgc_stack_copy_into (const cgc_stack * original, cgc_stack * destination)
 
 int cgc_stack_swap (cgc_stack * a, cgc_stack * b)
 {
-    return cgc_list_swap (a, b);
+    int error = cgc_check_pointer (a);
+    if (! error)
+        error = cgc_check_pointer (b);
+
+    if (! error)
+    {
+        cgc_stack tmp = * a;
+        * a = * b;
+        * b = tmp;
+    }
+
+    return error;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,12 +203,12 @@ int cgc_stack_swap (cgc_stack * a, cgc_stack * b)
 
 bool cgc_stack_is_empty (const cgc_stack * stack)
 {
-    return cgc_list_is_empty (stack);
+    return stack->_size == 0;
 }
 
 size_t cgc_stack_size (const cgc_stack * stack)
 {
-    return cgc_list_size (stack);
+    return stack->_size;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -94,7 +217,7 @@ size_t cgc_stack_size (const cgc_stack * stack)
 
 void * cgc_stack_top (const cgc_stack * stack)
 {
-    return cgc_list_front (stack);
+    return _cgc_stack_at (stack, stack->_size - 1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,15 +226,133 @@ void * cgc_stack_top (const cgc_stack * stack)
 
 int cgc_stack_push (cgc_stack * stack, const void * element)
 {
-    return cgc_list_push_front (stack, element);
+    int error = cgc_check_pointer (stack);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    if (! error && stack->_size == stack->_capacity)
+    {
+        size_t capacity = stack->_capacity == 0 ? _DEFAULT_CAPACITY
+            : stack->_capacity <= SIZE_MAX / 2 ? stack->_capacity * 2 : 0;
+        error = capacity > stack->_capacity ? _cgc_stack_grow (stack, capacity) : -2;
+    }
+
+    if (! error)
+    {
+        void * const content = _cgc_stack_at (stack, stack->_size);
+        if (stack->_copy_fun != NULL)
+            error = stack->_copy_fun (element, content);
+        else
+            memcpy (content, element, stack->_element_size);
+
+        if (! error)
+            stack->_size++;
+    }
+
+    return error;
 }
 
 void * cgc_stack_pop (cgc_stack * stack)
 {
-    return cgc_list_pop_front (stack);
+    void * element = NULL;
+    if (stack != NULL)
+    {
+        element = malloc (stack->_element_size);
+        if (element != NULL && cgc_stack_pop_into (stack, element) != 0)
+        {
+            free (element);
+            element = NULL;
+        }
+    }
+
+    return element;
+}
+
+int cgc_stack_pop_into (cgc_stack * stack, void * destination)
+{
+    int error = cgc_check_pointer (stack);
+    if (! error)
+        error = cgc_check_pointer (destination);
+    if (! error && stack->_size == 0)
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error)
+    {
+        stack->_size--;
+        memcpy (destination, _cgc_stack_at (stack, stack->_size), stack->_element_size);
+    }
+
+    return error;
+}
+
+int cgc_stack_push_n (cgc_stack * stack, const void * elements, size_t count)
+{
+    int error = cgc_check_pointer (stack);
+    if (! error)
+        error = cgc_check_pointer (elements);
+    if (! error && count > SIZE_MAX - stack->_size)
+    {
+        error = -2;
+        errno = ENOMEM;
+    }
+
+    if (! error && stack->_size + count > stack->_capacity)
+    {
+        size_t capacity = stack->_capacity <= SIZE_MAX / 2 ? stack->_capacity * 2 : SIZE_MAX;
+        if (capacity < stack->_size + count)
+            capacity = stack->_size + count;
+        if (capacity < _DEFAULT_CAPACITY)
+            capacity = _DEFAULT_CAPACITY;
+        error = _cgc_stack_grow (stack, capacity);
+    }
+
+    if (! error && count > 0 && stack->_copy_fun == NULL)
+    {
+        memcpy (_cgc_stack_at (stack, stack->_size), elements, count * stack->_element_size);
+        stack->_size += count;
+    }
+    else if (! error)
+    {
+        const char * element = elements;
+        for (size_t i = 0; ! error && i < count; ++i, element += stack->_element_size)
+        {
+            error = stack->_copy_fun (element, _cgc_stack_at (stack, stack->_size));
+            if (! error)
+                stack->_size++;
+        }
+    }
+
+    return error;
+}
+
+size_t cgc_stack_pop_n (cgc_stack * stack, void * destination, size_t max)
+{
+    size_t count = 0;
+    if (stack != NULL && destination != NULL)
+    {
+        count = stack->_size < max ? stack->_size : max;
+        stack->_size -= count;
+        if (count > 0)
+            memcpy (destination, _cgc_stack_at (stack, stack->_size), count * stack->_element_size);
+    }
+
+    return count;
 }
 
 int cgc_stack_clear (cgc_stack * stack)
 {
-    return cgc_list_clear (stack);
+    int error = cgc_check_pointer (stack);
+
+    if (! error)
+    {
+        if (stack->_clean_fun != NULL)
+            for (size_t i = 0; i < stack->_size; ++i)
+                stack->_clean_fun (_cgc_stack_at (stack, i));
+        stack->_size = 0;
+    }
+
+    return error;
 }
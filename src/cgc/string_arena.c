@@ -0,0 +1,223 @@
+/**
+ * \file string_arena.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/string_arena.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Capacity of the blocks when none is supplied.
+ */
+static const size_t _DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Allocate a block.
+ * \param capacity Number of bytes of the block.
+ * \return A pointer to the new block, or \c NULL in case of failure.
+ */
+static cgc_string_arena_block * _cgc_string_arena_new_block (size_t capacity)
+{
+    cgc_string_arena_block * block = NULL;
+    if (capacity <= SIZE_MAX - sizeof * block)
+        block = malloc (sizeof * block + capacity);
+
+    if (block != NULL)
+    {
+        block->_previous = NULL;
+        block->_size = 0;
+        block->_capacity = capacity;
+    }
+
+    return block;
+}
+
+/**
+ * \brief Free a chain of blocks.
+ * \param block The most recent block of the chain.
+ */
+static void _cgc_string_arena_free_blocks (cgc_string_arena_block * block)
+{
+    while (block != NULL)
+    {
+        cgc_string_arena_block * const previous = block->_previous;
+        free (block);
+        block = previous;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_string_arena * cgc_string_arena_create (size_t block_size)
+{
+    cgc_string_arena * arena = malloc (sizeof * arena);
+    if (arena != NULL)
+        cgc_string_arena_init (arena, block_size);
+
+    return arena;
+}
+
+void cgc_string_arena_destroy (cgc_string_arena * arena)
+{
+    if (arena != NULL)
+    {
+        cgc_string_arena_clean (arena);
+        free (arena);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_string_arena_init (cgc_string_arena * arena, size_t block_size)
+{
+    int error = cgc_check_pointer (arena);
+    if (! error)
+    {
+        arena->_current = NULL;
+        arena->_block_size = block_size != 0 ? block_size : _DEFAULT_BLOCK_SIZE;
+        arena->_size = 0;
+    }
+
+    return error;
+}
+
+int cgc_string_arena_clean (cgc_string_arena * arena)
+{
+    int error = cgc_check_pointer (arena);
+    if (! error)
+    {
+        _cgc_string_arena_free_blocks (arena->_current);
+        arena->_current = NULL;
+        arena->_size = 0;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+size_t cgc_string_arena_size (const cgc_string_arena * arena)
+{
+    return arena->_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+char * cgc_string_arena_allocate (cgc_string_arena * arena, size_t size)
+{
+    char * memory = NULL;
+    if (arena != NULL)
+    {
+        cgc_string_arena_block * current = arena->_current;
+        if (current != NULL && current->_capacity - current->_size >= size)
+        {
+            memory = current->_content + current->_size;
+            current->_size += size;
+        }
+        else if (size > arena->_block_size / 4)
+        {
+            /* Large strings get their own block, behind the current one. */
+            cgc_string_arena_block * const block = _cgc_string_arena_new_block (size);
+            if (block != NULL)
+            {
+                block->_size = size;
+                memory = block->_content;
+                if (current != NULL)
+                {
+                    block->_previous = current->_previous;
+                    current->_previous = block;
+                }
+                else
+                    arena->_current = block;
+            }
+        }
+        else
+        {
+            cgc_string_arena_block * const block = _cgc_string_arena_new_block (arena->_block_size);
+            if (block != NULL)
+            {
+                block->_previous = current;
+                block->_size = size;
+                memory = block->_content;
+                arena->_current = block;
+            }
+        }
+
+        if (memory != NULL)
+            arena->_size += size;
+    }
+
+    return memory;
+}
+
+char * cgc_string_arena_store (cgc_string_arena * arena, const char * data, size_t length)
+{
+    char * copy = NULL;
+    if (data != NULL && length < SIZE_MAX)
+        copy = cgc_string_arena_allocate (arena, length + 1);
+
+    if (copy != NULL)
+    {
+        memcpy (copy, data, length);
+        copy[length] = '\0';
+    }
+
+    return copy;
+}
+
+int cgc_string_arena_clear (cgc_string_arena * arena)
+{
+    int error = cgc_check_pointer (arena);
+    if (! error && arena->_current != NULL)
+    {
+        cgc_string_arena_block * const current = arena->_current;
+        _cgc_string_arena_free_blocks (current->_previous);
+        if (current->_capacity == arena->_block_size)
+        {
+            current->_previous = NULL;
+            current->_size = 0;
+        }
+        else
+        {
+            free (current);
+            arena->_current = NULL;
+        }
+    }
+    if (! error)
+        arena->_size = 0;
+
+    return error;
+}
@@ -0,0 +1,444 @@
+/**
+ * \file string_pool.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/string_pool.h"
+
+#if defined (__SSE2__) && defined (__GNUC__)
+#include <emmintrin.h>
+#define _CGC_STRING_POOL_SSE2
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Initial number of slots.
+ * \note Must be a power of two.
+ */
+static const size_t _DEFAULT_CAPACITY = 16;
+
+/**
+ * \brief Odd constant used to mix the hashes (the golden ratio).
+ */
+static const uint64_t _MULTIPLIER = UINT64_C (0x9E3779B97F4A7C15);
+
+#if defined (_CGC_STRING_POOL_SSE2)
+/**
+ * \brief Length from which strings are hashed 64 bytes at a time with SSE2.
+ *
+ * Shorter strings, such as most identifiers, are hashed faster by the scalar
+ * loop, which needs no setup and no final reduction.
+ */
+static const size_t _SSE2_THRESHOLD = 128;
+
+/**
+ * \brief Keys mixed into each 16 bytes block of a 64 bytes stripe.
+ */
+static const uint64_t _SSE2_KEYS[8] =
+{
+    UINT64_C (0xBE4BA423396CFEB8), UINT64_C (0x1CAD21F72C81017C),
+    UINT64_C (0xDB979083E96DD4DE), UINT64_C (0x1F67B3B7A4A44072),
+    UINT64_C (0x78E5C0CC4EE679CB), UINT64_C (0x2172FFCC7DD05A82),
+    UINT64_C (0x8E2443F7744608B8), UINT64_C (0x4C263A81E69035E0),
+};
+
+/**
+ * \brief 32 bits prime used to scramble the SSE2 accumulators, in each lane.
+ */
+static const uint32_t _SSE2_PRIME[4] = { 0x9E3779B1, 0x9E3779B1, 0x9E3779B1, 0x9E3779B1 };
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Canonical copy of a string.
+ */
+typedef struct _cgc_string_pool_entry
+{
+    const char * _data;     /**<- Characters. */
+    size_t _length;         /**<- Number of characters. */
+} _cgc_string_pool_entry;
+
+/**
+ * \brief Mix a word into a hash.
+ * \param hash Hash.
+ * \param word Word.
+ * \return New hash.
+ */
+static inline uint64_t _cgc_string_pool_mix (uint64_t hash, uint64_t word)
+{
+    hash = (hash ^ word) * _MULTIPLIER;
+    return hash ^ (hash >> 29);
+}
+
+#if defined (_CGC_STRING_POOL_SSE2)
+/**
+ * \brief Hash the 64 bytes stripes of a string with SSE2.
+ * \param data Characters.
+ * \param length Number of characters, at least 64.
+ * \param hash Hash of the preceding characters.
+ * \return Hash.
+ *
+ * Each 16 bytes block is mixed with its key, and two 32 bits multiplications
+ * per lane are added to the two 64 bits accumulators, as in XXH3. The
+ * accumulators are scrambled after each stripe, so that the order of the
+ * stripes matters. Only the whole stripes are read: the caller hashes the
+ * remaining \c length % 64 characters.
+ */
+static uint64_t _cgc_string_pool_hash_stripes (const char * data, size_t length, uint64_t hash)
+{
+    const __m128i prime = _mm_loadu_si128 ((const __m128i *) (const void *) _SSE2_PRIME);
+    __m128i accumulator = _mm_set_epi64x ((long long) (hash >> 1), (long long) (~hash >> 1));
+    for (; length >= 64; length -= 64, data += 64)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const __m128i block = _mm_loadu_si128 ((const __m128i *) (const void *) (data + 16 * i));
+            const __m128i key = _mm_loadu_si128 ((const __m128i *) (const void *) (_SSE2_KEYS + 2 * i));
+            const __m128i keyed = _mm_xor_si128 (block, key);
+            const __m128i product = _mm_mul_epu32 (keyed, _mm_shuffle_epi32 (keyed, _MM_SHUFFLE (0, 3, 0, 1)));
+            accumulator = _mm_add_epi64 (accumulator, _mm_shuffle_epi32 (block, _MM_SHUFFLE (1, 0, 3, 2)));
+            accumulator = _mm_add_epi64 (accumulator, product);
+        }
+        accumulator = _mm_xor_si128 (accumulator, _mm_srli_epi64 (accumulator, 47));
+        const __m128i low = _mm_mul_epu32 (accumulator, prime);
+        const __m128i high = _mm_mul_epu32 (_mm_srli_epi64 (accumulator, 32), prime);
+        accumulator = _mm_add_epi64 (low, _mm_slli_epi64 (high, 32));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128 ((__m128i *) (void *) lanes, accumulator);
+    return _cgc_string_pool_mix (_cgc_string_pool_mix (hash, lanes[0]), lanes[1]);
+}
+#endif
+
+/**
+ * \brief Hash a string.
+ * \param data Characters.
+ * \param length Number of characters.
+ * \return Hash.
+ *
+ * The string is read eight bytes at a time; each word is folded in with a
+ * multiplication, and the result goes through the finalizer of MurmurHash3
+ * so that every bit of the hash depends on every bit of the string. With SSE2,
+ * long strings are first hashed 64 bytes at a time.
+ */
+static uint64_t _cgc_string_pool_hash (const char * data, size_t length)
+{
+    uint64_t hash = (uint64_t) length * _MULTIPLIER;
+#if defined (_CGC_STRING_POOL_SSE2)
+    if (length >= _SSE2_THRESHOLD)
+    {
+        hash = _cgc_string_pool_hash_stripes (data, length, hash);
+        data += length - length % 64;
+        length %= 64;
+    }
+#endif
+
+    uint64_t word;
+    for (; length >= sizeof word; length -= sizeof word, data += sizeof word)
+    {
+        memcpy (& word, data, sizeof word);
+        hash = _cgc_string_pool_mix (hash, word);
+    }
+    if (length > 0)
+    {
+        word = 0;
+        memcpy (& word, data, length);
+        hash = _cgc_string_pool_mix (hash, word);
+    }
+
+    hash ^= hash >> 33;
+    hash *= UINT64_C (0xFF51AFD7ED558CCD);
+    hash ^= hash >> 33;
+    hash *= UINT64_C (0xC4CEB9FE1A85EC53);
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * \brief Get the canonical copy of a string.
+ * \param pool A pointer to a CGC String pool.
+ * \param id Id.
+ * \return A pointer to the entry of the string.
+ */
+static inline const _cgc_string_pool_entry * _cgc_string_pool_entry_at (const cgc_string_pool * const pool, uint32_t id)
+{
+    return cgc_vector_at (& pool->_strings, id);
+}
+
+/**
+ * \brief Find the slot of a string, or the free slot it would take.
+ * \param pool A pointer to a CGC String pool.
+ * \param data Characters.
+ * \param length Number of characters.
+ * \param hash Hash of the string.
+ * \return A pointer to the slot.
+ */
+static cgc_string_pool_slot * _cgc_string_pool_probe (const cgc_string_pool * const pool, const char * const data, size_t length, uint32_t hash)
+{
+    const size_t mask = pool->_capacity - 1;
+    size_t index = hash & mask;
+    for (;;)
+    {
+        cgc_string_pool_slot * const slot = & pool->_slots[index];
+        if (slot->_id == 0)
+            return slot;
+        if (slot->_hash == hash)
+        {
+            const _cgc_string_pool_entry * const entry = _cgc_string_pool_entry_at (pool, slot->_id - 1);
+            if (entry->_length == length && memcmp (entry->_data, data, length) == 0)
+                return slot;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+/**
+ * \brief Double the number of slots.
+ * \param pool A pointer to a CGC String pool.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of malloc.
+ */
+static int _cgc_string_pool_grow (cgc_string_pool * const pool)
+{
+    int error = 0;
+    size_t capacity = pool->_capacity * 2;
+    cgc_string_pool_slot * slots = NULL;
+    if (pool->_capacity <= SIZE_MAX / 2 / sizeof * slots)
+        slots = calloc (capacity, sizeof * slots);
+
+    if (slots != NULL)
+    {
+        for (size_t i = 0; i < pool->_capacity; ++i)
+            if (pool->_slots[i]._id != 0)
+            {
+                size_t index = pool->_slots[i]._hash & (capacity - 1);
+                while (slots[index]._id != 0)
+                    index = (index + 1) & (capacity - 1);
+                slots[index] = pool->_slots[i];
+            }
+        free (pool->_slots);
+        pool->_slots = slots;
+        pool->_capacity = capacity;
+    }
+    else
+        error = -2;
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_string_pool * cgc_string_pool_create (void)
+{
+    cgc_string_pool * pool = malloc (sizeof * pool);
+    if (pool != NULL && cgc_string_pool_init (pool) != 0)
+    {
+        free (pool);
+        pool = NULL;
+    }
+
+    return pool;
+}
+
+void cgc_string_pool_destroy (cgc_string_pool * pool)
+{
+    if (pool != NULL)
+    {
+        cgc_string_pool_clean (pool);
+        free (pool);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_string_pool_init (cgc_string_pool * pool)
+{
+    int error = cgc_check_pointer (pool);
+    if (! error)
+    {
+        pool->_capacity = _DEFAULT_CAPACITY;
+        pool->_slots = calloc (pool->_capacity, sizeof * pool->_slots);
+        if (pool->_slots == NULL)
+            error = -2;
+    }
+    if (! error)
+    {
+        error = cgc_vector_init (& pool->_strings, sizeof (_cgc_string_pool_entry), NULL, NULL, 0);
+        if (error)
+            free (pool->_slots);
+    }
+    if (! error)
+    {
+        error = cgc_string_arena_init (& pool->_arena, 0);
+        if (error)
+        {
+            free (pool->_strings._content);
+            free (pool->_slots);
+        }
+    }
+
+    return error;
+}
+
+int cgc_string_pool_clean (cgc_string_pool * pool)
+{
+    int error = cgc_check_pointer (pool);
+    if (! error)
+    {
+        free (pool->_slots);
+        pool->_slots = NULL;
+        pool->_capacity = 0;
+        cgc_vector_clean (& pool->_strings);
+        free (pool->_strings._content);
+        pool->_strings._content = NULL;
+        cgc_string_arena_clean (& pool->_arena);
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+size_t cgc_string_pool_size (const cgc_string_pool * pool)
+{
+    return cgc_vector_size (& pool->_strings);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+const char * cgc_string_pool_string (const cgc_string_pool * pool, uint32_t id)
+{
+    return _cgc_string_pool_entry_at (pool, id)->_data;
+}
+
+size_t cgc_string_pool_length (const cgc_string_pool * pool, uint32_t id)
+{
+    return _cgc_string_pool_entry_at (pool, id)->_length;
+}
+
+bool cgc_string_pool_find (const cgc_string_pool * pool, const char * data, size_t length, uint32_t * id)
+{
+    bool found = false;
+    if (pool != NULL && data != NULL)
+    {
+        uint32_t hash = (uint32_t) (_cgc_string_pool_hash (data, length) >> 32);
+        const cgc_string_pool_slot * const slot = _cgc_string_pool_probe (pool, data, length, hash);
+        found = slot->_id != 0;
+        if (found && id != NULL)
+            * id = slot->_id - 1;
+    }
+
+    return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_string_pool_intern_n (cgc_string_pool * pool, const char * data, size_t length, uint32_t * id)
+{
+    int error = cgc_check_pointer (pool);
+    if (! error)
+        error = cgc_check_pointer (data);
+
+    cgc_string_pool_slot * slot = NULL;
+    uint32_t hash = 0;
+    if (! error)
+    {
+        hash = (uint32_t) (_cgc_string_pool_hash (data, length) >> 32);
+        slot = _cgc_string_pool_probe (pool, data, length, hash);
+    }
+
+    if (! error && slot->_id == 0)
+    {
+        size_t size = cgc_string_pool_size (pool);
+        if (size >= UINT32_MAX)
+            error = -2;
+
+        /* Keep the load factor under 3/4. */
+        if (! error && (size + 1) * 4 > pool->_capacity * 3)
+        {
+            error = _cgc_string_pool_grow (pool);
+            if (! error)
+                slot = _cgc_string_pool_probe (pool, data, length, hash);
+        }
+
+        if (! error && size == cgc_vector_max_size (& pool->_strings))
+            error = cgc_vector_reserve (& pool->_strings, size * 2);
+
+        _cgc_string_pool_entry entry = { NULL, length };
+        if (! error)
+        {
+            entry._data = cgc_string_arena_store (& pool->_arena, data, length);
+            if (entry._data == NULL)
+                error = -2;
+        }
+        if (! error)
+            error = cgc_vector_push_back (& pool->_strings, & entry);
+        if (! error)
+        {
+            slot->_id = (uint32_t) size + 1;
+            slot->_hash = hash;
+        }
+    }
+
+    if (! error && id != NULL)
+        * id = slot->_id - 1;
+
+    return error;
+}
+
+int cgc_string_pool_intern (cgc_string_pool * pool, const char * string, uint32_t * id)
+{
+    int error = cgc_check_pointer (string);
+    if (! error)
+        error = cgc_string_pool_intern_n (pool, string, strlen (string), id);
+
+    return error;
+}
+
+int cgc_string_pool_clear (cgc_string_pool * pool)
+{
+    int error = cgc_check_pointer (pool);
+    if (! error)
+    {
+        memset (pool->_slots, 0, pool->_capacity * sizeof * pool->_slots);
+        cgc_vector_clear (& pool->_strings);
+        cgc_string_arena_clear (& pool->_arena);
+    }
+
+    return error;
+}
@@ -21,60 +21,543 @@
  * and the GNU General Public License along with this program.
  * If not, see http://www.gnu.org/licenses/.
  */
+#define _POSIX_C_SOURCE 200809L
+
 #include "cgc/string_vector.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 // Static utilities.
 ////////////////////////////////////////////////////////////////////////////////
 
+_Static_assert (sizeof (cgc_string_vector_entry) == 3 * sizeof (size_t),
+    "string vector entries shall be three words long");
+_Static_assert (offsetof (cgc_string_vector_entry, _long._tag) == sizeof (cgc_string_vector_entry) - 1,
+    "the tag of long strings shall overlap the last inline byte");
+
+/**
+ * \brief Tag of the entries of long strings.
+ */
+static const unsigned char _LONG_TAG = UCHAR_MAX;
+
+/**
+ * \brief Tag of the entries of interned strings.
+ */
+static const unsigned char _INTERNED_TAG = UCHAR_MAX - 1;
+
+/**
+ * \brief Check whether an entry holds its string inline.
+ * \param entry Entry.
+ * \retval true if the string is stored in the entry.
+ * \retval false if the string is stored in the arena or in the pool.
+ */
+static inline bool _cgc_string_vector_is_inline (const cgc_string_vector_entry * const entry)
+{
+    return entry->_long._tag <= CGC_STRING_VECTOR_INLINE_LENGTH;
+}
+
+/**
+ * \brief Get the characters of an entry.
+ * \param entry Entry.
+ * \return A pointer to the characters.
+ */
+static inline const char * _cgc_string_vector_data (const cgc_string_vector_entry * const entry)
+{
+    return _cgc_string_vector_is_inline (entry) ? entry->_inline : entry->_long._data;
+}
+
 /**
- * \brief CGC implementation of strdup.
- * \param string String of interest.
- * \return A pointer to a copy of the string.
- * strdup is not available in C99.
+ * \brief Get the length of the string of an entry.
+ * \param vector A pointer to a CGC String vector.
+ * \param entry Entry.
+ * \return Number of characters.
  */
-static inline char * _cgc_strdup (const char * const string)
+static inline size_t _cgc_string_vector_length (const cgc_string_vector * const vector, const cgc_string_vector_entry * const entry)
 {
-    char * copy = malloc ((strlen (string) + 1) * sizeof (char));
+    if (_cgc_string_vector_is_inline (entry))
+        return entry->_long._tag;
+    else if (entry->_long._tag == _INTERNED_TAG)
+        return cgc_string_pool_length (vector->_pool, entry->_long._id);
+    else
+        return entry->_long._length;
+}
+
+/**
+ * \brief Copy a string of the vector into a newly allocated memory area.
+ * \param vector A pointer to a CGC String vector.
+ * \param entry Entry of the string.
+ * \return A pointer to the copy, or \c NULL in case of failure.
+ */
+static char * _cgc_string_vector_duplicate (const cgc_string_vector * const vector, const cgc_string_vector_entry * const entry)
+{
+    size_t length = _cgc_string_vector_length (vector, entry);
+    char * copy = malloc (length + 1);
     if (copy != NULL)
-        strcpy (copy, string);
+    {
+        memcpy (copy, _cgc_string_vector_data (entry), length);
+        copy[length] = '\0';
+    }
     return copy;
 }
 
 /**
- * \brief Cleaning function for CGC String Vectors.
- * \param content.
- * cgc_string_vector's store pointers to strings... C strings are pointers to
- * characters...
+ * \brief Make room for one more entry.
+ * \param vector A pointer to a CGC String vector.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of malloc.
+ * \note The entries grow geometrically, instead of following the size step
+ * of the underlying cgc_vector.
+ */
+static int _cgc_string_vector_make_room (cgc_string_vector * const vector)
+{
+    int error = 0;
+    size_t size = cgc_vector_size (& vector->_entries);
+    if (size == cgc_vector_max_size (& vector->_entries))
+        error = cgc_vector_reserve (& vector->_entries, size <= SIZE_MAX / 2 ? size * 2 : SIZE_MAX);
+
+    return error;
+}
+
+/**
+ * \brief Fill an entry with a string and make room for the entry.
+ * \param vector A pointer to a CGC String vector.
+ * \param data Characters.
+ * \param length Number of characters.
+ * \param entry Entry to fill.
+ * \retval 0 in case of success.
+ * \retval -1 if one of the arguments is \c NULL.
+ * \retval -2 in case of failure because of malloc.
+ * \note Short strings are copied into the entry, long ones into the arena.
+ * In the interned mode, every string is interned in the pool instead.
+ */
+static int _cgc_string_vector_prepare (cgc_string_vector * const vector, const char * const data, size_t length, cgc_string_vector_entry * const entry)
+{
+    int error = cgc_check_pointer (vector);
+    if (! error)
+        error = cgc_check_pointer (data);
+
+    if (! error)
+    {
+        if (vector->_pool != NULL)
+        {
+            uint32_t id;
+            error = cgc_string_pool_intern_n (vector->_pool, data, length, & id);
+            if (! error)
+            {
+                entry->_long._data = cgc_string_pool_string (vector->_pool, id);
+                entry->_long._id = id;
+                entry->_long._tag = _INTERNED_TAG;
+            }
+        }
+        else if (length <= CGC_STRING_VECTOR_INLINE_LENGTH)
+        {
+            memcpy (entry->_inline, data, length);
+            entry->_inline[length] = '\0';
+            entry->_long._tag = (unsigned char) length;
+        }
+        else
+        {
+            entry->_long._data = cgc_string_arena_store (& vector->_arena, data, length);
+            entry->_long._length = length;
+            entry->_long._tag = _LONG_TAG;
+            if (entry->_long._data == NULL)
+                error = -2;
+        }
+    }
+
+    if (! error)
+        error = _cgc_string_vector_make_room (vector);
+
+    return error;
+}
+
+/**
+ * \brief Split the mapping of a vector into strings.
+ * \param vector A pointer to a CGC String vector.
+ * \param delimiter Delimiter of the strings.
+ * \param flags Flags of cgc_string_vector_load_file().
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of malloc.
+ * \note The strings are views into the mapping, except the last one when the
+ * strings must be null terminated but the mapping does not end with a
+ * delimiter: it is then copied into the arena.
+ */
+static int _cgc_string_vector_split (cgc_string_vector * const vector, char delimiter, int flags)
+{
+    int error = 0;
+    char * const end = (char *) vector->_mapping + vector->_mapping_size;
+    for (char * string = vector->_mapping; ! error && string < end; )
+    {
+        char * next = memchr (string, delimiter, (size_t) (end - string));
+        if (next == NULL)
+            next = end;
+
+        cgc_string_vector_entry entry;
+        entry._long._data = string;
+        entry._long._length = (size_t) (next - string);
+        entry._long._tag = _LONG_TAG;
+        if (entry._long._length > 0 || ! (flags & CGC_STRING_VECTOR_LOAD_SKIP_EMPTY))
+        {
+            if (flags & CGC_STRING_VECTOR_LOAD_TERMINATE)
+            {
+                if (next < end)
+                    * next = '\0';
+                else
+                {
+                    entry._long._data = cgc_string_arena_store (& vector->_arena, string, entry._long._length);
+                    if (entry._long._data == NULL)
+                        error = -2;
+                }
+            }
+            if (! error)
+                error = _cgc_string_vector_make_room (vector);
+            if (! error)
+                error = cgc_vector_push_back (& vector->_entries, & entry);
+        }
+        if (next == end)
+            break;
+        string = next + 1;
+    }
+
+    return error;
+}
+
+/**
+ * \brief Unmap the file a vector was loaded from, if any.
+ * \param vector A pointer to a CGC String vector.
+ */
+static void _cgc_string_vector_unmap (cgc_string_vector * const vector)
+{
+    if (vector->_mapping != NULL)
+        munmap (vector->_mapping, vector->_mapping_size);
+    vector->_mapping = NULL;
+    vector->_mapping_size = 0;
+}
+
+/**
+ * \brief Number of strings under which ranges are sorted by insertion.
+ */
+static const size_t _INSERTION_SORT_THRESHOLD = 16;
+
+/**
+ * \brief String being sorted.
+ */
+typedef struct _cgc_string_vector_sort_item
+{
+    const char * _data;     /**<- Characters. */
+    size_t _length;         /**<- Number of characters. */
+    uint64_t _prefix;       /**<- Eight characters from the current depth. */
+    size_t _index;          /**<- Index of the entry of the string. */
+} _cgc_string_vector_sort_item;
+
+/**
+ * \brief Read the eight characters of a string from a given depth.
+ * \param item String.
+ * \param depth Depth.
+ * \return The characters, most significant first, padded with zeroes.
+ *
+ * Comparing two prefixes as integers compares the characters as
+ * \c unsigned \c char, like memcmp().
+ */
+static inline uint64_t _cgc_string_vector_prefix (const _cgc_string_vector_sort_item * const item, size_t depth)
+{
+    unsigned char characters[sizeof (uint64_t)] = { 0 };
+    if (item->_length >= depth + sizeof characters)
+        memcpy (characters, item->_data + depth, sizeof characters);
+    else if (item->_length > depth)
+        memcpy (characters, item->_data + depth, item->_length - depth);
+
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < sizeof characters; ++i)
+        prefix = prefix << 8 | characters[i];
+    return prefix;
+}
+
+/**
+ * \brief Compare two strings whose characters before a given depth are equal.
+ * \param a First string.
+ * \param b Second string.
+ * \param depth Depth, at which the prefixes were read.
+ * \return A negative integer, zero, or a positive integer if \c a is
+ * respectively lower than, equal to or greater than \c b.
+ */
+static int _cgc_string_vector_compare_from (const _cgc_string_vector_sort_item * const a, const _cgc_string_vector_sort_item * const b, size_t depth)
+{
+    if (a->_prefix != b->_prefix)
+        return a->_prefix < b->_prefix ? -1 : 1;
+
+    size_t start = depth + sizeof (uint64_t);
+    size_t a_length = a->_length > start ? a->_length - start : 0;
+    size_t b_length = b->_length > start ? b->_length - start : 0;
+    size_t length = a_length < b_length ? a_length : b_length;
+    int result = length > 0 ? memcmp (a->_data + start, b->_data + start, length) : 0;
+    if (result == 0)
+        result = (a->_length > b->_length) - (a->_length < b->_length);
+    return result;
+}
+
+/**
+ * \brief Compare two strings by length, for qsort().
+ * \param a First string.
+ * \param b Second string.
+ * \return A negative integer, zero, or a positive integer if \c a is
+ * respectively shorter than, as long as or longer than \c b.
+ */
+static int _cgc_string_vector_compare_lengths (const void * a, const void * b)
+{
+    size_t a_length = ((const _cgc_string_vector_sort_item *) a)->_length;
+    size_t b_length = ((const _cgc_string_vector_sort_item *) b)->_length;
+    return (a_length > b_length) - (a_length < b_length);
+}
+
+/**
+ * \brief Swap two strings being sorted.
+ * \param a First string.
+ * \param b Second string.
  */
-static void _cgc_str_clean (void * const content)
+static inline void _cgc_string_vector_swap_items (_cgc_string_vector_sort_item * const a, _cgc_string_vector_sort_item * const b)
 {
-    char ** element = content;
-    free (* element);
+    _cgc_string_vector_sort_item item = * a;
+    * a = * b;
+    * b = item;
+}
+
+/**
+ * \brief Sort strings whose characters before a given depth are equal.
+ * \param items Strings, whose prefixes were read at \c depth.
+ * \param count Number of strings.
+ * \param depth Depth.
+ *
+ * This is a multikey quicksort working on eight characters at a time: the
+ * strings are partitioned around the prefix of a pivot, the lower and greater
+ * parts are sorted at the same depth, and the strings sharing the prefix of
+ * the pivot are sorted from the next eight characters on. Prefixes are read
+ * once per string and depth, so comparisons seldom touch the strings
+ * themselves.
+ */
+static void _cgc_string_vector_sort_items (_cgc_string_vector_sort_item * items, size_t count, size_t depth)
+{
+    while (count > _INSERTION_SORT_THRESHOLD)
+    {
+        /* Median of three. */
+        uint64_t a = items[0]._prefix;
+        uint64_t b = items[count / 2]._prefix;
+        uint64_t c = items[count - 1]._prefix;
+        uint64_t pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+        /* Three way partition: [0, lower) < pivot, [greater, count) > pivot. */
+        size_t lower = 0, i = 0, greater = count;
+        while (i < greater)
+        {
+            if (items[i]._prefix < pivot)
+                _cgc_string_vector_swap_items (& items[lower++], & items[i++]);
+            else if (items[i]._prefix > pivot)
+                _cgc_string_vector_swap_items (& items[i], & items[--greater]);
+            else
+                ++i;
+        }
+        if (lower > 1)
+            _cgc_string_vector_sort_items (items, lower, depth);
+        if (count - greater > 1)
+            _cgc_string_vector_sort_items (items + greater, count - greater, depth);
+        items += lower;
+        count = greater - lower;
+
+        /* Strings ending within the prefix of the pivot come first: they only
+         * differ by trailing null characters, hence by length. */
+        size_t depth_end = depth + sizeof (uint64_t);
+        size_t ended = 0;
+        for (i = 0; i < count; ++i)
+            if (items[i]._length <= depth_end)
+                _cgc_string_vector_swap_items (& items[ended++], & items[i]);
+        bool same_lengths = true;
+        for (i = 1; i < ended && same_lengths; ++i)
+            same_lengths = items[i]._length == items[0]._length;
+        if (! same_lengths)
+            qsort (items, ended, sizeof * items, _cgc_string_vector_compare_lengths);
+        items += ended;
+        count -= ended;
+
+        depth = depth_end;
+        for (i = 0; i < count; ++i)
+            items[i]._prefix = _cgc_string_vector_prefix (& items[i], depth);
+    }
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        _cgc_string_vector_sort_item item = items[i];
+        size_t j = i;
+        for (; j > 0 && _cgc_string_vector_compare_from (& items[j - 1], & item, depth) > 0; --j)
+            items[j] = items[j - 1];
+        items[j] = item;
+    }
+}
+
+/**
+ * \brief Reorder the entries of a vector as sorted items.
+ * \param vector A pointer to a CGC String vector.
+ * \param items Sorted items, whose \c _index fields are overwritten.
+ * \param count Number of items, equal to the size of the vector.
+ *
+ * The entries are permuted in place by following the cycles of the \c _index
+ * fields: each entry is moved once, and an item is marked as placed by setting
+ * its \c _index to its own position.
+ */
+static void _cgc_string_vector_permute (cgc_string_vector * const vector, _cgc_string_vector_sort_item * const items, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (items[i]._index == i)
+            continue;
+
+        cgc_string_vector_entry first;
+        memcpy (& first, cgc_vector_at (& vector->_entries, i), sizeof first);
+        size_t j = i;
+        while (items[j]._index != i)
+        {
+            const size_t k = items[j]._index;
+            memcpy (cgc_vector_at (& vector->_entries, j), cgc_vector_at (& vector->_entries, k), sizeof first);
+            items[j]._index = j;
+            j = k;
+        }
+        memcpy (cgc_vector_at (& vector->_entries, j), & first, sizeof first);
+        items[j]._index = j;
+    }
+}
+
+/**
+ * \brief Check whether two entries hold equal strings.
+ * \param vector A pointer to a CGC String vector.
+ * \param a First entry.
+ * \param b Second entry.
+ * \retval true if the strings are equal.
+ * \retval false otherwise.
+ */
+static bool _cgc_string_vector_equal (const cgc_string_vector * const vector, const cgc_string_vector_entry * const a, const cgc_string_vector_entry * const b)
+{
+    if (vector->_pool != NULL)
+        return a->_long._id == b->_long._id;
+
+    size_t length = _cgc_string_vector_length (vector, a);
+    return length == _cgc_string_vector_length (vector, b)
+        && memcmp (_cgc_string_vector_data (a), _cgc_string_vector_data (b), length) == 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // New, free.
 ////////////////////////////////////////////////////////////////////////////////
 
-/* C strings are a bit special: they are pointers to arrays of characters.
- * We can not directly copy them into the vector, since their size may vary.
- *
- * The workaround is to store pointers to strings inside the vector: the size
- * of a pointer never changes. This requires one more step in the push and
- * insertion functions (a manual copy of the string).
- *
- * No copy function is needed for pointers.
- * A cleaning function is needed: the pointed string must be freed.
+/* Short strings live in their entry, and the characters of the others are
+ * stored back to back in an arena: no copy nor cleaning function is needed
+ * for the entries, and the arena frees every long string at once.
  */
 cgc_string_vector * cgc_string_vector_create (size_t size)
 {
-    return cgc_vector_create (sizeof (char **), NULL, _cgc_str_clean, size);
+    cgc_string_vector * vector = malloc (sizeof * vector);
+    if (vector != NULL)
+    {
+        int error = cgc_vector_init (& vector->_entries, sizeof (cgc_string_vector_entry), NULL, NULL, size);
+        if (! error)
+            error = cgc_string_arena_init (& vector->_arena, 0);
+        if (error)
+        {
+            free (vector);
+            vector = NULL;
+        }
+        else
+        {
+            vector->_pool = NULL;
+            vector->_mapping = NULL;
+            vector->_mapping_size = 0;
+        }
+    }
+
+    return vector;
+}
+
+cgc_string_vector * cgc_string_vector_create_interned (size_t size, cgc_string_pool * const pool)
+{
+    cgc_string_vector * vector = NULL;
+    if (pool != NULL)
+        vector = cgc_string_vector_create (size);
+    if (vector != NULL)
+        vector->_pool = pool;
+
+    return vector;
+}
+
+/* The file is mapped privately: the mapping is read-only, unless the strings
+ * must be null terminated, in which case the delimiters are overwritten and
+ * only the pages holding a delimiter are copied by the kernel. The scan reads
+ * the file once, front to back, with memchr().
+ */
+cgc_string_vector * cgc_string_vector_load_file (const char * const path, char delimiter, int flags)
+{
+    cgc_string_vector * vector = NULL;
+    struct stat status;
+    int descriptor = -1;
+    int error = cgc_check_pointer (path);
+    if (! error)
+    {
+        descriptor = open (path, O_RDONLY);
+        if (descriptor == -1 || fstat (descriptor, & status) == -1)
+            error = -3;
+    }
+    if (! error && (uintmax_t) status.st_size > SIZE_MAX)
+    {
+        errno = EFBIG;
+        error = -3;
+    }
+    if (! error)
+    {
+        vector = cgc_string_vector_create (0);
+        if (vector == NULL)
+            error = -2;
+    }
+
+    if (! error && status.st_size > 0)
+    {
+        int protection = flags & CGC_STRING_VECTOR_LOAD_TERMINATE ? PROT_READ | PROT_WRITE : PROT_READ;
+        void * mapping = mmap (NULL, (size_t) status.st_size, protection, MAP_PRIVATE, descriptor, 0);
+        if (mapping != MAP_FAILED)
+        {
+            vector->_mapping = mapping;
+            vector->_mapping_size = (size_t) status.st_size;
+            posix_madvise (mapping, vector->_mapping_size, POSIX_MADV_SEQUENTIAL);
+            error = _cgc_string_vector_split (vector, delimiter, flags);
+            posix_madvise (mapping, vector->_mapping_size, POSIX_MADV_NORMAL);
+        }
+        else
+            error = -3;
+    }
+
+    int saved_errno = errno;
+    if (descriptor != -1)
+        close (descriptor);
+    if (error)
+    {
+        cgc_string_vector_destroy (vector);
+        vector = NULL;
+    }
+    errno = saved_errno;
+
+    return vector;
 }
 
 void cgc_string_vector_destroy (cgc_string_vector * const vector)
 {
-    cgc_vector_destroy (vector);
+    if (vector != NULL)
+    {
+        cgc_vector_clean (& vector->_entries);
+        free (vector->_entries._content);
+        cgc_string_arena_clean (& vector->_arena);
+        _cgc_string_vector_unmap (vector);
+        free (vector);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -83,39 +566,51 @@ void cgc_string_vector_destroy (cgc_string_vector * const vector)
 
 bool cgc_string_vector_is_empty (const cgc_string_vector * const vector)
 {
-    return cgc_vector_is_empty (vector);
+    return cgc_vector_is_empty (& vector->_entries);
 }
 
 size_t cgc_string_vector_size (const cgc_string_vector * const vector)
 {
-    return cgc_vector_size (vector);
+    return cgc_vector_size (& vector->_entries);
 }
 
 size_t cgc_string_vector_max_size (const cgc_string_vector * const vector)
 {
-    return cgc_vector_max_size (vector);
+    return cgc_vector_max_size (& vector->_entries);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Access.
 ////////////////////////////////////////////////////////////////////////////////
 
-char * cgc_string_vector_at (const cgc_string_vector * const vector, size_t i)
+const char * cgc_string_vector_at (const cgc_string_vector * const vector, size_t i)
+{
+    const cgc_string_vector_entry * const entry = cgc_vector_at (& vector->_entries, i);
+    return _cgc_string_vector_data (entry);
+}
+
+const char * cgc_string_vector_front (const cgc_string_vector * const vector)
+{
+    const cgc_string_vector_entry * const entry = cgc_vector_front (& vector->_entries);
+    return _cgc_string_vector_data (entry);
+}
+
+const char * cgc_string_vector_back (const cgc_string_vector * const vector)
 {
-    char ** string = cgc_vector_at (vector, i);
-    return * string;
+    const cgc_string_vector_entry * const entry = cgc_vector_back (& vector->_entries);
+    return _cgc_string_vector_data (entry);
 }
 
-char * cgc_string_vector_front (const cgc_string_vector * const vector)
+size_t cgc_string_vector_length_at (const cgc_string_vector * const vector, size_t i)
 {
-    char ** string = cgc_vector_front (vector);
-    return * string;
+    const cgc_string_vector_entry * const entry = cgc_vector_at (& vector->_entries, i);
+    return _cgc_string_vector_length (vector, entry);
 }
 
-char * cgc_string_vector_back (const cgc_string_vector * const vector)
+uint32_t cgc_string_vector_id_at (const cgc_string_vector * const vector, size_t i)
 {
-    char ** string = cgc_vector_back (vector);
-    return * string;
+    const cgc_string_vector_entry * const entry = cgc_vector_at (& vector->_entries, i);
+    return entry->_long._id;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -124,60 +619,174 @@ char * cgc_string_vector_back (const cgc_string_vector * const vector)
 
 /* cgc_string_vector_push_front() and cgc_string_vector_push_back():
  * -----------------------------------------------------------------
- * Copy the string, and store the pointer in the vector.
+ * Copy the string into its entry or into the arena, and store the entry in
+ * the vector. The length is computed once, and stored along the string.
  */
 int cgc_string_vector_push_front (cgc_string_vector * const vector, const char * const string)
 {
-    const char * const copy = _cgc_strdup (string);
-    return cgc_vector_push_front (vector, & copy);
+    int error = cgc_check_pointer (string);
+    if (! error)
+        error = cgc_string_vector_push_front_n (vector, string, strlen (string));
+
+    return error;
 }
 
 int cgc_string_vector_push_back (cgc_string_vector * const vector, const char * const string)
 {
-    const char * const copy = _cgc_strdup (string);
-    return cgc_vector_push_back (vector, & copy);
+    int error = cgc_check_pointer (string);
+    if (! error)
+        error = cgc_string_vector_push_back_n (vector, string, strlen (string));
+
+    return error;
 }
 
 int cgc_string_vector_insert (cgc_string_vector * const vector, size_t i, const char * const string)
 {
-    const char * const copy = _cgc_strdup (string);
-    return cgc_vector_insert (vector, i, & copy);
+    int error = cgc_check_pointer (string);
+    if (! error)
+        error = cgc_string_vector_insert_n (vector, i, string, strlen (string));
+
+    return error;
+}
+
+int cgc_string_vector_push_front_n (cgc_string_vector * const vector, const char * const data, size_t length)
+{
+    cgc_string_vector_entry entry;
+    int error = _cgc_string_vector_prepare (vector, data, length, & entry);
+    if (! error)
+        error = cgc_vector_push_front (& vector->_entries, & entry);
+
+    return error;
+}
+
+int cgc_string_vector_push_back_n (cgc_string_vector * const vector, const char * const data, size_t length)
+{
+    cgc_string_vector_entry entry;
+    int error = _cgc_string_vector_prepare (vector, data, length, & entry);
+    if (! error)
+        error = cgc_vector_push_back (& vector->_entries, & entry);
+
+    return error;
+}
+
+int cgc_string_vector_insert_n (cgc_string_vector * const vector, size_t i, const char * const data, size_t length)
+{
+    cgc_string_vector_entry entry;
+    int error = _cgc_string_vector_prepare (vector, data, length, & entry);
+    if (! error)
+        error = cgc_vector_insert (& vector->_entries, i, & entry);
+
+    return error;
 }
 
 /* cgc_string_vector_pop_front() and cgc_string_vector_pop_back():
  * ---------------------------------------------------------------
- * Usually, the user must free the element obtained via a pop operation.
- * Here, the element is a pointer to a string. However, the function directly
- * returns the string: don't forget to free the aforementioned ``element''
- * (the pointer to the string)!
+ * The strings belong to the vector: the popped string is copied into a newly
+ * allocated memory area, which the user must free.
  */
 char * cgc_string_vector_pop_front (cgc_string_vector * const vector)
 {
-
-    char ** front_copy = cgc_vector_pop_front (vector);
-    char * front = * front_copy;
-    free (front_copy);
+    char * front = NULL;
+    if (vector != NULL && ! cgc_string_vector_is_empty (vector))
+    {
+        front = _cgc_string_vector_duplicate (vector, cgc_vector_front (& vector->_entries));
+        if (front != NULL)
+            cgc_vector_erase (& vector->_entries, 0, 1);
+    }
     return front;
 }
 
 char * cgc_string_vector_pop_back (cgc_string_vector * const vector)
 {
-    char ** back_copy = cgc_vector_pop_back (vector);
-    char * back = * back_copy;
-    free (back_copy);
+    char * back = NULL;
+    if (vector != NULL && ! cgc_string_vector_is_empty (vector))
+    {
+        size_t size = cgc_string_vector_size (vector);
+        back = _cgc_string_vector_duplicate (vector, cgc_vector_back (& vector->_entries));
+        if (back != NULL)
+            cgc_vector_erase (& vector->_entries, size - 1, size);
+    }
     return back;
 }
 
 /* cgc_string_vector_clear() and cgc_string_vector_erase():
  * --------------------------------------------------------
- * No special action required, a mere call to the generic version is enough.
+ * Clearing also releases the arena and the mapped file. Erasing only drops
+ * the entries: the characters stay in the arena until the next clear.
  */
 int cgc_string_vector_clear (cgc_string_vector * const vector)
 {
-    return cgc_vector_clear (vector);
+    int error = cgc_check_pointer (vector);
+    if (! error)
+        error = cgc_vector_clear (& vector->_entries);
+    if (! error)
+        error = cgc_string_arena_clear (& vector->_arena);
+    if (! error)
+        _cgc_string_vector_unmap (vector);
+
+    return error;
 }
 
 int cgc_string_vector_erase (cgc_string_vector * const vector, size_t start, size_t end)
 {
-    return cgc_vector_erase (vector, start, end);
+    int error = cgc_check_pointer (vector);
+    if (! error)
+        error = cgc_vector_erase (& vector->_entries, start, end);
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sorting.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_string_vector_sort (cgc_string_vector * const vector)
+{
+    int error = cgc_check_pointer (vector);
+    size_t size = ! error ? cgc_string_vector_size (vector) : 0;
+    _cgc_string_vector_sort_item * items = NULL;
+    if (! error && size > 1)
+    {
+        if (size <= SIZE_MAX / sizeof * items)
+            items = malloc (size * sizeof * items);
+        if (items == NULL)
+            error = -2;
+    }
+
+    if (! error && size > 1)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            const cgc_string_vector_entry * const entry = cgc_vector_at (& vector->_entries, i);
+            items[i]._data = _cgc_string_vector_data (entry);
+            items[i]._length = _cgc_string_vector_length (vector, entry);
+            items[i]._prefix = _cgc_string_vector_prefix (& items[i], 0);
+            items[i]._index = i;
+        }
+        _cgc_string_vector_sort_items (items, size, 0);
+        _cgc_string_vector_permute (vector, items, size);
+        free (items);
+    }
+
+    return error;
+}
+
+int cgc_string_vector_unique (cgc_string_vector * const vector)
+{
+    int error = cgc_check_pointer (vector);
+    size_t size = ! error ? cgc_string_vector_size (vector) : 0;
+    if (size > 1)
+    {
+        size_t last = 0;
+        for (size_t i = 1; i < size; ++i)
+        {
+            cgc_string_vector_entry * const entry = cgc_vector_at (& vector->_entries, i);
+            cgc_string_vector_entry * const kept = cgc_vector_at (& vector->_entries, last);
+            if (! _cgc_string_vector_equal (vector, kept, entry) && ++last != i)
+                memcpy (cgc_vector_at (& vector->_entries, last), entry, sizeof * entry);
+        }
+        error = cgc_vector_erase (& vector->_entries, last + 1, size);
+    }
+
+    return error;
 }
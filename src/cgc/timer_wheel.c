@@ -0,0 +1,494 @@
+/**
+ * \file timer_wheel.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/timer_wheel.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of words of an occupancy bitmap.
+ */
+#define _WORDS (CGC_TIMER_WHEEL_SLOTS / 64)
+
+/**
+ * \brief Mask of a slot index.
+ */
+static const uint64_t _SLOT_MASK = CGC_TIMER_WHEEL_SLOTS - 1;
+
+/**
+ * \brief Returned when no bucket of a level is occupied.
+ */
+static const size_t _NONE = SIZE_MAX;
+
+_Static_assert (CGC_TIMER_WHEEL_LEVELS * CGC_TIMER_WHEEL_SLOT_BITS == 64,
+    "the levels of a timer wheel shall cover 64 bits ticks");
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Number of ticks covered by one bucket of a level.
+ * \param level Level.
+ * \return Shift of the bucket width.
+ */
+static inline unsigned int _cgc_timer_wheel_shift (size_t level)
+{
+    return (unsigned int) (level * CGC_TIMER_WHEEL_SLOT_BITS);
+}
+
+/**
+ * \brief Count the trailing zero bits of a non-zero word.
+ * \param word Word.
+ * \return Index of the lowest set bit.
+ */
+static inline unsigned int _cgc_timer_wheel_lowest_bit (uint64_t word)
+{
+#if defined (__GNUC__)
+    return (unsigned int) __builtin_ctzll (word);
+#else
+    unsigned int index = 0;
+    while (! (word & 1))
+    {
+        word >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * \brief Find the first occupied bucket of a level, circularly.
+ * \param bits Occupancy bitmap of the level.
+ * \param start Slot to start from.
+ * \return Distance from \c start to the first occupied slot, or \c _NONE.
+ */
+static size_t _cgc_timer_wheel_next_occupied (const uint64_t * const bits, size_t start)
+{
+    size_t word = start / 64;
+    unsigned int offset = (unsigned int) (start % 64);
+    uint64_t current = bits[word] & (~UINT64_C (0) << offset);
+    for (size_t i = 0; i <= _WORDS; ++i)
+    {
+        if (current != 0)
+        {
+            size_t slot = ((word + i) % _WORDS) * 64 + _cgc_timer_wheel_lowest_bit (current);
+            return (slot - start) & _SLOT_MASK;
+        }
+
+        size_t next = (word + i + 1) % _WORDS;
+        current = bits[next];
+        if (i + 1 == _WORDS)
+            current &= offset == 0 ? 0 : ~(~UINT64_C (0) << offset);
+    }
+    return _NONE;
+}
+
+/**
+ * \brief Mark a bucket as occupied or empty.
+ * \param wheel A pointer to a CGC Timer wheel.
+ * \param bucket Bucket index.
+ * \param occupied Whether the bucket holds timers.
+ */
+static inline void _cgc_timer_wheel_mark (cgc_timer_wheel * const wheel, size_t bucket, bool occupied)
+{
+    uint64_t * word = & wheel->_occupied[bucket / CGC_TIMER_WHEEL_SLOTS][(bucket % CGC_TIMER_WHEEL_SLOTS) / 64];
+    uint64_t bit = UINT64_C (1) << (bucket % 64);
+    if (occupied)
+        * word |= bit;
+    else
+        * word &= ~bit;
+}
+
+/**
+ * \brief Get the bucket a deadline belongs to.
+ * \param deadline Deadline.
+ * \param reference Tick the wheel stands at.
+ * \return Bucket index.
+ * \pre \c deadline >= \c reference.
+ */
+static size_t _cgc_timer_wheel_bucket (uint64_t deadline, uint64_t reference)
+{
+    uint64_t delta = deadline - reference;
+    size_t level = 0;
+    while (level + 1 < CGC_TIMER_WHEEL_LEVELS && delta >> _cgc_timer_wheel_shift (level + 1) != 0)
+        level++;
+
+    return level * CGC_TIMER_WHEEL_SLOTS + ((deadline >> _cgc_timer_wheel_shift (level)) & _SLOT_MASK);
+}
+
+/**
+ * \brief Link a timer at the end of a bucket.
+ * \param wheel A pointer to a CGC Timer wheel.
+ * \param timer A pointer to the timer.
+ * \param bucket Bucket index.
+ */
+static void _cgc_timer_wheel_link (cgc_timer_wheel * const wheel, cgc_timer_wheel_timer * const timer, size_t bucket)
+{
+    cgc_timer_wheel_link * const sentinel = & wheel->_buckets[bucket];
+    timer->_bucket = bucket;
+    timer->_link._next = sentinel;
+    timer->_link._previous = sentinel->_previous;
+    sentinel->_previous->_next = & timer->_link;
+    sentinel->_previous = & timer->_link;
+    _cgc_timer_wheel_mark (wheel, bucket, true);
+}
+
+/**
+ * \brief Unlink a timer from its bucket.
+ * \param wheel A pointer to a CGC Timer wheel.
+ * \param timer A pointer to the timer.
+ */
+static void _cgc_timer_wheel_unlink (cgc_timer_wheel * const wheel, cgc_timer_wheel_timer * const timer)
+{
+    timer->_link._previous->_next = timer->_link._next;
+    timer->_link._next->_previous = timer->_link._previous;
+    const cgc_timer_wheel_link * const sentinel = & wheel->_buckets[timer->_bucket];
+    if (sentinel->_next == sentinel)
+        _cgc_timer_wheel_mark (wheel, timer->_bucket, false);
+}
+
+/**
+ * \brief Move the timers of a bucket into a local list.
+ * \param wheel A pointer to a CGC Timer wheel.
+ * \param bucket Bucket index.
+ * \param list Sentinel of the local list.
+ */
+static void _cgc_timer_wheel_detach (cgc_timer_wheel * const wheel, size_t bucket, cgc_timer_wheel_link * const list)
+{
+    cgc_timer_wheel_link * const sentinel = & wheel->_buckets[bucket];
+    if (sentinel->_next == sentinel)
+        list->_next = list->_previous = list;
+    else
+    {
+        * list = * sentinel;
+        list->_next->_previous = list;
+        list->_previous->_next = list;
+        sentinel->_next = sentinel->_previous = sentinel;
+    }
+    _cgc_timer_wheel_mark (wheel, bucket, false);
+}
+
+/**
+ * \brief Clean the element of a timer and keep the timer for reuse.
+ * \param wheel A pointer to a CGC Timer wheel.
+ * \param timer A pointer to the timer.
+ */
+static void _cgc_timer_wheel_recycle (cgc_timer_wheel * const wheel, cgc_timer_wheel_timer * const timer)
+{
+    if (wheel->_clean_fun != NULL)
+        wheel->_clean_fun (cgc_timer_wheel_content (wheel, timer));
+    timer->_link._next = (cgc_timer_wheel_link *) wheel->_free;
+    wheel->_free = timer;
+}
+
+/**
+ * \brief Find the next tick at which a bucket is due.
+ * \param wheel A pointer to a CGC Timer wheel.
+ * \return The next tick to process.
+ * \pre The wheel is not empty.
+ */
+static uint64_t _cgc_timer_wheel_next_tick (const cgc_timer_wheel * const wheel)
+{
+    uint64_t next = UINT64_MAX;
+    for (size_t level = 0; level < CGC_TIMER_WHEEL_LEVELS; ++level)
+    {
+        unsigned int shift = _cgc_timer_wheel_shift (level);
+        uint64_t position = (wheel->_now >> shift) + 1;
+        size_t distance = _cgc_timer_wheel_next_occupied (wheel->_occupied[level], position & _SLOT_MASK);
+        if (distance != _NONE)
+        {
+            uint64_t tick = (position + distance) << shift;
+            if (tick < next)
+                next = tick;
+        }
+    }
+    return next;
+}
+
+/**
+ * \brief Process one tick: move the due buckets down and expire the timers.
+ * \param wheel A pointer to a CGC Timer wheel.
+ * \param tick Tick.
+ * \param op_fun Function called on the expired elements.
+ * \return Number of expired timers.
+ */
+static size_t _cgc_timer_wheel_tick (cgc_timer_wheel * const wheel, uint64_t tick, cgc_unary_op_function op_fun)
+{
+    cgc_timer_wheel_link list;
+    wheel->_now = tick;
+
+    for (size_t level = CGC_TIMER_WHEEL_LEVELS - 1; level > 0; --level)
+    {
+        unsigned int shift = _cgc_timer_wheel_shift (level);
+        if ((tick & ((UINT64_C (1) << shift) - 1)) != 0)
+            continue;
+
+        _cgc_timer_wheel_detach (wheel, level * CGC_TIMER_WHEEL_SLOTS + ((tick >> shift) & _SLOT_MASK), & list);
+        while (list._next != & list)
+        {
+            cgc_timer_wheel_timer * const timer = (cgc_timer_wheel_timer *) list._next;
+            list._next = timer->_link._next;
+            _cgc_timer_wheel_link (wheel, timer, _cgc_timer_wheel_bucket (timer->_deadline, tick));
+        }
+    }
+
+    size_t expired = 0;
+    _cgc_timer_wheel_detach (wheel, tick & _SLOT_MASK, & list);
+    while (list._next != & list)
+    {
+        /* Unlink the timer from the local list first: op_fun may cancel the
+           timers which follow it. */
+        cgc_timer_wheel_timer * const timer = (cgc_timer_wheel_timer *) list._next;
+        list._next = timer->_link._next;
+        list._next->_previous = & list;
+        wheel->_size--;
+        expired++;
+
+        if (op_fun != NULL)
+            op_fun (cgc_timer_wheel_content (wheel, timer));
+        _cgc_timer_wheel_recycle (wheel, timer);
+    }
+
+    return expired;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_timer_wheel * cgc_timer_wheel_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, uint64_t now)
+{
+    cgc_timer_wheel * wheel = malloc (sizeof * wheel);
+    if (wheel != NULL)
+        cgc_timer_wheel_init (wheel, element_size, copy_fun, clean_fun, now);
+
+    return wheel;
+}
+
+void cgc_timer_wheel_destroy (cgc_timer_wheel * wheel)
+{
+    if (wheel != NULL)
+    {
+        cgc_timer_wheel_clean (wheel);
+        free (wheel);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_timer_wheel_init (cgc_timer_wheel * wheel, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun, uint64_t now)
+{
+    int error = cgc_check_pointer (wheel);
+    if (! error)
+    {
+        for (size_t bucket = 0; bucket < CGC_TIMER_WHEEL_LEVELS * CGC_TIMER_WHEEL_SLOTS; ++bucket)
+            wheel->_buckets[bucket]._next = wheel->_buckets[bucket]._previous = & wheel->_buckets[bucket];
+        memset (wheel->_occupied, 0, sizeof wheel->_occupied);
+        wheel->_free = NULL;
+        wheel->_now = now;
+        wheel->_size = 0;
+        wheel->_element_size = element_size;
+        wheel->_content_offset = (sizeof (cgc_timer_wheel_timer) + _Alignof (max_align_t) - 1)
+            / _Alignof (max_align_t) * _Alignof (max_align_t);
+        wheel->_copy_fun = copy_fun;
+        wheel->_clean_fun = clean_fun;
+    }
+
+    return error;
+}
+
+int cgc_timer_wheel_clean (cgc_timer_wheel * wheel)
+{
+    int error = cgc_timer_wheel_clear (wheel);
+    if (! error)
+    {
+        while (wheel->_free != NULL)
+        {
+            cgc_timer_wheel_timer * const timer = wheel->_free;
+            wheel->_free = (cgc_timer_wheel_timer *) timer->_link._next;
+            free (timer);
+        }
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_timer_wheel_is_empty (const cgc_timer_wheel * wheel)
+{
+    return wheel->_size == 0;
+}
+
+size_t cgc_timer_wheel_size (const cgc_timer_wheel * wheel)
+{
+    return wheel->_size;
+}
+
+uint64_t cgc_timer_wheel_now (const cgc_timer_wheel * wheel)
+{
+    return wheel->_now;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Timers.
+////////////////////////////////////////////////////////////////////////////////
+
+void * cgc_timer_wheel_content (const cgc_timer_wheel * wheel, cgc_timer_wheel_timer * timer)
+{
+    return (char *) timer + wheel->_content_offset;
+}
+
+uint64_t cgc_timer_wheel_deadline (const cgc_timer_wheel_timer * timer)
+{
+    return timer->_deadline;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_timer_wheel_schedule (cgc_timer_wheel * wheel, uint64_t deadline, const void * element, cgc_timer_wheel_timer ** timer)
+{
+    int error = cgc_check_pointer (wheel);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    cgc_timer_wheel_timer * new_timer = NULL;
+    if (! error)
+    {
+        new_timer = wheel->_free;
+        if (new_timer != NULL)
+            wheel->_free = (cgc_timer_wheel_timer *) new_timer->_link._next;
+        else if (wheel->_element_size <= SIZE_MAX - wheel->_content_offset)
+            new_timer = malloc (wheel->_content_offset + wheel->_element_size);
+
+        if (new_timer == NULL)
+            error = -2;
+    }
+
+    if (! error)
+    {
+        void * const content = cgc_timer_wheel_content (wheel, new_timer);
+        if (wheel->_copy_fun != NULL)
+            error = wheel->_copy_fun (element, content);
+        else
+            memcpy (content, element, wheel->_element_size);
+
+        if (error)
+        {
+            new_timer->_link._next = (cgc_timer_wheel_link *) wheel->_free;
+            wheel->_free = new_timer;
+        }
+    }
+
+    if (! error)
+    {
+        new_timer->_deadline = deadline > wheel->_now ? deadline : wheel->_now + 1;
+        _cgc_timer_wheel_link (wheel, new_timer, _cgc_timer_wheel_bucket (new_timer->_deadline, wheel->_now));
+        wheel->_size++;
+        if (timer != NULL)
+            * timer = new_timer;
+    }
+
+    return error;
+}
+
+int cgc_timer_wheel_reschedule (cgc_timer_wheel * wheel, cgc_timer_wheel_timer * timer, uint64_t deadline)
+{
+    int error = cgc_check_pointer (wheel);
+    if (! error)
+        error = cgc_check_pointer (timer);
+
+    if (! error)
+    {
+        _cgc_timer_wheel_unlink (wheel, timer);
+        timer->_deadline = deadline > wheel->_now ? deadline : wheel->_now + 1;
+        _cgc_timer_wheel_link (wheel, timer, _cgc_timer_wheel_bucket (timer->_deadline, wheel->_now));
+    }
+
+    return error;
+}
+
+int cgc_timer_wheel_cancel (cgc_timer_wheel * wheel, cgc_timer_wheel_timer * timer)
+{
+    int error = cgc_check_pointer (wheel);
+    if (! error)
+        error = cgc_check_pointer (timer);
+
+    if (! error)
+    {
+        _cgc_timer_wheel_unlink (wheel, timer);
+        wheel->_size--;
+        _cgc_timer_wheel_recycle (wheel, timer);
+    }
+
+    return error;
+}
+
+size_t cgc_timer_wheel_advance (cgc_timer_wheel * wheel, uint64_t now, cgc_unary_op_function op_fun)
+{
+    size_t expired = 0;
+    if (wheel != NULL)
+    {
+        while (wheel->_now < now)
+        {
+            uint64_t next = wheel->_size > 0 ? _cgc_timer_wheel_next_tick (wheel) : UINT64_MAX;
+            if (next > now)
+                wheel->_now = now;
+            else
+                expired += _cgc_timer_wheel_tick (wheel, next, op_fun);
+        }
+    }
+
+    return expired;
+}
+
+int cgc_timer_wheel_clear (cgc_timer_wheel * wheel)
+{
+    int error = cgc_check_pointer (wheel);
+    if (! error)
+    {
+        cgc_timer_wheel_link list;
+        for (size_t bucket = 0; bucket < CGC_TIMER_WHEEL_LEVELS * CGC_TIMER_WHEEL_SLOTS; ++bucket)
+        {
+            _cgc_timer_wheel_detach (wheel, bucket, & list);
+            while (list._next != & list)
+            {
+                cgc_timer_wheel_timer * const timer = (cgc_timer_wheel_timer *) list._next;
+                list._next = timer->_link._next;
+                _cgc_timer_wheel_recycle (wheel, timer);
+            }
+        }
+        wheel->_size = 0;
+    }
+
+    return error;
+}
@@ -0,0 +1,602 @@
+/**
+ * \file unrolled_list.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/unrolled_list.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Targetted size in bytes of the elements of a node (4 cache lines).
+ */
+static const size_t _NODE_CONTENT_SIZE = 256;
+
+/**
+ * \brief Minimal number of elements per node.
+ */
+static const size_t _NODE_MIN_CAPACITY = 4;
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Actually initialize a list.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param element_size The size in bytes of the elements.
+ * \param copy_fun The copy function.
+ * \param clean_fun The cleaning function.
+ * \pre list != NULL
+ */
+static inline void _cgc_unrolled_list_actual_init (cgc_unrolled_list * const list, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
+{
+    size_t capacity = element_size != 0 ? _NODE_CONTENT_SIZE / element_size : _NODE_CONTENT_SIZE;
+
+    list->_first = NULL;
+    list->_last = NULL;
+    list->_clean_fun = clean_fun;
+    list->_copy_fun = copy_fun;
+    list->_size = 0;
+    list->_element_size = element_size;
+    list->_node_capacity = capacity > _NODE_MIN_CAPACITY ? capacity : _NODE_MIN_CAPACITY;
+}
+
+/**
+ * \brief Get the address of the element at index \c i inside a node.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param node A pointer to a node.
+ * \param i Index of the element inside the node.
+ * \return A pointer to the element.
+ */
+static inline void * _cgc_unrolled_list_address (const cgc_unrolled_list * const list, cgc_unrolled_list_node * const node, size_t i)
+{
+    return node->_content + i * list->_element_size;
+}
+
+/**
+ * \brief Allocate a node and link it after \c previous.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param previous The predecessor of the new node, \c NULL to make the new
+ * node the first one.
+ * \return A pointer to the new node.
+ * \retval \c NULL in case of failure.
+ * \note In case of failure, \c errno may be set to \c ENOMEM.
+ */
+static cgc_unrolled_list_node * _cgc_unrolled_list_node_link_after (cgc_unrolled_list * const list, cgc_unrolled_list_node * const previous)
+{
+    cgc_unrolled_list_node * const node = malloc (sizeof * node + list->_node_capacity * list->_element_size);
+    if (node != NULL)
+    {
+        node->_count = 0;
+        node->_previous = previous;
+        node->_next = previous != NULL ? previous->_next : list->_first;
+
+        if (node->_next != NULL)
+            node->_next->_previous = node;
+        else
+            list->_last = node;
+
+        if (previous != NULL)
+            previous->_next = node;
+        else
+            list->_first = node;
+    }
+
+    return node;
+}
+
+/**
+ * \brief Unlink and free a node.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param node The node.
+ * \return A pointer to the successor of the node.
+ * \note The elements of the node are not cleaned.
+ */
+static cgc_unrolled_list_node * _cgc_unrolled_list_node_unlink (cgc_unrolled_list * const list, cgc_unrolled_list_node * const node)
+{
+    cgc_unrolled_list_node * const next = node->_next;
+
+    if (node->_previous != NULL)
+        node->_previous->_next = next;
+    else
+        list->_first = next;
+
+    if (next != NULL)
+        next->_previous = node->_previous;
+    else
+        list->_last = node->_previous;
+
+    free (node);
+    return next;
+}
+
+/**
+ * \brief Find the node holding the element at index \c i.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param i Target index.
+ * \param offset Index of the element inside the returned node.
+ * \return A pointer to the node.
+ * \pre i < list->_size
+ * The walk starts from whichever end of the list is the closest.
+ */
+static cgc_unrolled_list_node * _cgc_unrolled_list_node_at (const cgc_unrolled_list * const list, size_t i, size_t * const offset)
+{
+    cgc_unrolled_list_node * node;
+    if (i < list->_size / 2)
+    {
+        for (node = list->_first; i >= node->_count; node = node->_next)
+            i -= node->_count;
+    }
+    else
+    {
+        size_t remaining = list->_size - i;
+        for (node = list->_last; remaining > node->_count; node = node->_previous)
+            remaining -= node->_count;
+        i = node->_count - remaining;
+    }
+
+    * offset = i;
+    return node;
+}
+
+/**
+ * \brief Copy an element into a node.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param node A pointer to a node which is not full.
+ * \param i Index of the element inside the node.
+ * \param element A pointer to the element.
+ * \retval 0 in case of success.
+ * \retval <= -3 in case of failure of the copy function.
+ * \pre node->_count < list->_node_capacity
+ * \pre i <= node->_count
+ */
+static int _cgc_unrolled_list_node_insert (cgc_unrolled_list * const list, cgc_unrolled_list_node * const node, size_t i, const void * const element)
+{
+    int error = 0;
+    void * const target = _cgc_unrolled_list_address (list, node, i);
+    memmove ((char *) target + list->_element_size, target, (node->_count - i) * list->_element_size);
+
+    if (list->_copy_fun != NULL)
+        error = list->_copy_fun (element, target);
+    else
+        memcpy (target, element, list->_element_size);
+
+    if (! error)
+    {
+        node->_count++;
+        list->_size++;
+    }
+    else
+        memmove (target, (char *) target + list->_element_size, (node->_count - i) * list->_element_size);
+
+    return error;
+}
+
+/**
+ * \brief Remove elements from a node.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param node A pointer to a node.
+ * \param i Index of the first element to remove.
+ * \param count Number of elements to remove.
+ * \param clean Whether the elements must be cleaned.
+ * \pre i + count <= node->_count
+ */
+static void _cgc_unrolled_list_node_remove (cgc_unrolled_list * const list, cgc_unrolled_list_node * const node, size_t i, size_t count, bool clean)
+{
+    if (clean && list->_clean_fun != NULL)
+        for (size_t j = i; j < i + count; ++j)
+            list->_clean_fun (_cgc_unrolled_list_address (list, node, j));
+
+    memmove (_cgc_unrolled_list_address (list, node, i), _cgc_unrolled_list_address (list, node, i + count), (node->_count - i - count) * list->_element_size);
+    node->_count -= count;
+    list->_size -= count;
+}
+
+/**
+ * \brief Split a full node in two halves.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param node A pointer to a node.
+ * \retval 0 in case of success.
+ * \retval -2 in case of failure because of malloc.
+ */
+static int _cgc_unrolled_list_node_split (cgc_unrolled_list * const list, cgc_unrolled_list_node * const node)
+{
+    int error = 0;
+    cgc_unrolled_list_node * const new_node = _cgc_unrolled_list_node_link_after (list, node);
+    if (new_node != NULL)
+    {
+        size_t kept = node->_count / 2;
+        new_node->_count = node->_count - kept;
+        memcpy (new_node->_content, _cgc_unrolled_list_address (list, node, kept), new_node->_count * list->_element_size);
+        node->_count = kept;
+    }
+    else
+        error = -2;
+
+    return error;
+}
+
+/**
+ * \brief Merge a node with its successor when they fit in a single node.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param node A pointer to a node.
+ * \return A pointer to the node following the merged nodes.
+ */
+static cgc_unrolled_list_node * _cgc_unrolled_list_node_merge (cgc_unrolled_list * const list, cgc_unrolled_list_node * const node)
+{
+    cgc_unrolled_list_node * next = node->_next;
+    if (node->_count < list->_node_capacity / 2 && next != NULL && node->_count + next->_count <= list->_node_capacity)
+    {
+        memcpy (_cgc_unrolled_list_address (list, node, node->_count), next->_content, next->_count * list->_element_size);
+        node->_count += next->_count;
+        next = _cgc_unrolled_list_node_unlink (list, next);
+    }
+
+    return next;
+}
+
+/**
+ * \brief Copy an element into a newly allocated memory area.
+ * \param list A pointer to a CGC Unrolled list.
+ * \param element A pointer to the element.
+ * \return A pointer to the copy.
+ * \retval \c NULL in case of failure.
+ */
+static inline void * _cgc_unrolled_list_element_dup (const cgc_unrolled_list * const list, const void * const element)
+{
+    void * const copy = malloc (list->_element_size);
+    if (copy != NULL)
+        memcpy (copy, element, list->_element_size);
+
+    return copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_unrolled_list * cgc_unrolled_list_create (size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
+{
+    cgc_unrolled_list * list = malloc (sizeof * list);
+    if (list != NULL)
+        cgc_unrolled_list_init (list, element_size, copy_fun, clean_fun);
+
+    return list;
+}
+
+void cgc_unrolled_list_destroy (cgc_unrolled_list * const list)
+{
+    if (list != NULL)
+    {
+        cgc_unrolled_list_clear (list);
+        free (list);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_unrolled_list_init (cgc_unrolled_list * const list, size_t element_size, cgc_copy_function copy_fun, cgc_clean_function clean_fun)
+{
+    int error = cgc_check_pointer (list);
+
+    if (! error)
+        _cgc_unrolled_list_actual_init (list, element_size, copy_fun, clean_fun);
+
+    return error;
+}
+
+int cgc_unrolled_list_clean (cgc_unrolled_list * const list)
+{
+    return cgc_unrolled_list_clear (list);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_unrolled_list * cgc_unrolled_list_copy (const cgc_unrolled_list * const list)
+{
+    cgc_unrolled_list * copy = NULL;
+    if (list != NULL)
+    {
+        copy = cgc_unrolled_list_create (list->_element_size, list->_copy_fun, list->_clean_fun);
+        if (copy != NULL)
+            cgc_unrolled_list_copy_into (list, copy);
+    }
+
+    return copy;
+}
+
+int cgc_unrolled_list_copy_into (const cgc_unrolled_list * const original, cgc_unrolled_list * const destination)
+{
+    int error = cgc_check_pointer (original);
+    if (! error)
+        error = cgc_check_pointer (destination);
+
+    if (! error)
+        error = cgc_unrolled_list_init (destination, original->_element_size, original->_copy_fun, original->_clean_fun);
+
+    for (cgc_unrolled_list_node * node = original->_first; ! error && node != NULL; node = node->_next)
+        for (size_t i = 0; ! error && i < node->_count; ++i)
+            error = cgc_unrolled_list_push_back (destination, _cgc_unrolled_list_address (original, node, i));
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Swap.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_unrolled_list_swap (cgc_unrolled_list * const a, cgc_unrolled_list * const b)
+{
+    int error = cgc_check_pointer (a);
+    if (! error)
+        error = cgc_check_pointer (b);
+
+    if (! error)
+    {
+        cgc_unrolled_list tmp = * a;
+        * a = * b;
+        * b = tmp;
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+bool cgc_unrolled_list_is_empty (const cgc_unrolled_list * const list)
+{
+    return list->_size == 0;
+}
+
+size_t cgc_unrolled_list_size (const cgc_unrolled_list * const list)
+{
+    return list->_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Access.
+////////////////////////////////////////////////////////////////////////////////
+
+void * cgc_unrolled_list_at (const cgc_unrolled_list * const list, size_t i)
+{
+    void * element = NULL;
+    if (i < list->_size)
+    {
+        size_t offset;
+        cgc_unrolled_list_node * const node = _cgc_unrolled_list_node_at (list, i, & offset);
+        element = _cgc_unrolled_list_address (list, node, offset);
+    }
+
+    return element;
+}
+
+void * cgc_unrolled_list_front (const cgc_unrolled_list * const list)
+{
+    return _cgc_unrolled_list_address (list, list->_first, 0);
+}
+
+void * cgc_unrolled_list_back (const cgc_unrolled_list * const list)
+{
+    return _cgc_unrolled_list_address (list, list->_last, list->_last->_count - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_unrolled_list_push_front (cgc_unrolled_list * const list, const void * const element)
+{
+    int error = cgc_check_pointer (list);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    bool new_node = false;
+    if (! error && (list->_first == NULL || list->_first->_count == list->_node_capacity))
+    {
+        new_node = true;
+        error = _cgc_unrolled_list_node_link_after (list, NULL) != NULL ? 0 : -2;
+    }
+
+    if (! error)
+    {
+        error = _cgc_unrolled_list_node_insert (list, list->_first, 0, element);
+        /* Do not leave an empty node behind if the copy failed. */
+        if (error && new_node)
+            _cgc_unrolled_list_node_unlink (list, list->_first);
+    }
+
+    return error;
+}
+
+int cgc_unrolled_list_push_back (cgc_unrolled_list * const list, const void * const element)
+{
+    int error = cgc_check_pointer (list);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    bool new_node = false;
+    if (! error && (list->_last == NULL || list->_last->_count == list->_node_capacity))
+    {
+        new_node = true;
+        error = _cgc_unrolled_list_node_link_after (list, list->_last) != NULL ? 0 : -2;
+    }
+
+    if (! error)
+    {
+        error = _cgc_unrolled_list_node_insert (list, list->_last, list->_last->_count, element);
+        /* Do not leave an empty node behind if the copy failed. */
+        if (error && new_node)
+            _cgc_unrolled_list_node_unlink (list, list->_last);
+    }
+
+    return error;
+}
+
+void * cgc_unrolled_list_pop_front (cgc_unrolled_list * const list)
+{
+    cgc_unrolled_list_node * const node = list->_first;
+    void * const element = _cgc_unrolled_list_element_dup (list, _cgc_unrolled_list_address (list, node, 0));
+    if (element != NULL)
+    {
+        _cgc_unrolled_list_node_remove (list, node, 0, 1, false);
+        if (node->_count == 0)
+            _cgc_unrolled_list_node_unlink (list, node);
+    }
+
+    return element;
+}
+
+void * cgc_unrolled_list_pop_back (cgc_unrolled_list * const list)
+{
+    cgc_unrolled_list_node * const node = list->_last;
+    void * const element = _cgc_unrolled_list_element_dup (list, _cgc_unrolled_list_address (list, node, node->_count - 1));
+    if (element != NULL)
+    {
+        _cgc_unrolled_list_node_remove (list, node, node->_count - 1, 1, false);
+        if (node->_count == 0)
+            _cgc_unrolled_list_node_unlink (list, node);
+    }
+
+    return element;
+}
+
+int cgc_unrolled_list_insert (cgc_unrolled_list * const list, size_t i, const void * const element)
+{
+    int error = 0;
+    if (i == 0 || cgc_unrolled_list_is_empty (list))
+        error = cgc_unrolled_list_push_front (list, element);
+    else if (i >= cgc_unrolled_list_size (list))
+        error = cgc_unrolled_list_push_back (list, element);
+    else
+    {
+        error = cgc_check_pointer (element);
+
+        size_t offset = 0;
+        cgc_unrolled_list_node * node = NULL;
+        if (! error)
+        {
+            node = _cgc_unrolled_list_node_at (list, i, & offset);
+            if (node->_count == list->_node_capacity)
+            {
+                error = _cgc_unrolled_list_node_split (list, node);
+                if (! error && offset > node->_count)
+                {
+                    offset -= node->_count;
+                    node = node->_next;
+                }
+            }
+        }
+
+        if (! error)
+            error = _cgc_unrolled_list_node_insert (list, node, offset, element);
+    }
+
+    return error;
+}
+
+int cgc_unrolled_list_clear (cgc_unrolled_list * const list)
+{
+    int error = cgc_check_pointer (list);
+
+    if (! error)
+    {
+        cgc_unrolled_list_node * node = list->_first;
+        while (node != NULL)
+        {
+            _cgc_unrolled_list_node_remove (list, node, 0, node->_count, true);
+            node = _cgc_unrolled_list_node_unlink (list, node);
+        }
+    }
+
+    return error;
+}
+
+int cgc_unrolled_list_erase (cgc_unrolled_list * const list, size_t start, size_t end)
+{
+    int error = cgc_check_pointer (list);
+    if (! error && (start >= end || start > list->_size))
+    {
+        error = -1;
+        errno = EINVAL;
+    }
+
+    if (! error && start < list->_size)
+    {
+        size_t remaining = (end > list->_size ? list->_size : end) - start;
+        size_t offset;
+        cgc_unrolled_list_node * node = _cgc_unrolled_list_node_at (list, start, & offset);
+        cgc_unrolled_list_node * const before = node->_previous;
+
+        while (remaining > 0)
+        {
+            size_t count = node->_count - offset < remaining ? node->_count - offset : remaining;
+            _cgc_unrolled_list_node_remove (list, node, offset, count, true);
+            remaining -= count;
+            offset = 0;
+
+            if (node->_count == 0)
+                node = _cgc_unrolled_list_node_unlink (list, node);
+            else if (remaining > 0)
+                node = node->_next;
+        }
+
+        /* Only the nodes around the erased range may have become sparse. */
+        node = before != NULL ? before : list->_first;
+        for (int j = 0; j < 2 && node != NULL; ++j)
+            node = _cgc_unrolled_list_node_merge (list, node);
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions on lists.
+////////////////////////////////////////////////////////////////////////////////
+
+void cgc_unrolled_list_map (cgc_unrolled_list * const list, cgc_unary_op_function op_fun)
+{
+    for (cgc_unrolled_list_node * node = list->_first; node != NULL; node = node->_next)
+        for (size_t i = 0; i < node->_count; ++i)
+            op_fun (_cgc_unrolled_list_address (list, node, i));
+}
+
+void cgc_unrolled_list_fold_left (const cgc_unrolled_list * const list, cgc_binary_op_left_function op_fun, void * const base_result)
+{
+    for (cgc_unrolled_list_node * node = list->_first; node != NULL; node = node->_next)
+        for (size_t i = 0; i < node->_count; ++i)
+            op_fun (base_result, _cgc_unrolled_list_address (list, node, i));
+}
+
+void cgc_unrolled_list_fold_right (const cgc_unrolled_list * const list, cgc_binary_op_right_function op_fun, void * const base_result)
+{
+    for (cgc_unrolled_list_node * node = list->_last; node != NULL; node = node->_previous)
+        for (size_t i = node->_count; i > 0; --i)
+            op_fun (_cgc_unrolled_list_address (list, node, i - 1), base_result);
+}
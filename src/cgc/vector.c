@@ -53,18 +53,22 @@ static inline void * _cgc_vector_address (const cgc_vector * const vector, size_
  * \brief Resize a vector.
  * \pparam vector A pointer to a CGC vector.
  * \param new_size The new size of the vector.
- * \retval 0.
+ * \retval 0 in case of success.
+ * \retval -2 if \c realloc failed. The vector is left untouched.
  * \pre vetor != NULL.
  */
 static inline int _cgc_vector_grow (cgc_vector * const vector, size_t new_size)
 {
+    int error = 0;
     void * new_content = realloc (vector->_content, new_size * vector->_element_size);
     if (new_content != NULL)
     {
         vector->_content = new_content;
         vector->_max_size = new_size;
     }
-    return 0;
+    else
+        error = -2;
+    return error;
 }
 
 /**
@@ -252,6 +256,13 @@ size_t cgc_vector_max_size (const cgc_vector * const vector)
     return vector->_max_size;
 }
 
+bool cgc_vector_is_compatible (const cgc_vector * const a, const cgc_vector * const b)
+{
+    return a->_element_size == b->_element_size
+        && a->_copy_fun == b->_copy_fun
+        && a->_clean_fun == b->_clean_fun;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Access.
 ////////////////////////////////////////////////////////////////////////////////
@@ -397,3 +408,19 @@ int cgc_vector_erase (cgc_vector * const vector, size_t start, size_t end)
 
     return error;
 }
+
+int cgc_vector_reserve (cgc_vector * const vector, size_t max_size)
+{
+    int error = cgc_check_pointer (vector);
+    if (! error && max_size > vector->_max_size)
+    {
+        if (vector->_element_size != 0 && max_size > SIZE_MAX / vector->_element_size)
+        {
+            error = -2;
+            errno = ENOMEM;
+        }
+        else
+            error = _cgc_vector_grow (vector, max_size);
+    }
+    return error;
+}
@@ -0,0 +1,254 @@
+/**
+ * \file work_deque.c
+ * \author RAZANAJATO RANAIVOARIVONY Harenome
+ * \date 2014
+ * \copyright LGPLv3
+ */
+/* Copyright © 2014 RAZANAJATO RANAIVOARIVONY Harenome.
+ * All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * and the GNU General Public License along with this program.
+ * If not, see http://www.gnu.org/licenses/.
+ */
+#include "cgc/work_deque.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Static utilities.
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Allocate a buffer.
+ * \param capacity Number of slots. Must be a power of two.
+ * \return A pointer to the buffer.
+ * \retval NULL in case of failure.
+ */
+static cgc_work_deque_buffer * _cgc_work_deque_buffer_alloc (size_t capacity)
+{
+    cgc_work_deque_buffer * buffer = NULL;
+    if (capacity <= (SIZE_MAX - sizeof * buffer) / sizeof buffer->_slots[0])
+        buffer = malloc (sizeof * buffer + capacity * sizeof buffer->_slots[0]);
+
+    if (buffer != NULL)
+    {
+        buffer->_previous = NULL;
+        buffer->_capacity = capacity;
+    }
+
+    return buffer;
+}
+
+/**
+ * \brief Get a slot of a buffer.
+ * \param buffer A pointer to a buffer.
+ * \param i Index, not yet reduced modulo the capacity.
+ * \return A pointer to the slot.
+ */
+static inline _Atomic (void *) * _cgc_work_deque_slot (cgc_work_deque_buffer * const buffer, int_least64_t i)
+{
+    return & buffer->_slots[(size_t) i & (buffer->_capacity - 1)];
+}
+
+/**
+ * \brief Replace the buffer of a deque by a buffer twice larger.
+ * \param deque A pointer to a CGC Work deque.
+ * \param buffer The current buffer.
+ * \param top Index of the oldest element.
+ * \param bottom Index after the newest element.
+ * \return A pointer to the new buffer.
+ * \retval NULL in case of failure.
+ */
+static cgc_work_deque_buffer * _cgc_work_deque_grow (cgc_work_deque * const deque, cgc_work_deque_buffer * const buffer, int_least64_t top, int_least64_t bottom)
+{
+    cgc_work_deque_buffer * bigger = NULL;
+    if (buffer->_capacity <= SIZE_MAX / 2)
+        bigger = _cgc_work_deque_buffer_alloc (buffer->_capacity * 2);
+
+    if (bigger != NULL)
+    {
+        for (int_least64_t i = top; i < bottom; ++i)
+        {
+            void * element = atomic_load_explicit (_cgc_work_deque_slot (buffer, i), memory_order_relaxed);
+            atomic_store_explicit (_cgc_work_deque_slot (bigger, i), element, memory_order_relaxed);
+        }
+        bigger->_previous = buffer;
+        atomic_store_explicit (& deque->_buffer, bigger, memory_order_release);
+    }
+
+    return bigger;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamic creation and destruction.
+////////////////////////////////////////////////////////////////////////////////
+
+cgc_work_deque * cgc_work_deque_create (size_t capacity)
+{
+    cgc_work_deque * deque = aligned_alloc (_Alignof (cgc_work_deque), sizeof * deque);
+    if (deque != NULL && cgc_work_deque_init (deque, capacity) != 0)
+    {
+        free (deque);
+        deque = NULL;
+    }
+
+    return deque;
+}
+
+void cgc_work_deque_destroy (cgc_work_deque * deque)
+{
+    if (deque != NULL)
+    {
+        cgc_work_deque_clean (deque);
+        free (deque);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization and cleaning.
+////////////////////////////////////////////////////////////////////////////////
+
+int cgc_work_deque_init (cgc_work_deque * deque, size_t capacity)
+{
+    int error = cgc_check_pointer (deque);
+
+    size_t power = 1;
+    while (power < capacity && power <= SIZE_MAX / 2)
+        power *= 2;
+
+    cgc_work_deque_buffer * buffer = NULL;
+    if (! error)
+    {
+        buffer = _cgc_work_deque_buffer_alloc (power);
+        if (buffer == NULL)
+            error = -2;
+    }
+
+    if (! error)
+    {
+        atomic_init (& deque->_top, 0);
+        atomic_init (& deque->_bottom, 0);
+        atomic_init (& deque->_buffer, buffer);
+    }
+
+    return error;
+}
+
+int cgc_work_deque_clean (cgc_work_deque * deque)
+{
+    int error = cgc_check_pointer (deque);
+
+    if (! error)
+    {
+        cgc_work_deque_buffer * buffer = atomic_load_explicit (& deque->_buffer, memory_order_relaxed);
+        while (buffer != NULL)
+        {
+            cgc_work_deque_buffer * previous = buffer->_previous;
+            free (buffer);
+            buffer = previous;
+        }
+        atomic_store_explicit (& deque->_buffer, NULL, memory_order_relaxed);
+    }
+
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Properties getters.
+////////////////////////////////////////////////////////////////////////////////
+
+size_t cgc_work_deque_size (const cgc_work_deque * deque)
+{
+    int_least64_t top = atomic_load_explicit (& deque->_top, memory_order_acquire);
+    int_least64_t bottom = atomic_load_explicit (& deque->_bottom, memory_order_acquire);
+    return bottom > top ? (size_t) (bottom - top) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Modifiers.
+////////////////////////////////////////////////////////////////////////////////
+
+/* The orderings follow "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" (Lê, Pop, Cohen, Zappa Nardelli, 2013), except that push publishes
+ * the bottom with a release store rather than a release fence. */
+
+int cgc_work_deque_push (cgc_work_deque * deque, void * element)
+{
+    int error = cgc_check_pointer (deque);
+    if (! error)
+        error = cgc_check_pointer (element);
+
+    if (! error)
+    {
+        int_least64_t bottom = atomic_load_explicit (& deque->_bottom, memory_order_relaxed);
+        int_least64_t top = atomic_load_explicit (& deque->_top, memory_order_acquire);
+        cgc_work_deque_buffer * buffer = atomic_load_explicit (& deque->_buffer, memory_order_relaxed);
+        if ((size_t) (bottom - top) >= buffer->_capacity)
+        {
+            buffer = _cgc_work_deque_grow (deque, buffer, top, bottom);
+            if (buffer == NULL)
+                error = -2;
+        }
+
+        if (! error)
+        {
+            atomic_store_explicit (_cgc_work_deque_slot (buffer, bottom), element, memory_order_relaxed);
+            atomic_store_explicit (& deque->_bottom, bottom + 1, memory_order_release);
+        }
+    }
+
+    return error;
+}
+
+void * cgc_work_deque_pop (cgc_work_deque * deque)
+{
+    int_least64_t bottom = atomic_load_explicit (& deque->_bottom, memory_order_relaxed) - 1;
+    cgc_work_deque_buffer * buffer = atomic_load_explicit (& deque->_buffer, memory_order_relaxed);
+    atomic_store_explicit (& deque->_bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence (memory_order_seq_cst);
+    int_least64_t top = atomic_load_explicit (& deque->_top, memory_order_relaxed);
+
+    void * element = NULL;
+    if (top <= bottom)
+    {
+        element = atomic_load_explicit (_cgc_work_deque_slot (buffer, bottom), memory_order_relaxed);
+        if (top == bottom)
+        {
+            /* Last element: race against the thieves. */
+            if (! atomic_compare_exchange_strong_explicit (& deque->_top, & top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+                element = NULL;
+            atomic_store_explicit (& deque->_bottom, bottom + 1, memory_order_relaxed);
+        }
+    }
+    else
+        atomic_store_explicit (& deque->_bottom, bottom + 1, memory_order_relaxed);
+
+    return element;
+}
+
+void * cgc_work_deque_steal (cgc_work_deque * deque)
+{
+    int_least64_t top = atomic_load_explicit (& deque->_top, memory_order_acquire);
+    atomic_thread_fence (memory_order_seq_cst);
+    int_least64_t bottom = atomic_load_explicit (& deque->_bottom, memory_order_acquire);
+
+    void * element = NULL;
+    if (top < bottom)
+    {
+        cgc_work_deque_buffer * buffer = atomic_load_explicit (& deque->_buffer, memory_order_acquire);
+        element = atomic_load_explicit (_cgc_work_deque_slot (buffer, top), memory_order_relaxed);
+        if (! atomic_compare_exchange_strong_explicit (& deque->_top, & top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+            element = NULL;
+    }
+
+    return element;
+}
@@ -0,0 +1,125 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <cgc/concurrent_stack.h>
+#include <cgc/stack.h>
+
+#define OPERATIONS 200000
+#define CAPACITY 4096
+#define MAGAZINE_CAPACITY 32
+
+typedef enum bench_mode { SHARED, MAGAZINE, LOCKED } bench_mode;
+
+typedef struct bench_context
+{
+    cgc_concurrent_stack concurrent;
+    pthread_mutex_t mutex;
+    cgc_stack locked;
+    bench_mode mode;
+    size_t per_thread;
+    _Atomic unsigned long long pushed;
+    _Atomic unsigned long long popped;
+} bench_context;
+
+/* Each thread pushes a value then pops one, as with a shared free list. */
+static void * work (void * arg)
+{
+    bench_context * context = arg;
+    cgc_concurrent_stack_magazine magazine;
+    cgc_concurrent_stack_magazine_init (& magazine, & context->concurrent, MAGAZINE_CAPACITY);
+    unsigned long long pushed = 0, popped = 0;
+
+    for (size_t i = 1; i <= context->per_thread; ++i)
+    {
+        size_t value = 0;
+        int error = 0;
+        if (context->mode == SHARED)
+        {
+            cgc_concurrent_stack_push (& context->concurrent, & i);
+            error = cgc_concurrent_stack_pop_into (& context->concurrent, & value);
+        }
+        else if (context->mode == MAGAZINE)
+        {
+            cgc_concurrent_stack_magazine_push (& magazine, & i);
+            error = cgc_concurrent_stack_magazine_pop_into (& magazine, & value);
+        }
+        else
+        {
+            pthread_mutex_lock (& context->mutex);
+            cgc_stack_push (& context->locked, & i);
+            error = cgc_stack_pop_into (& context->locked, & value);
+            pthread_mutex_unlock (& context->mutex);
+        }
+        pushed += i;
+        popped += error ? 0 : value;
+    }
+
+    cgc_concurrent_stack_magazine_flush (& magazine);
+    context->pushed += pushed;
+    context->popped += popped;
+
+    return NULL;
+}
+
+/* Run the threads, and return the push and pop pairs per second. */
+static double run (bench_context * context, size_t threads)
+{
+    pthread_t * ids = malloc (threads * sizeof * ids);
+    context->per_thread = OPERATIONS / threads;
+    context->pushed = 0;
+    context->popped = 0;
+
+    struct timespec start, end;
+    clock_gettime (CLOCK_MONOTONIC, & start);
+    for (size_t t = 0; t < threads; ++t)
+        pthread_create (& ids[t], NULL, work, context);
+    for (size_t t = 0; t < threads; ++t)
+        pthread_join (ids[t], NULL);
+    clock_gettime (CLOCK_MONOTONIC, & end);
+    free (ids);
+
+    /* Drain what is left, then check that no element was lost. */
+    size_t value;
+    while (cgc_concurrent_stack_pop_into (& context->concurrent, & value) == 0)
+        context->popped += value;
+    while (cgc_stack_pop_into (& context->locked, & value) == 0)
+        context->popped += value;
+    if (context->pushed != context->popped)
+        printf ("lost elements!\n");
+
+    double seconds = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+    return (double) (threads * context->per_thread) / seconds;
+}
+
+int main (int argc, char ** argv)
+{
+    size_t max_threads = argc > 1 ? (size_t) strtoul (argv[1], NULL, 10) : 4;
+
+    bench_context * context = aligned_alloc (_Alignof (bench_context), sizeof * context);
+    cgc_concurrent_stack_init (& context->concurrent, sizeof (size_t), NULL, NULL, CAPACITY);
+    pthread_mutex_init (& context->mutex, NULL);
+    cgc_stack_init (& context->locked, sizeof (size_t), NULL, NULL);
+
+    printf ("threads   shared (M/s)   magazine (M/s)   mutex + cgc_stack (M/s)\n");
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double results[3];
+        for (bench_mode mode = SHARED; mode <= LOCKED; ++mode)
+        {
+            context->mode = mode;
+            results[mode] = run (context, threads);
+        }
+        printf ("%7lu   %12.2f   %14.2f   %23.2f\n", threads, results[SHARED] / 1e6, results[MAGAZINE] / 1e6, results[LOCKED] / 1e6);
+    }
+
+    cgc_stack_clean (& context->locked);
+    pthread_mutex_destroy (& context->mutex);
+    cgc_concurrent_stack_clean (& context->concurrent);
+    free (context);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <cgc/mpmc_queue.h>
+#include <cgc/queue.h>
+
+#define TRANSFERS 200000
+#define CAPACITY 1024
+
+/* A cgc_queue behind a mutex, as a baseline. */
+typedef struct locked_queue
+{
+    pthread_mutex_t mutex;
+    cgc_queue queue;
+} locked_queue;
+
+typedef struct bench_context
+{
+    cgc_mpmc_queue mpmc;
+    locked_queue locked;
+    bool use_mpmc;
+    size_t per_thread;
+    _Atomic unsigned long long sum;
+} bench_context;
+
+static int locked_push (locked_queue * q, const size_t * value)
+{
+    int error = -1;
+    while (error)
+    {
+        pthread_mutex_lock (& q->mutex);
+        if (cgc_queue_size (& q->queue) < CAPACITY)
+            error = cgc_queue_push (& q->queue, value);
+        pthread_mutex_unlock (& q->mutex);
+        if (error)
+            sched_yield ();
+    }
+
+    return error;
+}
+
+static int locked_pop (locked_queue * q, size_t * value)
+{
+    int error = -1;
+    while (error)
+    {
+        pthread_mutex_lock (& q->mutex);
+        error = cgc_queue_pop_into (& q->queue, value);
+        pthread_mutex_unlock (& q->mutex);
+        if (error)
+            sched_yield ();
+    }
+
+    return error;
+}
+
+static void * produce (void * arg)
+{
+    bench_context * context = arg;
+    for (size_t i = 1; i <= context->per_thread; ++i)
+    {
+        if (context->use_mpmc)
+            cgc_mpmc_queue_push (& context->mpmc, & i);
+        else
+            locked_push (& context->locked, & i);
+    }
+
+    return NULL;
+}
+
+static void * consume (void * arg)
+{
+    bench_context * context = arg;
+    unsigned long long sum = 0;
+    for (size_t i = 0; i < context->per_thread; ++i)
+    {
+        size_t value;
+        if (context->use_mpmc)
+            cgc_mpmc_queue_pop_into (& context->mpmc, & value);
+        else
+            locked_pop (& context->locked, & value);
+        sum += value;
+    }
+    context->sum += sum;
+
+    return NULL;
+}
+
+/* Run as many producers as consumers, and return the transfers per second. */
+static double run (bench_context * context, size_t threads)
+{
+    pthread_t * ids = malloc (2 * threads * sizeof * ids);
+    context->per_thread = TRANSFERS / threads;
+    context->sum = 0;
+
+    struct timespec start, end;
+    clock_gettime (CLOCK_MONOTONIC, & start);
+    for (size_t t = 0; t < threads; ++t)
+    {
+        pthread_create (& ids[2 * t], NULL, consume, context);
+        pthread_create (& ids[2 * t + 1], NULL, produce, context);
+    }
+    for (size_t t = 0; t < 2 * threads; ++t)
+        pthread_join (ids[t], NULL);
+    clock_gettime (CLOCK_MONOTONIC, & end);
+    free (ids);
+
+    unsigned long long n = context->per_thread;
+    if (context->sum != threads * n * (n + 1) / 2)
+        printf ("wrong sum!\n");
+
+    double seconds = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+    return (double) (threads * context->per_thread) / seconds;
+}
+
+int main (int argc, char ** argv)
+{
+    size_t max_threads = argc > 1 ? (size_t) strtoul (argv[1], NULL, 10) : 4;
+
+    bench_context * context = aligned_alloc (_Alignof (bench_context), sizeof * context);
+    cgc_mpmc_queue_init (& context->mpmc, sizeof (size_t), NULL, NULL, CAPACITY);
+    pthread_mutex_init (& context->locked.mutex, NULL);
+    cgc_queue_init (& context->locked.queue, sizeof (size_t), NULL, NULL);
+
+    printf ("pairs   mpmc (M/s)   mutex + cgc_queue (M/s)\n");
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        context->use_mpmc = true;
+        double mpmc = run (context, threads);
+        context->use_mpmc = false;
+        double locked = run (context, threads);
+        printf ("%5lu   %10.2f   %23.2f\n", threads, mpmc / 1e6, locked / 1e6);
+    }
+
+    cgc_queue_clean (& context->locked.queue);
+    pthread_mutex_destroy (& context->locked.mutex);
+    cgc_mpmc_queue_clean (& context->mpmc);
+    free (context);
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <cgc/blocking_queue.h>
+
+#define PRODUCERS 2
+#define ELEMENTS 100000
+#define BATCH 32
+
+static cgc_blocking_queue queue;
+
+static void * produce (void * arg)
+{
+    (void) arg;
+    for (int i = 1; i <= ELEMENTS; ++i)
+        cgc_blocking_queue_push (& queue, & i, -1);
+
+    return NULL;
+}
+
+static void * consume (void * arg)
+{
+    long long * sum = arg;
+    int batch[BATCH];
+    size_t n;
+    while ((n = cgc_blocking_queue_pop_batch (& queue, batch, BATCH, -1)) != 0)
+        for (size_t i = 0; i < n; ++i)
+            * sum += batch[i];
+
+    return NULL;
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    cgc_blocking_queue_init (& queue, sizeof (int), NULL, NULL, 64);
+
+    /* Timeouts. */
+    int i = 42;
+    int result = cgc_blocking_queue_pop_into (& queue, & i, 20);
+    printf ("pop from empty queue: %d (%s)\n", result, strerror (errno));
+    for (int j = 0; j < 64; ++j)
+        cgc_blocking_queue_push (& queue, & j, 0);
+    result = cgc_blocking_queue_push (& queue, & i, 0);
+    printf ("push into full queue: %d (%s)\n", result, strerror (errno));
+    cgc_blocking_queue_clear (& queue);
+
+    /* Producers and a consumer, until the queue is closed. */
+    long long sum = 0;
+    pthread_t consumer, producers[PRODUCERS];
+    pthread_create (& consumer, NULL, consume, & sum);
+    for (int p = 0; p < PRODUCERS; ++p)
+        pthread_create (& producers[p], NULL, produce, NULL);
+    for (int p = 0; p < PRODUCERS; ++p)
+        pthread_join (producers[p], NULL);
+    cgc_blocking_queue_close (& queue);
+    pthread_join (consumer, NULL);
+
+    long long expected = (long long) PRODUCERS * ELEMENTS * (ELEMENTS + 1) / 2;
+    printf ("sum: %lld, expected: %lld\n", sum, expected);
+    result = cgc_blocking_queue_push (& queue, & i, -1);
+    printf ("push into closed queue: %d (%s)\n", result, strerror (errno));
+
+    cgc_blocking_queue_clean (& queue);
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <cgc/compact_list.h>
+
+static int int_print (void * i)
+{
+    int * integer = i;
+    printf ("%d ", * integer);
+
+    return 0;
+}
+
+static inline void print_int_list (const char * list_name, cgc_compact_list * list)
+{
+    printf ("%s: [ ", list_name);
+    cgc_compact_list_map (list, int_print);
+    printf ("], size %lu\n", cgc_compact_list_size (list));
+}
+
+/* Erased nodes shall be reused by the following insertions. */
+static inline size_t check_free_list_reuse (void)
+{
+    cgc_compact_list * list = cgc_compact_list_create (sizeof (int), NULL, NULL);
+    for (int i = 0; i < 8; ++i)
+        cgc_compact_list_push_back (list, & i);
+
+    const void * const erased = cgc_compact_list_at (list, 3);
+    cgc_compact_list_erase (list, 3, 4);
+    int i = 42;
+    cgc_compact_list_push_front (list, & i);
+    const void * const reused = cgc_compact_list_front (list);
+
+    size_t mismatches = erased != reused;
+    const int expected [] = { 42, 0, 1, 2, 4, 5, 6, 7 };
+    for (size_t j = 0; j < sizeof (expected) / sizeof (expected[0]); ++j)
+    {
+        int * element = cgc_compact_list_at (list, j);
+        if (element == NULL || * element != expected[j])
+            mismatches++;
+    }
+
+    cgc_compact_list_destroy (list);
+
+    return mismatches;
+}
+
+/* Elements smaller than the links shall keep the links and themselves aligned. */
+static inline size_t check_small_elements (void)
+{
+    cgc_compact_list * chars = cgc_compact_list_create (sizeof (char), NULL, NULL);
+    cgc_compact_list * shorts = cgc_compact_list_create (sizeof (short), NULL, NULL);
+    cgc_compact_list * doubles = cgc_compact_list_create (sizeof (double), NULL, NULL);
+    for (int i = 0; i < 100; ++i)
+    {
+        char c = (char) ('a' + i % 26);
+        short s = (short) i;
+        double d = i;
+        cgc_compact_list_push_back (chars, & c);
+        cgc_compact_list_push_front (shorts, & s);
+        cgc_compact_list_push_back (doubles, & d);
+    }
+    cgc_compact_list_erase (chars, 10, 20);
+    cgc_compact_list_erase (shorts, 10, 20);
+
+    size_t mismatches = cgc_compact_list_size (chars) != 90 || cgc_compact_list_size (shorts) != 90;
+    for (size_t i = 0; i < 90; ++i)
+    {
+        const size_t original = i < 10 ? i : i + 10;
+        char * c = cgc_compact_list_at (chars, i);
+        short * s = cgc_compact_list_at (shorts, i);
+        if (c == NULL || * c != (char) ('a' + original % 26))
+            mismatches++;
+        if (s == NULL || * s != (short) (99 - original) || (uintptr_t) s % _Alignof (short) != 0)
+            mismatches++;
+    }
+    for (size_t i = 0; i < 100; ++i)
+    {
+        double * d = cgc_compact_list_at (doubles, i);
+        if (d == NULL || (uintptr_t) d % _Alignof (double) != 0)
+            mismatches++;
+    }
+
+    cgc_compact_list_destroy (doubles);
+    cgc_compact_list_destroy (shorts);
+    cgc_compact_list_destroy (chars);
+
+    return mismatches;
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    cgc_compact_list * list = cgc_compact_list_create (sizeof (int), NULL, NULL);
+    for (int i = 0; i < 10; ++i)
+        cgc_compact_list_push_back (list, & i);
+    int i = 42;
+    cgc_compact_list_insert (list, 5, & i);
+    cgc_compact_list_erase (list, 0, 2);
+    print_int_list ("list", list);
+
+    int * front = cgc_compact_list_pop_front (list);
+    int * back = cgc_compact_list_pop_back (list);
+    int * at = cgc_compact_list_at (list, 2);
+    printf ("popped: %d %d, at 2: %d\n", * front, * back, * at);
+    free (front);
+    free (back);
+
+    cgc_compact_list * copy = cgc_compact_list_copy (list);
+    print_int_list ("copy", copy);
+    cgc_compact_list_destroy (copy);
+    cgc_compact_list_destroy (list);
+
+    printf ("free list reuse mismatches: %lu\n", check_free_list_reuse ());
+    printf ("small elements mismatches: %lu\n", check_small_elements ());
+
+    return 0;
+}
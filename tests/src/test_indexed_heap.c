@@ -0,0 +1,119 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <cgc/indexed_heap.h>
+
+#define VERTICES 2000
+#define EDGES_PER_VERTEX 8
+#define INFINITE_DISTANCE ((unsigned long) -1)
+
+static size_t targets[VERTICES][EDGES_PER_VERTEX];
+static unsigned long weights[VERTICES][EDGES_PER_VERTEX];
+
+static int distance_compare (const void * a, const void * b)
+{
+    const unsigned long * const x = a;
+    const unsigned long * const y = b;
+    return (* x > * y) - (* x < * y);
+}
+
+/* Dijkstra's algorithm, with decrease-key instead of duplicate entries. */
+static void shortest_paths_heap (size_t source, size_t arity, unsigned long * distances)
+{
+    cgc_indexed_heap * heap = cgc_indexed_heap_create (sizeof (unsigned long), distance_compare, arity);
+    cgc_indexed_heap_reserve (heap, VERTICES);
+    for (size_t v = 0; v < VERTICES; ++v)
+        distances[v] = INFINITE_DISTANCE;
+
+    distances[source] = 0;
+    cgc_indexed_heap_push (heap, source, & distances[source]);
+    size_t u;
+    unsigned long d;
+    while (cgc_indexed_heap_pop (heap, & u, & d) == 0)
+        for (size_t e = 0; e < EDGES_PER_VERTEX; ++e)
+        {
+            size_t v = targets[u][e];
+            unsigned long candidate = d + weights[u][e];
+            if (candidate < distances[v])
+            {
+                bool queued = cgc_indexed_heap_contains (heap, v);
+                distances[v] = candidate;
+                if (queued)
+                    cgc_indexed_heap_decrease_key (heap, v, & candidate);
+                else
+                    cgc_indexed_heap_push (heap, v, & candidate);
+            }
+        }
+
+    cgc_indexed_heap_destroy (heap);
+}
+
+/* Quadratic Dijkstra, used as a reference. */
+static void shortest_paths_naive (size_t source, unsigned long * distances)
+{
+    static bool done[VERTICES];
+    for (size_t v = 0; v < VERTICES; ++v)
+    {
+        distances[v] = INFINITE_DISTANCE;
+        done[v] = false;
+    }
+
+    distances[source] = 0;
+    for (;;)
+    {
+        size_t u = VERTICES;
+        for (size_t v = 0; v < VERTICES; ++v)
+            if (! done[v] && distances[v] != INFINITE_DISTANCE && (u == VERTICES || distances[v] < distances[u]))
+                u = v;
+        if (u == VERTICES)
+            break;
+
+        done[u] = true;
+        for (size_t e = 0; e < EDGES_PER_VERTEX; ++e)
+        {
+            size_t v = targets[u][e];
+            if (distances[u] + weights[u][e] < distances[v])
+                distances[v] = distances[u] + weights[u][e];
+        }
+    }
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    srand (42);
+    for (size_t u = 0; u < VERTICES; ++u)
+        for (size_t e = 0; e < EDGES_PER_VERTEX; ++e)
+        {
+            targets[u][e] = (size_t) rand () % VERTICES;
+            weights[u][e] = 1 + (unsigned long) rand () % 1000;
+        }
+
+    static unsigned long expected[VERTICES];
+    static unsigned long obtained[VERTICES];
+    shortest_paths_naive (0, expected);
+    for (size_t arity = 2; arity <= 8; arity *= 2)
+    {
+        shortest_paths_heap (0, arity, obtained);
+        size_t mismatches = 0;
+        for (size_t v = 0; v < VERTICES; ++v)
+            if (expected[v] != obtained[v])
+                mismatches++;
+        printf ("arity %lu: %lu mismatches\n", arity, mismatches);
+    }
+
+    cgc_indexed_heap * heap = cgc_indexed_heap_create (sizeof (unsigned long), distance_compare, 0);
+    unsigned long key = 10;
+    cgc_indexed_heap_push (heap, 3, & key);
+    int duplicate = cgc_indexed_heap_push (heap, 3, & key);
+    key = 20;
+    int wrong_way = cgc_indexed_heap_decrease_key (heap, 3, & key);
+    int increased = cgc_indexed_heap_increase_key (heap, 3, & key);
+    printf ("duplicate push: %d, decrease to a larger key: %d, increase: %d\n",
+        duplicate, wrong_way, increased);
+    cgc_indexed_heap_destroy (heap);
+
+    return 0;
+}
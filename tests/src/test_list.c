@@ -27,6 +27,13 @@ static int int_diff_left (void * result, const void * a)
     return 0;
 }
 
+static int int_compare (const void * a, const void * b)
+{
+    const int * x = a;
+    const int * y = b;
+    return (* x > * y) - (* x < * y);
+}
+
 static inline void print_int_list (const char * list_name, cgc_list * list)
 {
     printf ("%s: [ ", list_name);
@@ -48,6 +55,56 @@ static inline void fold_right_diff (const char * list_name, const cgc_list * lis
     printf ("fold_right (-) %d %s = %d\n", 0, list_name, base_result);
 }
 
+/* Scatter a list, compact it, then check the layout and the ownership of the block. */
+static size_t check_compact (void)
+{
+    cgc_list * list = cgc_list_create (sizeof (int), NULL, NULL);
+    cgc_list * other = cgc_list_create (sizeof (int), NULL, NULL);
+    for (int i = 0; i < 100; ++i)
+    {
+        cgc_list_push_front (list, & i);
+        cgc_list_push_back (other, & i);
+    }
+    cgc_list_clear (other);
+    cgc_list_sort (list, int_compare);
+
+    size_t mismatches = cgc_list_compact (list) != 0;
+    const char * previous = NULL;
+    ptrdiff_t stride = 0;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        const int * const element = cgc_list_at (list, i);
+        const char * const address = (const char *) element;
+        if (* element != (int) i)
+            mismatches++;
+        if (i == 1)
+            stride = address - previous;
+        else if (i > 1 && address - previous != stride)
+            mismatches++;
+        previous = address;
+    }
+    if (stride <= 0)
+        mismatches++;
+
+    /* Popped elements are copied out of the block, moved ones keep it alive. */
+    int * front = cgc_list_pop_front (list);
+    int * back = cgc_list_pop_back (list);
+    if (front == NULL || * front != 0 || back == NULL || * back != 99)
+        mismatches++;
+    free (front);
+    free (back);
+    cgc_list_erase (list, 0, 10);
+    cgc_list_split_at (list, 40, other);
+    cgc_list_destroy (list);
+
+    int * first = cgc_list_front (other);
+    if (cgc_list_size (other) != 48 || first == NULL || * first != 51)
+        mismatches++;
+    cgc_list_compact (other);
+    cgc_list_destroy (other);
+
+    return mismatches;
+}
 
 int main (int argc, char ** argv)
 {
@@ -76,6 +133,43 @@ int main (int argc, char ** argv)
     cgc_list_insert (lists[0], 20, & i);
     print_int_list ("list_0", lists[0]);
 
+    /* Drop the even integers and duplicate the odd ones in a single pass. */
+    cgc_list_cursor cursor = cgc_list_cursor_first (lists[0]);
+    while (cgc_list_cursor_is_valid (& cursor))
+    {
+        int * current = cgc_list_cursor_get (& cursor);
+        if (* current % 2 == 0)
+            cgc_list_erase_at (& cursor);
+        else
+        {
+            cgc_list_insert_after (& cursor, current);
+            cgc_list_cursor_next (& cursor);
+            cgc_list_cursor_next (& cursor);
+        }
+    }
+    print_int_list ("list_0", lists[0]);
+
+    /* Move the second half of list_0 in the middle of list_1. */
+    cgc_list tail;
+    cgc_list_split_at (lists[0], 5, & tail);
+    cgc_list_splice (lists[1], 3, & tail);
+    print_int_list ("list_0", lists[0]);
+    print_int_list ("list_1", lists[1]);
+    cgc_list_concat (lists[0], lists[1]);
+    print_int_list ("list_0", lists[0]);
+    print_int_list ("list_1", lists[1]);
+    cgc_list_clean (& tail);
+
+    cgc_list_sort (lists[0], int_compare);
+    print_int_list ("list_0", lists[0]);
+    for (int j = 0; j < 5; ++j)
+        cgc_list_push_back (lists[1], & j);
+    cgc_list_merge (lists[0], lists[1], int_compare);
+    print_int_list ("list_0", lists[0]);
+    cgc_list_compact (lists[0]);
+    print_int_list ("list_0", lists[0]);
+    printf ("compact mismatches: %lu\n", check_compact ());
+
     free (popped_int);
     cgc_list_destroy (lists[0]);
     cgc_list_destroy (lists[1]);
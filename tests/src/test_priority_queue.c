@@ -0,0 +1,86 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <cgc/priority_queue.h>
+#include <cgc/vector.h>
+
+#define ELEMENTS 100000
+
+static int int_compare (const void * a, const void * b)
+{
+    const int * const x = a;
+    const int * const y = b;
+    return (* x > * y) - (* x < * y);
+}
+
+static int int_copy (const void * source, void * destination)
+{
+    * (int *) destination = * (const int *) source;
+    return 0;
+}
+
+/* Pop everything and count the elements coming out of order. */
+static size_t drain (cgc_priority_queue * queue, size_t * popped)
+{
+    size_t disorders = 0;
+    int previous = 0;
+    * popped = 0;
+    for (int value; cgc_priority_queue_pop_into (queue, & value) == 0; ++* popped)
+    {
+        if (* popped > 0 && value < previous)
+            disorders++;
+        previous = value;
+    }
+    return disorders;
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    cgc_priority_queue * queue = cgc_priority_queue_create (sizeof (int), NULL, NULL, int_compare);
+    size_t popped;
+
+    srand (42);
+    for (int i = 0; i < ELEMENTS; ++i)
+    {
+        int value = rand ();
+        cgc_priority_queue_push (queue, & value);
+    }
+    size_t disorders = drain (queue, & popped);
+    printf ("push: %lu popped, %lu out of order\n", popped, disorders);
+
+    cgc_vector * vector = cgc_vector_create (sizeof (int), NULL, NULL, 0);
+    cgc_vector_reserve (vector, ELEMENTS);
+    for (int i = 0; i < ELEMENTS; ++i)
+    {
+        int value = rand ();
+        cgc_vector_push_back (vector, & value);
+    }
+    cgc_priority_queue_heapify (queue, vector);
+    printf ("heapify: %lu in the queue, %lu left in the vector\n",
+        cgc_priority_queue_size (queue), cgc_vector_size (vector));
+
+    int batch[1000];
+    for (size_t i = 0; i < sizeof batch / sizeof * batch; ++i)
+        batch[i] = rand ();
+    cgc_priority_queue_push_n (queue, batch, sizeof batch / sizeof * batch);
+    disorders = drain (queue, & popped);
+    printf ("heapify + push_n: %lu popped, %lu out of order\n", popped, disorders);
+
+    cgc_priority_queue_push_n (queue, batch, sizeof batch / sizeof * batch);
+    printf ("push_n into an empty queue, top: %d\n", * (int *) cgc_priority_queue_top (queue));
+    disorders = drain (queue, & popped);
+    printf ("push_n: %lu popped, %lu out of order\n", popped, disorders);
+
+    cgc_vector * copied = cgc_vector_create (sizeof (int), int_copy, NULL, 0);
+    cgc_vector_push_back (copied, & batch[0]);
+    printf ("heapify with another copy function: %d, %lu left in the vector\n",
+        cgc_priority_queue_heapify (queue, copied), cgc_vector_size (copied));
+    cgc_vector_destroy (copied);
+
+    cgc_vector_destroy (vector);
+    cgc_priority_queue_destroy (queue);
+
+    return 0;
+}
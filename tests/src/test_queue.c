@@ -0,0 +1,124 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <cgc/queue.h>
+
+#define BATCH 40
+
+static int int_copy (const void * source, void * destination)
+{
+    const int * const s = source;
+    int * const d = destination;
+    * d = * s;
+
+    return 0;
+}
+
+/* Pop everything and count the elements not following expected. */
+static size_t drain (cgc_queue * queue, int expected)
+{
+    size_t mismatches = 0;
+    for (int value; cgc_queue_pop_into (queue, & value) == 0; ++expected)
+        if (value != expected)
+            mismatches++;
+
+    return mismatches;
+}
+
+/* Make the content wrap around the end of the buffer, then grow it. */
+static size_t check_wrapped_grow (void)
+{
+    cgc_queue * queue = cgc_queue_create (sizeof (int), NULL, NULL);
+    int value = 0;
+    for (; value < 16; ++value)
+        cgc_queue_push (queue, & value);
+    size_t mismatches = 0;
+    for (int expected = 0; expected < 10; ++expected)
+    {
+        int popped;
+        if (cgc_queue_pop_into (queue, & popped) != 0 || popped != expected)
+            mismatches++;
+    }
+
+    /* 6 elements at the end of the buffer, 10 at its beginning, then grow. */
+    for (; value < 26; ++value)
+        cgc_queue_push (queue, & value);
+    for (; value < 40; ++value)
+        cgc_queue_push (queue, & value);
+
+    int * front = cgc_queue_front (queue);
+    int * back = cgc_queue_back (queue);
+    if (front == NULL || * front != 10 || back == NULL || * back != 39)
+        mismatches++;
+
+    cgc_queue * copy = cgc_queue_copy (queue);
+    mismatches += drain (copy, 10);
+    mismatches += drain (queue, 10);
+    cgc_queue_destroy (copy);
+    cgc_queue_destroy (queue);
+
+    return mismatches;
+}
+
+/* Push and pop batches split across the end of the buffer. */
+static size_t check_wrapped_batches (cgc_copy_function copy_fun)
+{
+    cgc_queue * queue = cgc_queue_create (sizeof (int), copy_fun, NULL);
+    int batch[BATCH];
+    int pushed = 0;
+    int popped = 0;
+    size_t mismatches = 0;
+
+    cgc_queue_reserve (queue, 32);
+    for (int round = 0; round < 100; ++round)
+    {
+        const size_t count = (size_t) (round % 7) + 20;
+        for (size_t i = 0; i < count; ++i)
+            batch[i] = pushed++;
+        if (cgc_queue_push_n (queue, batch, count) != 0)
+            mismatches++;
+
+        const size_t n = cgc_queue_pop_n (queue, batch, count);
+        for (size_t i = 0; i < n; ++i)
+            if (batch[i] != popped++)
+                mismatches++;
+    }
+    mismatches += drain (queue, popped);
+    cgc_queue_destroy (queue);
+
+    return mismatches;
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    cgc_queue * queue = cgc_queue_create (sizeof (int), NULL, NULL);
+    int value;
+    void * popped = cgc_queue_pop (queue);
+    printf ("empty queue: pop %s, pop_into %d, pop_n %lu\n", popped == NULL ? "NULL" : "not NULL",
+        cgc_queue_pop_into (queue, & value), cgc_queue_pop_n (queue, & value, 1));
+    printf ("NULL queue: pop %s\n", cgc_queue_pop (NULL) == NULL ? "NULL" : "not NULL");
+
+    errno = 0;
+    cgc_queue_push (queue, & value);
+    int error = cgc_queue_push_n (queue, & value, SIZE_MAX);
+    printf ("overflowing push_n: %d, errno %s, size %lu\n", error,
+        errno == ENOMEM ? "ENOMEM" : "not ENOMEM", cgc_queue_size (queue));
+    cgc_queue_clear (queue);
+
+    for (value = 0; value < 5; ++value)
+        cgc_queue_push (queue, & value);
+    int * front = cgc_queue_pop (queue);
+    printf ("popped: %d, size %lu\n", * front, cgc_queue_size (queue));
+    free (front);
+    cgc_queue_destroy (queue);
+
+    printf ("wrapped grow mismatches: %lu\n", check_wrapped_grow ());
+    printf ("wrapped batches mismatches: %lu\n", check_wrapped_batches (NULL));
+    printf ("wrapped batches with copy function mismatches: %lu\n", check_wrapped_batches (int_copy));
+
+    return 0;
+}
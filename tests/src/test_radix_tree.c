@@ -0,0 +1,77 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cgc/radix_tree.h>
+
+#define KEYS 100000
+
+static int print_entry (const void * key, size_t length, void * value, void * data)
+{
+    (void) data;
+    printf ("%.*s -> %d\n", (int) length, (const char *) key, * (int *) value);
+    return 0;
+}
+
+static int count_entry (const void * key, size_t length, void * value, void * data)
+{
+    (void) key; (void) length; (void) value;
+    ++* (size_t *) data;
+    return 0;
+}
+
+static void make_key (char * buffer, size_t size, size_t i)
+{
+    snprintf (buffer, size, "%s/%zu", i % 2 ? "/usr/lib" : "/usr/local/share", i);
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+    cgc_radix_tree * tree = cgc_radix_tree_create (sizeof (int), NULL, NULL);
+
+    const char * routes[] = { "/", "/usr", "/usr/local", "/usr/local/bin", "/home", "/home/user" };
+    for (int i = 0; i < (int) (sizeof routes / sizeof * routes); ++i)
+        cgc_radix_tree_insert (tree, routes[i], strlen (routes[i]), & i);
+
+    printf ("entries:\n--------\n");
+    cgc_radix_tree_for_each (tree, print_entry, NULL);
+
+    printf ("\nprefix \"/usr\":\n--------------\n");
+    cgc_radix_tree_for_each_prefix (tree, "/usr", 4, print_entry, NULL);
+
+    const char * path = "/usr/local/lib/libcgc.a";
+    size_t matched = 0;
+    int * route = cgc_radix_tree_longest_prefix (tree, path, strlen (path), & matched);
+    printf ("\nlongest prefix of %s: %.*s -> %d\n", path, (int) matched, path, route != NULL ? * route : -1);
+
+    cgc_radix_tree_erase (tree, "/usr/local", 10);
+    printf ("erased /usr/local: %s\n", cgc_radix_tree_find (tree, "/usr/local", 10) == NULL ? "yes" : "no");
+    cgc_radix_tree_clear (tree);
+
+    char buffer[64];
+    size_t mismatches = 0;
+    for (size_t i = 0; i < KEYS; ++i)
+    {
+        int value = (int) i;
+        make_key (buffer, sizeof buffer, i);
+        cgc_radix_tree_insert (tree, buffer, strlen (buffer), & value);
+    }
+    for (size_t i = 0; i < KEYS; i += 2)
+    {
+        make_key (buffer, sizeof buffer, i);
+        cgc_radix_tree_erase (tree, buffer, strlen (buffer));
+    }
+    for (size_t i = 0; i < KEYS; ++i)
+    {
+        make_key (buffer, sizeof buffer, i);
+        int * value = cgc_radix_tree_find (tree, buffer, strlen (buffer));
+        mismatches += i % 2 ? value == NULL || * value != (int) i : value != NULL;
+    }
+    size_t count = 0;
+    cgc_radix_tree_for_each_prefix (tree, "/usr/lib/", 9, count_entry, & count);
+    printf ("\n%zu entries, %zu under /usr/lib/, %zu mismatches\n", cgc_radix_tree_size (tree), count, mismatches);
+
+    cgc_radix_tree_destroy (tree);
+    return 0;
+}
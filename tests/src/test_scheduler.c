@@ -0,0 +1,57 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdatomic.h>
+
+#include <cgc/scheduler.h>
+
+static cgc_scheduler * scheduler;
+static atomic_long leaves;
+
+/* Count the leaves of the Fibonacci call tree, one task per call. */
+static int fibonacci (void * argument)
+{
+    long n = (long) (intptr_t) argument;
+    if (n < 2)
+        atomic_fetch_add (& leaves, 1);
+    else
+    {
+        cgc_scheduler_spawn (scheduler, fibonacci, (void *) (intptr_t) (n - 1));
+        cgc_scheduler_spawn (scheduler, fibonacci, (void *) (intptr_t) (n - 2));
+    }
+
+    return 0;
+}
+
+static long sequential_fibonacci (long n)
+{
+    return n < 2 ? 1 : sequential_fibonacci (n - 1) + sequential_fibonacci (n - 2);
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    cgc_work_deque * deque = cgc_work_deque_create (2);
+    long values[10];
+    for (long i = 0; i < 10; ++i)
+    {
+        values[i] = i;
+        cgc_work_deque_push (deque, & values[i]);
+    }
+    long * stolen = cgc_work_deque_steal (deque);
+    long * popped = cgc_work_deque_pop (deque);
+    printf ("stolen: %ld, popped: %ld, size: %lu\n", * stolen, * popped, cgc_work_deque_size (deque));
+    cgc_work_deque_destroy (deque);
+
+    scheduler = cgc_scheduler_create (4);
+    for (long n = 10; n <= 20; n += 5)
+    {
+        atomic_store (& leaves, 0);
+        cgc_scheduler_spawn (scheduler, fibonacci, (void *) (intptr_t) n);
+        cgc_scheduler_wait (scheduler);
+        printf ("fibonacci (%ld): %ld, expected: %ld\n", n, atomic_load (& leaves), sequential_fibonacci (n));
+    }
+    cgc_scheduler_destroy (scheduler);
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <cgc/skip_list.h>
+#include <cgc/vector.h>
+
+static int int_print (void * i)
+{
+    int * integer = i;
+    printf ("%d ", * integer);
+
+    return 0;
+}
+
+static inline void print_int_list (const char * list_name, cgc_skip_list * list)
+{
+    printf ("%s: [ ", list_name);
+    cgc_skip_list_map (list, int_print);
+    printf ("], size %lu\n", cgc_skip_list_size (list));
+}
+
+/* Apply the same random edits to a skip list and a vector, then compare. */
+static inline size_t compare_with_vector (unsigned int seed, int operations)
+{
+    cgc_skip_list * list = cgc_skip_list_create (sizeof (int), NULL, NULL);
+    cgc_vector * vector = cgc_vector_create (sizeof (int), NULL, NULL, 1024);
+
+    srand (seed);
+    for (int i = 0; i < operations; ++i)
+    {
+        size_t size = cgc_skip_list_size (list);
+        size_t index = size > 0 ? (size_t) rand () % size : 0;
+        if (size > 0 && rand () % 3 == 0)
+        {
+            cgc_skip_list_erase (list, index, index + 1);
+            cgc_vector_erase (vector, index, index + 1);
+        }
+        else
+        {
+            cgc_skip_list_insert (list, index, & i);
+            cgc_vector_insert (vector, index, & i);
+        }
+    }
+
+    size_t mismatches = cgc_skip_list_size (list) != cgc_vector_size (vector);
+    for (size_t i = 0; i < cgc_vector_size (vector); ++i)
+    {
+        int * a = cgc_skip_list_at (list, i);
+        int * b = cgc_vector_at (vector, i);
+        if (a == NULL || * a != * b)
+            mismatches++;
+    }
+
+    cgc_vector_destroy (vector);
+    cgc_skip_list_destroy (list);
+
+    return mismatches;
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    cgc_skip_list * list = cgc_skip_list_create (sizeof (int), NULL, NULL);
+    for (int i = 0; i < 10; ++i)
+        cgc_skip_list_push_back (list, & i);
+    int i = 42;
+    cgc_skip_list_insert (list, 5, & i);
+    cgc_skip_list_erase (list, 0, 2);
+    print_int_list ("list", list);
+
+    int * front = cgc_skip_list_pop_front (list);
+    int * back = cgc_skip_list_pop_back (list);
+    int * at = cgc_skip_list_at (list, 2);
+    printf ("popped: %d %d, at 2: %d\n", * front, * back, * at);
+    free (front);
+    free (back);
+
+    cgc_skip_list * copy = cgc_skip_list_copy (list);
+    print_int_list ("copy", copy);
+    cgc_skip_list_destroy (copy);
+    cgc_skip_list_destroy (list);
+
+    printf ("mismatches with cgc_vector: %lu\n", compare_with_vector (42, 20000));
+
+    return 0;
+}
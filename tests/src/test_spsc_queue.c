@@ -0,0 +1,83 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <cgc/spsc_queue.h>
+
+#define TRANSFERS 1000000
+#define BATCH 64
+
+static cgc_spsc_queue queue;
+
+static void * produce (void * arg)
+{
+    (void) arg;
+    unsigned int batch[BATCH];
+    unsigned int next = 0;
+    while (next < TRANSFERS)
+    {
+        size_t n = TRANSFERS - next < BATCH ? TRANSFERS - next : BATCH;
+        for (size_t i = 0; i < n; ++i)
+            batch[i] = next + (unsigned int) i;
+        size_t pushed = cgc_spsc_queue_push_n (& queue, batch, n);
+        if (pushed == 0)
+            sched_yield ();
+        next += (unsigned int) pushed;
+    }
+
+    return NULL;
+}
+
+static void * consume (void * arg)
+{
+    size_t * mismatches = arg;
+    unsigned int batch[BATCH];
+    unsigned int expected = 0;
+    while (expected < TRANSFERS)
+    {
+        size_t n = cgc_spsc_queue_pop_n (& queue, batch, BATCH);
+        if (n == 0)
+            sched_yield ();
+        for (size_t i = 0; i < n; ++i)
+            if (batch[i] != expected++)
+                ++* mismatches;
+    }
+
+    return NULL;
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    cgc_spsc_queue_init (& queue, sizeof (unsigned int), NULL, NULL, 1000);
+    printf ("capacity: %lu\n", cgc_spsc_queue_capacity (& queue));
+
+    for (unsigned int i = 0; i < 5; ++i)
+        cgc_spsc_queue_push (& queue, & i);
+    unsigned int popped;
+    cgc_spsc_queue_pop_into (& queue, & popped);
+    printf ("popped: %u, size: %lu\n", popped, cgc_spsc_queue_size (& queue));
+    cgc_spsc_queue_clear (& queue);
+
+    size_t mismatches = 0;
+    struct timespec start, end;
+    pthread_t producer, consumer;
+    clock_gettime (CLOCK_MONOTONIC, & start);
+    pthread_create (& consumer, NULL, consume, & mismatches);
+    pthread_create (& producer, NULL, produce, NULL);
+    pthread_join (producer, NULL);
+    pthread_join (consumer, NULL);
+    clock_gettime (CLOCK_MONOTONIC, & end);
+
+    double seconds = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf ("transfers: %d, mismatches: %lu, %.1f M/s\n", TRANSFERS, mismatches, TRANSFERS / seconds / 1e6);
+
+    cgc_spsc_queue_clean (& queue);
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <cgc/stack.h>
+
+#define BATCH 40
+
+static int int_copy (const void * source, void * destination)
+{
+    const int * const s = source;
+    int * const d = destination;
+    * d = * s;
+
+    return 0;
+}
+
+/* Pop everything and count the elements not following expected downwards. */
+static size_t drain (cgc_stack * stack, int expected)
+{
+    size_t mismatches = 0;
+    for (int value; cgc_stack_pop_into (stack, & value) == 0; --expected)
+        if (value != expected)
+            mismatches++;
+
+    return mismatches + (expected != -1);
+}
+
+/* Push and pop batches, growing the array along the way. */
+static size_t check_batches (cgc_copy_function copy_fun)
+{
+    cgc_stack * stack = cgc_stack_create (sizeof (int), copy_fun, NULL);
+    int batch[BATCH];
+    int pushed = 0;
+    size_t mismatches = 0;
+
+    for (int round = 0; round < 100; ++round)
+    {
+        const size_t count = (size_t) (round % 7) + 20;
+        for (size_t i = 0; i < count; ++i)
+            batch[i] = pushed++;
+        if (cgc_stack_push_n (stack, batch, count) != 0)
+            mismatches++;
+
+        /* The former top ends up last in the buffer. */
+        const size_t n = cgc_stack_pop_n (stack, batch, count / 2);
+        for (size_t i = 0; i < n; ++i)
+            if (batch[i] != pushed - (int) (n - i))
+                mismatches++;
+        cgc_stack_push_n (stack, batch, n);
+    }
+
+    int * top = cgc_stack_top (stack);
+    if (top == NULL || * top != pushed - 1 || cgc_stack_size (stack) != (size_t) pushed)
+        mismatches++;
+
+    cgc_stack * copy = cgc_stack_copy (stack);
+    mismatches += drain (copy, pushed - 1);
+    mismatches += drain (stack, pushed - 1);
+    cgc_stack_destroy (copy);
+    cgc_stack_destroy (stack);
+
+    return mismatches;
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    cgc_stack * stack = cgc_stack_create (sizeof (int), NULL, NULL);
+    int value;
+    void * popped = cgc_stack_pop (stack);
+    printf ("empty stack: pop %s, pop_into %d, pop_n %lu\n", popped == NULL ? "NULL" : "not NULL",
+        cgc_stack_pop_into (stack, & value), cgc_stack_pop_n (stack, & value, 1));
+    printf ("NULL stack: pop %s\n", cgc_stack_pop (NULL) == NULL ? "NULL" : "not NULL");
+
+    errno = 0;
+    cgc_stack_push (stack, & value);
+    int error = cgc_stack_push_n (stack, & value, SIZE_MAX);
+    printf ("overflowing push_n: %d, errno %s, size %lu\n", error,
+        errno == ENOMEM ? "ENOMEM" : "not ENOMEM", cgc_stack_size (stack));
+    cgc_stack_clear (stack);
+
+    for (value = 0; value < 5; ++value)
+        cgc_stack_push (stack, & value);
+    int * top = cgc_stack_pop (stack);
+    printf ("popped: %d, size %lu\n", * top, cgc_stack_size (stack));
+    free (top);
+    cgc_stack_destroy (stack);
+
+    printf ("batches mismatches: %lu\n", check_batches (NULL));
+    printf ("batches with copy function mismatches: %lu\n", check_batches (int_copy));
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cgc/string_pool.h>
+#include <cgc/string_vector.h>
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+    cgc_string_pool * pool = cgc_string_pool_create ();
+
+    uint32_t a, b, c;
+    cgc_string_pool_intern (pool, "apple", & a);
+    cgc_string_pool_intern (pool, "banana", & b);
+    cgc_string_pool_intern (pool, "apple", & c);
+    printf ("apple: %u, banana: %u, apple again: %u\n", a, b, c);
+    printf ("same pointer: %s\n", cgc_string_pool_string (pool, a) == cgc_string_pool_string (pool, c) ? "yes" : "no");
+    printf ("find cherry: %s\n", cgc_string_pool_find (pool, "cherry", 6, NULL) ? "yes" : "no");
+
+    /* Strings are binary safe. */
+    cgc_string_pool_intern_n (pool, "a\0b", 3, & c);
+    printf ("\"a\\0b\": %u, length %lu\n", c, cgc_string_pool_length (pool, c));
+
+    char buffer[32];
+    size_t mismatches = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        snprintf (buffer, sizeof buffer, "token-%d", i % 25000);
+        uint32_t id;
+        size_t size = cgc_string_pool_size (pool);
+        cgc_string_pool_intern (pool, buffer, & id);
+        mismatches += strcmp (buffer, cgc_string_pool_string (pool, id)) != 0;
+        mismatches += (i < 25000) != (cgc_string_pool_size (pool) == size + 1);
+    }
+    printf ("%lu strings, %lu mismatches\n", cgc_string_pool_size (pool), mismatches);
+
+    /* Long strings, of which the stripes hashed at once only differ by their order. */
+    char long_buffer[512];
+    size_t size = cgc_string_pool_size (pool);
+    mismatches = 0;
+    for (int round = 0; round < 2; ++round)
+    {
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            const size_t length = 100 + i % 400;
+            for (size_t j = 0; j < length; ++j)
+                long_buffer[j] = (char) ('a' + (j / 64 + i) % 26);
+            uint32_t id;
+            cgc_string_pool_intern_n (pool, long_buffer, length, & id);
+            mismatches += cgc_string_pool_length (pool, id) != length;
+            mismatches += memcmp (long_buffer, cgc_string_pool_string (pool, id), length) != 0;
+        }
+    }
+    printf ("%lu long strings, %lu mismatches\n", cgc_string_pool_size (pool) - size, mismatches);
+
+    cgc_string_vector * vector = cgc_string_vector_create_interned (0, pool);
+    const char * words[] = { "to", "be", "or", "not", "to", "be" };
+    for (size_t i = 0; i < sizeof words / sizeof * words; ++i)
+        cgc_string_vector_push_back (vector, words[i]);
+    for (size_t i = 0; i < cgc_string_vector_size (vector); ++i)
+        printf ("%s (%u)\n", cgc_string_vector_at (vector, i), cgc_string_vector_id_at (vector, i));
+    char * last = cgc_string_vector_pop_back (vector);
+    printf ("pop_back: %s\n", last);
+    free (last);
+    cgc_string_vector_destroy (vector);
+
+    cgc_string_pool_clear (pool);
+    cgc_string_pool_intern (pool, "banana", & b);
+    printf ("after clear: %lu string, banana: %u\n", cgc_string_pool_size (pool), b);
+    cgc_string_pool_destroy (pool);
+
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <cgc/string_vector.h>
 
@@ -31,5 +32,73 @@ int main (int argc, char ** argv)
     free (last);
     cgc_string_vector_destroy (vector);
 
+    vector = cgc_string_vector_create (0);
+    char buffer[32];
+    size_t mismatches = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        snprintf (buffer, sizeof buffer, i % 3 ? "token-%d" : "a-longer-token-name-%d", i);
+        cgc_string_vector_push_back (vector, buffer);
+    }
+    for (int i = 0; i < 100000; ++i)
+    {
+        snprintf (buffer, sizeof buffer, i % 3 ? "token-%d" : "a-longer-token-name-%d", i);
+        mismatches += strcmp (buffer, cgc_string_vector_at (vector, (size_t) i)) != 0;
+    }
+    printf ("\n%lu strings, %lu mismatches\n", cgc_string_vector_size (vector), mismatches);
+    cgc_string_vector_destroy (vector);
+
+    vector = cgc_string_vector_create (0);
+    const char * words[] = { "pear", "apple", "peach", "a-very-long-fruit-name-2", "apple",
+        "pea", "", "a-very-long-fruit-name-1", "pear", "a-very-long-fruit-name-1" };
+    for (size_t i = 0; i < sizeof words / sizeof * words; ++i)
+        cgc_string_vector_push_back (vector, words[i]);
+    cgc_string_vector_sort (vector);
+    cgc_string_vector_unique (vector);
+    printf ("\nsort and unique:\n----------------\n");
+    print_vector (vector);
+    cgc_string_vector_destroy (vector);
+
+    /* Binary strings: "ab" < "ab\0" < "ab\0\0" < "abc". */
+    vector = cgc_string_vector_create (0);
+    const char binary[] = "abc\0\0-and-a-long-tail-to-leave-the-inline-storage";
+    cgc_string_vector_push_back_n (vector, binary, 3);
+    cgc_string_vector_push_back_n (vector, binary, sizeof binary - 1);
+    cgc_string_vector_push_back_n (vector, "ab\0", 4);
+    cgc_string_vector_push_back_n (vector, "ab\0", 3);
+    cgc_string_vector_push_back_n (vector, "ab", 2);
+    cgc_string_vector_sort (vector);
+    printf ("\nbinary strings, sorted:\n-----------------------\n");
+    for (size_t i = 0; i < cgc_string_vector_size (vector); ++i)
+    {
+        size_t length = cgc_string_vector_length_at (vector, i);
+        const char * string = cgc_string_vector_at (vector, i);
+        printf ("%lu:", length);
+        for (size_t j = 0; j < length; ++j)
+            if (string[j] != '\0')
+                putchar (string[j]);
+            else
+                fputs ("\\0", stdout);
+        printf ("\n");
+    }
+    cgc_string_vector_destroy (vector);
+
+    FILE * file = fopen ("test_string_vector.txt", "w");
+    fputs ("alpha\nbeta\n\ngamma", file);
+    fclose (file);
+    vector = cgc_string_vector_load_file ("test_string_vector.txt", '\n', 0);
+    printf ("\nload_file:\n----------\n");
+    for (size_t i = 0; i < cgc_string_vector_size (vector); ++i)
+        printf ("\"%.*s\"\n", (int) cgc_string_vector_length_at (vector, i), cgc_string_vector_at (vector, i));
+    cgc_string_vector_destroy (vector);
+
+    vector = cgc_string_vector_load_file ("test_string_vector.txt", '\n',
+        CGC_STRING_VECTOR_LOAD_TERMINATE | CGC_STRING_VECTOR_LOAD_SKIP_EMPTY);
+    printf ("\nload_file, terminated, skipping empty strings:\n"
+        "---------------------------------------------\n");
+    print_vector (vector);
+    cgc_string_vector_destroy (vector);
+    remove ("test_string_vector.txt");
+
     return 0;
 }
@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <cgc/timer_wheel.h>
+
+#define TIMERS 100000
+
+static cgc_timer_wheel * wheel;
+static cgc_timer_wheel_timer * handles[TIMERS];
+static uint64_t deadlines[TIMERS];
+static bool pending[TIMERS];
+static size_t late, early, unexpected;
+static uint64_t last_expiry;
+static size_t disorders;
+
+static uint64_t random_delay (void)
+{
+    switch (rand () % 4)
+    {
+        case 0: return (uint64_t) rand () % 256;
+        case 1: return (uint64_t) rand () % 100000;
+        case 2: return (uint64_t) rand () * 64;
+        default: return ((uint64_t) rand () << 20) | (uint64_t) rand ();
+    }
+}
+
+static int expire (void * element)
+{
+    size_t id = * (size_t *) element;
+    uint64_t now = cgc_timer_wheel_now (wheel);
+    if (! pending[id])
+        unexpected++;
+    else if (now < deadlines[id])
+        early++;
+    else if (now > deadlines[id])
+        late++;
+    if (now < last_expiry)
+        disorders++;
+    last_expiry = now;
+    pending[id] = false;
+    return 0;
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    wheel = cgc_timer_wheel_create (sizeof (size_t), NULL, NULL, 1000);
+    srand (42);
+
+    size_t cancelled = 0, rescheduled = 0, expired = 0;
+    for (size_t id = 0; id < TIMERS; ++id)
+    {
+        uint64_t now = cgc_timer_wheel_now (wheel);
+        deadlines[id] = now + 1 + random_delay ();
+        pending[id] = true;
+        cgc_timer_wheel_schedule (wheel, deadlines[id], & id, & handles[id]);
+
+        size_t other = (size_t) rand () % (id + 1);
+        if (pending[other] && rand () % 8 == 0)
+        {
+            cgc_timer_wheel_cancel (wheel, handles[other]);
+            pending[other] = false;
+            cancelled++;
+        }
+        else if (pending[other] && rand () % 8 == 0)
+        {
+            deadlines[other] = now + 1 + random_delay ();
+            cgc_timer_wheel_reschedule (wheel, handles[other], deadlines[other]);
+            rescheduled++;
+        }
+
+        if (rand () % 4 == 0)
+            expired += cgc_timer_wheel_advance (wheel, now + (uint64_t) rand () % 5000, expire);
+    }
+    expired += cgc_timer_wheel_advance (wheel, UINT64_C (1) << 50, expire);
+
+    size_t left = 0;
+    for (size_t id = 0; id < TIMERS; ++id)
+        left += pending[id];
+
+    printf ("expired: %lu, cancelled: %lu, rescheduled: %lu, left: %lu\n",
+        expired, cancelled, rescheduled, left);
+    printf ("early: %lu, late: %lu, unexpected: %lu, out of order: %lu\n",
+        early, late, unexpected, disorders);
+
+    cgc_timer_wheel_destroy (wheel);
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <cgc/unrolled_list.h>
+
+static int int_print (void * i)
+{
+    int * integer = i;
+    printf ("%d ", * integer);
+
+    return 0;
+}
+
+static int int_sum_left (void * result, const void * a)
+{
+    const int * left = a;
+    int * r = result;
+    * r = * r + * left;
+    return 0;
+}
+
+static inline void print_int_list (const char * list_name, cgc_unrolled_list * list)
+{
+    printf ("%s: [ ", list_name);
+    cgc_unrolled_list_map (list, int_print);
+    printf ("], size %lu\n", cgc_unrolled_list_size (list));
+}
+
+int main (int argc, char ** argv)
+{
+    (void) argc; (void) argv;
+
+    cgc_unrolled_list * list = cgc_unrolled_list_create (sizeof (int), NULL, NULL);
+    for (int i = 0; i < 200; ++i)
+        cgc_unrolled_list_push_back (list, & i);
+    for (int i = -1; i > -5; --i)
+        cgc_unrolled_list_push_front (list, & i);
+
+    /* Force node splits in the middle of the list. */
+    for (int i = 1000; i < 1070; ++i)
+        cgc_unrolled_list_insert (list, 100, & i);
+
+    cgc_unrolled_list_erase (list, 10, 190);
+    print_int_list ("list", list);
+
+    int * at = cgc_unrolled_list_at (list, 20);
+    printf ("at 20: %d\n", * at);
+
+    int * front = cgc_unrolled_list_pop_front (list);
+    int * back = cgc_unrolled_list_pop_back (list);
+    printf ("popped: %d %d\n", * front, * back);
+    free (front);
+    free (back);
+
+    cgc_unrolled_list * copy = cgc_unrolled_list_copy (list);
+    int sum = 0;
+    cgc_unrolled_list_fold_left (copy, int_sum_left, & sum);
+    print_int_list ("copy", copy);
+    printf ("fold_left (+) 0 copy = %d\n", sum);
+
+    cgc_unrolled_list_destroy (copy);
+    cgc_unrolled_list_destroy (list);
+
+    return 0;
+}